@@ -0,0 +1,177 @@
+#include "Mixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_MIXER_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Audio;
+
+namespace
+{
+	const float QuarterPi = 0.785398163f;
+}
+
+//----------------------------------------------------------------------
+
+Mixer::Mixer(const MixerSettings& settings) :
+	m_settings(settings)
+{
+	m_voices.reserve(settings.maxVoices);
+}
+
+//----------------------------------------------------------------------
+
+uint32_t Mixer::Load(const char* path)
+{
+	SoundBuffer sound;
+	if (!sound.Load(path, m_settings.sampleRate))
+	{
+		return InvalidSound;
+	}
+	m_sounds.push_back(sound);
+	return static_cast<uint32_t>(m_sounds.size() - 1);
+}
+
+//----------------------------------------------------------------------
+
+uint32_t Mixer::Load(const uint8_t* data, size_t size)
+{
+	SoundBuffer sound;
+	if (!sound.Deserialize(data, size, m_settings.sampleRate))
+	{
+		return InvalidSound;
+	}
+	m_sounds.push_back(sound);
+	return static_cast<uint32_t>(m_sounds.size() - 1);
+}
+
+//----------------------------------------------------------------------
+
+bool Mixer::Play(uint32_t sound, float volume, float pan)
+{
+	if (sound >= m_sounds.size() || !(volume > 0.0f) || m_settings.maxVoices == 0)
+	{
+		return false;
+	}
+
+	Voice voice;
+	voice.sound = sound;
+	voice.frame = 0;
+	voice.volume = std::min(volume, 1.0f);
+	float angle = (std::max(-1.0f, std::min(1.0f, pan)) + 1.0f) * QuarterPi;
+	voice.leftGain = voice.volume * std::cos(angle);
+	voice.rightGain = voice.volume * std::sin(angle);
+
+	if (m_voices.size() < m_settings.maxVoices)
+	{
+		m_voices.push_back(voice);
+		return true;
+	}
+
+	// Every voice is busy; the new sound takes the quietest one if it is louder.
+	size_t quietest = 0;
+	for (size_t i = 1; i < m_voices.size(); i++)
+	{
+		if (m_voices[i].volume < m_voices[quietest].volume)
+		{
+			quietest = i;
+		}
+	}
+	if (m_voices[quietest].volume >= voice.volume)
+	{
+		return false;
+	}
+	m_voices[quietest] = voice;
+	return true;
+}
+
+//----------------------------------------------------------------------
+
+float Mixer::ContactVolume(float velocity) const
+{
+	if (velocity < m_settings.minVelocity)
+	{
+		return 0.0f;
+	}
+	float volume = velocity / m_settings.maxVelocity;
+	return std::max(m_settings.minAdjustment, std::min(volume, 1.0f));
+}
+
+//----------------------------------------------------------------------
+
+bool Mixer::PlayContact(uint32_t sound, float velocity, float pan)
+{
+	return Play(sound, ContactVolume(velocity), pan);
+}
+
+//----------------------------------------------------------------------
+
+void Mixer::Render(float* output, uint32_t frameCount)
+{
+	memset(output, 0, frameCount * 2 * sizeof(float));
+
+	for (size_t i = 0; i < m_voices.size();)
+	{
+		Voice& voice = m_voices[i];
+		const SoundBuffer& sound = m_sounds[voice.sound];
+		uint32_t frames = std::min(frameCount, sound.FrameCount() - voice.frame);
+		MixStereo(sound.Samples() + voice.frame * 2, output, frames, voice.leftGain, voice.rightGain);
+		voice.frame += frames;
+
+		if (voice.frame >= sound.FrameCount())
+		{
+			// Finished; the last voice takes its place.
+			m_voices[i] = m_voices.back();
+			m_voices.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void Audio::MixStereoScalar(const float* source, float* output, uint32_t frameCount, float leftGain, float rightGain)
+{
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		output[i * 2] += source[i * 2] * leftGain;
+		output[i * 2 + 1] += source[i * 2 + 1] * rightGain;
+	}
+}
+
+//----------------------------------------------------------------------
+
+#if defined(SUMO_MIXER_SSE2)
+
+void Audio::MixStereo(const float* source, float* output, uint32_t frameCount, float leftGain, float rightGain)
+{
+	// Two frames at a time: left, right, left, right.
+	const __m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+	uint32_t i = 0;
+	for (; i + 2 <= frameCount; i += 2)
+	{
+		__m128 samples = _mm_loadu_ps(source + i * 2);
+		__m128 mixed = _mm_loadu_ps(output + i * 2);
+		_mm_storeu_ps(output + i * 2, _mm_add_ps(mixed, _mm_mul_ps(samples, gains)));
+	}
+	MixStereoScalar(source + i * 2, output + i * 2, frameCount - i, leftGain, rightGain);
+}
+
+#else
+
+void Audio::MixStereo(const float* source, float* output, uint32_t frameCount, float leftGain, float rightGain)
+{
+	MixStereoScalar(source, output, frameCount, leftGain, rightGain);
+}
+
+#endif
+
+//----------------------------------------------------------------------
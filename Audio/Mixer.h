@@ -0,0 +1,102 @@
+#pragma once
+
+// Mixer:
+// Plays any number of SoundBuffers at once into stereo float buffers supplied by
+// the caller, so the same mixing runs under a platform audio API or headless,
+// writing to a file or to nothing at all.
+//
+// Each playing sound is a voice with its own volume and pan.  The pan uses a
+// constant power law, so a sound keeps its loudness as it moves across.  A voice
+// is mixed with SSE2 where available, two stereo frames at a time, into the
+// output block; a voice that reaches the end of its sound is freed.  When every
+// voice is busy, a new sound takes the voice of the quietest sound playing, if it
+// is louder than that.
+//
+// ContactVolume() turns the speed of a contact into a volume by the
+// GameConstants::Sound rules: silent below MinVelocity, full at MaxVelocity, and
+// no quieter than MinAdjustment in between.
+//
+// A Mixer isn't thread-safe; the thread that renders it should also start its
+// sounds, for example from the contacts it takes off a ContactEventQueue.
+
+#include "../GameObjects/GameConstants.h"
+#include "SoundBuffer.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Audio
+{
+	struct MixerSettings
+	{
+		uint32_t sampleRate;
+		uint32_t maxVoices;
+		float    minVelocity;       // Contacts slower than this make no sound.
+		float    maxVelocity;       // Contacts at least this fast play at full volume.
+		float    minAdjustment;     // The volume of the softest contact that makes a sound.
+	};
+
+	inline MixerSettings DefaultMixerSettings()
+	{
+		MixerSettings settings = {
+			GameConstants::Sound::SampleRate,
+			GameConstants::Sound::MaxVoices,
+			GameConstants::Sound::MinVelocity,
+			GameConstants::Sound::MaxVelocity,
+			GameConstants::Sound::MinAdjustment,
+		};
+		return settings;
+	}
+
+	class Mixer
+	{
+	public:
+		explicit Mixer(const MixerSettings& settings = DefaultMixerSettings());
+
+		// Load a WAVE file for playing, converted to the mixer's rate.  Returns the
+		// sound's id, or InvalidSound if the file couldn't be read.
+		static const uint32_t InvalidSound = 0xFFFFFFFF;
+		uint32_t Load(const char* path);
+		uint32_t Load(const uint8_t* data, size_t size);
+
+		// Start a sound at a volume from 0 to 1 and a pan from -1 (left) to 1 (right).
+		// False if no voice could be had for it.
+		bool Play(uint32_t sound, float volume, float pan);
+
+		// Play a sound for a contact whose sumos closed at 'velocity'.  False if the
+		// contact was too soft to hear.
+		bool PlayContact(uint32_t sound, float velocity, float pan);
+		float ContactVolume(float velocity) const;
+
+		// Mix the next 'frameCount' stereo frames into 'output', replacing what it held.
+		void Render(float* output, uint32_t frameCount);
+
+		void StopAll()                              { m_voices.clear(); }
+
+		const MixerSettings& Settings() const       { return m_settings; }
+		uint32_t ActiveVoices() const               { return static_cast<uint32_t>(m_voices.size()); }
+		const SoundBuffer& Sound(uint32_t sound) const { return m_sounds[sound]; }
+		uint32_t SoundCount() const                 { return static_cast<uint32_t>(m_sounds.size()); }
+
+	private:
+		struct Voice
+		{
+			uint32_t sound;
+			uint32_t frame;     // The next frame of the sound to play.
+			float    volume;
+			float    leftGain;
+			float    rightGain;
+		};
+
+		MixerSettings            m_settings;
+		std::vector<SoundBuffer> m_sounds;
+		std::vector<Voice>       m_voices;
+	};
+
+	// Add 'frameCount' stereo frames of 'source' into 'output' with a gain per channel.
+	// Uses SSE2 where available, with a scalar version of the same kernel for the rest.
+	void MixStereo(const float* source, float* output, uint32_t frameCount, float leftGain, float rightGain);
+
+	// Always uses the scalar kernel, for comparison.
+	void MixStereoScalar(const float* source, float* output, uint32_t frameCount, float leftGain, float rightGain);
+}
@@ -0,0 +1,219 @@
+#include "SoundBuffer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace Audio;
+
+//----------------------------------------------------------------------
+
+namespace
+{
+	const uint16_t FormatPcm = 1;
+	const uint16_t FormatFloat = 3;
+	const uint16_t FormatExtensible = 0xFFFE;
+
+	uint32_t ReadUInt(const uint8_t* data, int size)
+	{
+		uint32_t value = 0;
+		for (int i = 0; i < size; i++)
+		{
+			value |= static_cast<uint32_t>(data[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	void WriteUInt(std::vector<uint8_t>& data, uint32_t value, int size)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	float ReadSample(const uint8_t* data, uint16_t format, uint32_t bits)
+	{
+		if (format == FormatFloat)
+		{
+			float value;
+			memcpy(&value, data, sizeof(value));
+			return value;
+		}
+		if (bits == 8)
+		{
+			// 8 bit samples are unsigned.
+			return (static_cast<int>(data[0]) - 128) * (1.0f / 128.0f);
+		}
+		int16_t value = static_cast<int16_t>(ReadUInt(data, 2));
+		return value * (1.0f / 32768.0f);
+	}
+}
+
+//----------------------------------------------------------------------
+
+SoundBuffer::SoundBuffer() :
+	m_sampleRate(0),
+	m_sourceRate(0),
+	m_sourceChannels(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+bool SoundBuffer::Deserialize(const uint8_t* data, size_t size, uint32_t sampleRate)
+{
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0 || sampleRate == 0)
+	{
+		return false;
+	}
+
+	// Find the format and the samples; any other chunks are skipped.
+	const uint8_t* format = nullptr;
+	uint32_t formatSize = 0;
+	const uint8_t* samples = nullptr;
+	uint32_t samplesSize = 0;
+	size_t offset = 12;
+	while (size - offset >= 8)
+	{
+		uint32_t chunkSize = ReadUInt(data + offset + 4, 4);
+		const uint8_t* chunk = data + offset + 8;
+		size_t available = size - offset - 8;
+		if (memcmp(data + offset, "fmt ", 4) == 0 && chunkSize <= available)
+		{
+			format = chunk;
+			formatSize = chunkSize;
+		}
+		else if (memcmp(data + offset, "data", 4) == 0)
+		{
+			// Some writers leave the data size too long; take what is there.
+			samples = chunk;
+			samplesSize = static_cast<uint32_t>(std::min<size_t>(chunkSize, available));
+		}
+		if (chunkSize >= available)
+		{
+			break;
+		}
+		// Chunks are padded to an even size.
+		offset += 8 + chunkSize + (chunkSize & 1);
+	}
+	if (format == nullptr || formatSize < 16 || samples == nullptr)
+	{
+		return false;
+	}
+
+	uint16_t formatTag = static_cast<uint16_t>(ReadUInt(format, 2));
+	uint32_t channels = ReadUInt(format + 2, 2);
+	uint32_t sourceRate = ReadUInt(format + 4, 4);
+	uint32_t blockAlign = ReadUInt(format + 12, 2);
+	uint32_t bits = ReadUInt(format + 14, 2);
+	if (formatTag == FormatExtensible && formatSize >= 26)
+	{
+		// The format is the start of the sub-format GUID.
+		formatTag = static_cast<uint16_t>(ReadUInt(format + 24, 2));
+	}
+	bool supported = (formatTag == FormatPcm && (bits == 8 || bits == 16)) || (formatTag == FormatFloat && bits == 32);
+	if (!supported || channels < 1 || channels > 2 || sourceRate == 0 || blockAlign != channels * bits / 8)
+	{
+		return false;
+	}
+
+	// Convert to stereo float at the file's rate.
+	uint32_t sourceFrames = samplesSize / blockAlign;
+	uint32_t bytesPerSample = bits / 8;
+	std::vector<float> source(sourceFrames * 2);
+	for (uint32_t frame = 0; frame < sourceFrames; frame++)
+	{
+		const uint8_t* block = samples + frame * blockAlign;
+		float left = ReadSample(block, formatTag, bits);
+		float right = (channels == 2) ? ReadSample(block + bytesPerSample, formatTag, bits) : left;
+		source[frame * 2] = left;
+		source[frame * 2 + 1] = right;
+	}
+
+	m_sampleRate = sampleRate;
+	m_sourceRate = sourceRate;
+	m_sourceChannels = channels;
+	if (sourceRate == sampleRate || sourceFrames == 0)
+	{
+		m_samples.swap(source);
+		return true;
+	}
+
+	// Resample, reading each output frame between the two source frames around it.
+	uint32_t frames = static_cast<uint32_t>(static_cast<uint64_t>(sourceFrames) * sampleRate / sourceRate);
+	double step = static_cast<double>(sourceRate) / sampleRate;
+	m_samples.resize(frames * 2);
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		double position = frame * step;
+		uint32_t before = static_cast<uint32_t>(position);
+		uint32_t after = std::min(before + 1, sourceFrames - 1);
+		float fraction = static_cast<float>(position - before);
+		for (uint32_t channel = 0; channel < 2; channel++)
+		{
+			float a = source[before * 2 + channel];
+			float b = source[after * 2 + channel];
+			m_samples[frame * 2 + channel] = a + (b - a) * fraction;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------
+
+bool SoundBuffer::Load(const char* path, uint32_t sampleRate)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+	uint8_t buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		data.insert(data.end(), buffer, buffer + read);
+	}
+	fclose(file);
+
+	return Deserialize(data.data(), data.size(), sampleRate);
+}
+
+//----------------------------------------------------------------------
+
+bool Audio::SaveWave(const char* path, const float* samples, uint32_t frameCount, uint32_t sampleRate)
+{
+	uint32_t dataSize = frameCount * 4;
+	std::vector<uint8_t> data;
+	data.reserve(44 + dataSize);
+	data.insert(data.end(), { 'R', 'I', 'F', 'F' });
+	WriteUInt(data, 36 + dataSize, 4);
+	data.insert(data.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+	WriteUInt(data, 16, 4);
+	WriteUInt(data, FormatPcm, 2);
+	WriteUInt(data, 2, 2);
+	WriteUInt(data, sampleRate, 4);
+	WriteUInt(data, sampleRate * 4, 4);
+	WriteUInt(data, 4, 2);
+	WriteUInt(data, 16, 2);
+	data.insert(data.end(), { 'd', 'a', 't', 'a' });
+	WriteUInt(data, dataSize, 4);
+	for (uint32_t i = 0; i < frameCount * 2; i++)
+	{
+		float sample = std::max(-1.0f, std::min(1.0f, samples[i]));
+		WriteUInt(data, static_cast<uint16_t>(static_cast<int16_t>(sample * 32767.0f)), 2);
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+	return (fclose(file) == 0) && written;
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,48 @@
+#pragma once
+
+// SoundBuffer:
+// A sound effect held in memory, ready to mix: interleaved stereo float samples
+// at the Mixer's output rate.  A WAVE file is parsed and converted once, when it
+// is loaded, so playing it costs no decoding or rate conversion.
+//
+// Files can be PCM with 8 or 16 bit samples or IEEE float, mono or stereo, at any
+// rate.  Mono is copied to both channels, and a file at another rate is
+// resampled with linear interpolation.
+//
+// Written in standard C++ so the game's sounds can be mixed and measured headless.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Audio
+{
+	class SoundBuffer
+	{
+	public:
+		SoundBuffer();
+
+		// Parse a RIFF WAVE file and convert it for mixing at 'sampleRate'.  False if the
+		// file is malformed or in a format that isn't supported.
+		bool Deserialize(const uint8_t* data, size_t size, uint32_t sampleRate);
+		bool Load(const char* path, uint32_t sampleRate);
+
+		uint32_t SampleRate() const                 { return m_sampleRate; }
+		uint32_t FrameCount() const                 { return static_cast<uint32_t>(m_samples.size() / 2); }
+		// Two samples, left then right, per frame.
+		const float* Samples() const                { return m_samples.data(); }
+
+		// What the file held before it was converted.
+		uint32_t SourceRate() const                 { return m_sourceRate; }
+		uint32_t SourceChannels() const             { return m_sourceChannels; }
+
+	private:
+		std::vector<float> m_samples;
+		uint32_t           m_sampleRate;
+		uint32_t           m_sourceRate;
+		uint32_t           m_sourceChannels;
+	};
+
+	// Write interleaved stereo float samples to a 16 bit PCM WAVE file.
+	bool SaveWave(const char* path, const float* samples, uint32_t frameCount, uint32_t sampleRate);
+}
@@ -3,25 +3,15 @@
 #include "SumoBlock.h"
 #include "GameConstants.h"
 
+// AISumoBlock:
+// The computer controlled opponent.  Its behavior and maneuver choices are part of
+// the game play state in Simulation::SumoSimulation (see Simulation::DetermineAIAction);
+// this class only presents the enemy on screen.
+
 ref class AISumoBlock : public SumoBlock
 {
 internal:
-	AISumoBlock();
-	AISumoBlock(DirectX::XMFLOAT3 position,	SumoBlock^ target,	GameConstants::Behavior aiBehavior);
-
-	void Behavior(GameConstants::Behavior newBehavior);
-	void DetermineAIAction(float deltaTime);
-
-private:
-	
-	GameConstants::Behavior m_behavior;
-	GameConstants::ManeuverState m_choice;
-	float m_delay;
-	
+	AISumoBlock(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity);
+	AISumoBlock(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity, SumoBlock^ target);
 };
 
-__forceinline void AISumoBlock::Behavior(GameConstants::Behavior newBehavior)
-{
-	m_behavior = newBehavior;
-}
-
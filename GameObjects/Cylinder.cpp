@@ -12,31 +12,32 @@ using namespace DirectX;
 
 //----------------------------------------------------------------------
 
-Cylinder::Cylinder()
+Cylinder::Cylinder(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity) :
+	GameObject(store, entity)
 {
-	Initialize(XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f, XMFLOAT3(0.0f, 0.0f, 1.0f));
+	Initialize(1.0f, XMFLOAT3(0.0f, 0.0f, 1.0f));
 }
 
 //----------------------------------------------------------------------
 
 Cylinder::Cylinder(
-	XMFLOAT3 position,
+	_In_ Simulation::EntityStore* store,
+	Simulation::EntityHandle entity,
 	float radius,
 	XMFLOAT3 direction
-	)
+	) :
+	GameObject(store, entity)
 {
-	Initialize(position, radius, direction);
+	Initialize(radius, direction);
 }
 
 //----------------------------------------------------------------------
 
 void Cylinder::Initialize(
-	XMFLOAT3 position,
 	float radius,
 	XMFLOAT3 direction
 	)
 {
-	m_position = position;
 	m_radius = radius;
 	m_length = XMVectorGetX(XMVector3Length(XMLoadFloat3(&direction)));
 	XMStoreFloat3(&m_axis, XMVector3Normalize(XMLoadFloat3(&direction)));
@@ -54,26 +55,8 @@ void Cylinder::Initialize(
 
 		mat1 = XMMatrixRotationAxis(axis1, angle1);
 	}
-	XMStoreFloat4x4(&m_rotationMatrix, mat1);
-
-	XMStoreFloat4x4(
-		&m_modelMatrix,
-		XMMatrixScaling(m_radius, m_radius, m_length) *
-		mat1 *
-		XMMatrixTranslation(m_position.x, m_position.y, m_position.z)
-		);
-}
 
-//--------------------------------------------------------------------------------
-
-void Cylinder::UpdatePosition()
-{
-	XMStoreFloat4x4(
-		&m_modelMatrix,
-		XMMatrixScaling(m_radius, m_radius, m_length) *
-		XMLoadFloat4x4(&m_rotationMatrix) *
-		XMMatrixTranslation(m_position.x, m_position.y, m_position.z)
-		);
+	Basis(XMMatrixScaling(m_radius, m_radius, m_length) * mat1);
 }
 
 //--------------------------------------------------------------------------------
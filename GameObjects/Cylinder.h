@@ -11,26 +11,24 @@
 // This class is a specialization of GameObject that represents a cylinder primitive.
 // The cylinder is defined by a vector starting at 'position' and oriented along the
 // 'direction' vector.  The length of the cylinder is just the length of the 'direction'
-// vector.
+// vector.  Like every GameObject it is a view onto an entity in an EntityStore;
+// the entity's position is the start of the cylinder.
 
 #include "GameObject.h"
 
 ref class Cylinder : public GameObject
 {
 internal:
-	Cylinder();
+	Cylinder(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity);
 	Cylinder(
-		DirectX::XMFLOAT3 position,
+		_In_ Simulation::EntityStore* store,
+		Simulation::EntityHandle entity,
 		float radius,
 		DirectX::XMFLOAT3 direction
 		);
 
-protected:
-	virtual void UpdatePosition() override;
-
 private:
 	void Initialize(
-		DirectX::XMFLOAT3 position,
 		float radius,
 		DirectX::XMFLOAT3 direction
 		);
@@ -38,5 +36,4 @@ private:
 	DirectX::XMFLOAT3   m_axis;
 	float               m_length;
 	float               m_radius;
-	DirectX::XMFLOAT4X4 m_rotationMatrix;
 };
\ No newline at end of file
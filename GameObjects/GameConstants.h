@@ -44,6 +44,9 @@ namespace GameConstants
         static const float RestThreshold        = 0.02f;    // The energy below which the ball is flagged as laying on ground.
                                                             // It is defined as Gravity * Height_above_ground + 0.5 * Velocity * Velocity.
         static const float FrameLength          = 0.003f;   // The duration of a frame for physics handling when the graphics frame length is too long.
+        static const int MaxStepsPerFrame       = 34;       // The most physics frames run for one graphics frame (about 0.1 s).  Longer frames drop the excess time.
+        static const bool SweptSteps            = false;    // Advance the match in one swept step per graphics frame instead of FrameLength ticks.
+                                                            // The AI then steps by the frame and contacts use ResolveSweptContact, which plays differently.
     }
 
     namespace Sound
@@ -51,6 +54,45 @@ namespace GameConstants
         static const float MaxVelocity          = 10.0f;    // The velocity at which the bouncing sound is played at maximum volume.
         static const float MinVelocity          = 0.05f;    // The minimum contact velocity required to make a sound.
         static const float MinAdjustment        = 0.2f;     // The minimum volume adjustment based on contact velocity.
+        static const int   EventQueueSize       = 4096;     // Contact events waiting for the sound thread.
+        static const int   SampleRate           = 48000;    // Frames per second the sounds are mixed at.
+        static const int   MaxVoices            = 32;       // The most sounds played at once.
+    }
+
+    namespace Network
+    {
+        static const int TicksPerFrame          = 5;        // Simulation ticks in one frame of a netplay match (15 ms).
+        static const int MaxPredictionFrames    = 8;        // Most frames a peer runs ahead of the remote inputs it has received.
+        static const int FramesBetweenWaits     = 10;       // Fewest frames between two frames skipped to let a peer that is behind catch up.
+    }
+
+    namespace Raster
+    {
+        static const int TileSize               = 64;       // Width and height in pixels of the screen tiles the software renderer bins triangles into.
+    }
+
+    namespace Arena
+    {
+        static const float RingRadius           = 10.0f;    // Distance from the center of the mat at which a sumo is out of the ring.
+        static const float SumoSize             = 1.0f;     // Width of a sumo block; two blocks touch when their centers are this far apart.
+        static const float PlayerStartX         = -3.0f;    // Starting position of the player along the x axis.
+        static const float EnemyStartX          = 3.0f;     // Starting position of the enemy along the x axis.
+        static const float StartHeight          = 0.5f;     // Height of a sumo block's center above the mat.
+        static const float InitialAIDelay       = 2.0f;     // Seconds before the AI makes its first maneuver choice.
+        static const float MinimumAIDelay       = 1.0f;     // Shortest time the AI sticks with a maneuver.
+        static const float AIDelayStep          = 1.0f;     // Step between the possible maneuver durations.
+        static const int AIDelayChoices         = 3;        // Number of possible maneuver durations.
+        static const int SmartPlanBudget        = 1000;     // Microseconds the Smart AI may spend planning each maneuver.
+        static const float SmartPlanHorizon     = 8.0f;     // Seconds of play the Smart AI looks ahead when planning.
+        static const float SmartPlanStep        = 0.03f;    // Length of a step in the Smart AI's planning rollouts.
+        static const int AIDecisionBudget       = 256;      // Most AI maneuver choices made in one tick of a crowded arena; the rest wait.
+        static const float AINearDistance       = 20.0f;    // AIs this close to the camera check their maneuver every tick.
+        static const float AIFarDistance        = 60.0f;    // AIs beyond this distance from the camera check it least often.
+        static const float AIIdleDistance       = 10.0f;    // AIs farther than this from their opponent are only walking up and check less often.
+        static const int AIMidInterval          = 4;        // Ticks between maneuver checks for AIs between the near and far distances.
+        static const int AIFarInterval          = 16;       // Ticks between maneuver checks for far or idle AIs.
+        static const float SumoMass             = 1.0f;     // Mass of a sumo block in an arena with dynamics.
+        static const int SumoRestTicks          = 10;       // Ticks a sumo in an arena with dynamics has to stay still before it sleeps.
     }
 
 	enum Behavior{ Easy = 0, Angry, Smart};
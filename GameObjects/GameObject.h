@@ -1,28 +1,28 @@
 #pragma once
 
-#include "../Meshes/MeshObject.h"
-#include "../Rendering/Material.h"
+// GameObject:
+// This class is a view onto one entity in a Simulation::EntityStore.  The entity's
+// position, velocity, model matrix and render handle live in the store's
+// contiguous arrays; the GameObject only remembers the store and the entity's
+// handle.  Derived classes describe their shape with the entity's basis and
+// facing target.  Setting a position only marks the entity's transform dirty;
+// Simulation::UpdateTransforms rebuilds the model matrices once per frame.
+
+#include "../Simulation/EntityStore.h"
 
 ref class GameObject
 {
 internal:
-	GameObject();
-
-	void Render(
-		_In_ ID3D11DeviceContext *context,
-		_In_ ID3D11Buffer *primitiveConstantBuffer
-		);
-
+	GameObject(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity);
 
 	void OnGround(bool ground);
 	bool OnGround();
 
+	// The mesh and material ids the renderer draws this object with.
+	void RenderResources(Simulation::RenderHandle handle);
+	Simulation::RenderHandle RenderResources();
 
-	void Mesh(_In_ MeshObject^ mesh);
-
-	void NormalMaterial(_In_ Material^ material);
-	Material^ NormalMaterial();
-
+	Simulation::EntityHandle Entity();
 
 	void Position(DirectX::XMFLOAT3 position);
 	void Position(DirectX::XMVECTOR position);
@@ -34,27 +34,24 @@ internal:
 	DirectX::XMVECTOR VectorVelocity();
 	DirectX::XMFLOAT3 Velocity();
 
-protected private:
-	virtual void UpdatePosition() {};
-	// Object Data
-	bool                m_ground;
-
-	DirectX::XMFLOAT3   m_position;
-	DirectX::XMFLOAT3   m_velocity;
-	DirectX::XMFLOAT4X4 m_modelMatrix;
+	// Draw the object at 'position' (for example a position interpolated between
+	// simulation ticks) without moving the entity.
+	void RenderPosition(DirectX::XMFLOAT3 position);
 
-	Material^           m_normalMaterial;
-
-	DirectX::XMFLOAT3   m_defaultXAxis;
-	DirectX::XMFLOAT3   m_defaultYAxis;
-	DirectX::XMFLOAT3   m_defaultZAxis;
+protected private:
+	// The scale and rotation of the object's shape, applied before any facing.
+	void Basis(DirectX::FXMMATRIX basis);
 
+	uint32 Index();
 
-	MeshObject^         m_mesh;
+	// Object Data
+	bool                        m_ground;
 
+	Simulation::EntityStore*    m_store;
+	Simulation::EntityHandle    m_entity;
 };
 
-
+static_assert(sizeof(Simulation::Float4x4) == sizeof(DirectX::XMFLOAT4X4), "Float4x4 must match the XMFLOAT4X4 layout");
 
 __forceinline void GameObject::OnGround(bool ground)
 {
@@ -66,72 +63,89 @@ __forceinline bool GameObject::OnGround()
 	return m_ground;
 }
 
+__forceinline uint32 GameObject::Index()
+{
+	return m_store->Index(m_entity);
+}
+
+__forceinline void GameObject::Basis(DirectX::FXMMATRIX basis)
+{
+	Simulation::Float4x4 value;
+	DirectX::XMStoreFloat4x4(reinterpret_cast<DirectX::XMFLOAT4X4*>(&value), basis);
+	m_store->Basis(Index(), value);
+}
+
+__forceinline Simulation::EntityHandle GameObject::Entity()
+{
+	return m_entity;
+}
 
 __forceinline void GameObject::Position(DirectX::XMFLOAT3 position)
 {
-	m_position = position;
-	// Update any internal states that are dependent on the position.
-	// UpdatePosition is a virtual function that is specific to the derived class.
-	UpdatePosition();
+	Simulation::Float3 value = Simulation::MakeFloat3(position.x, position.y, position.z);
+	m_store->Position(Index(), value);
+	m_store->RenderPosition(Index(), value);
 }
 
 __forceinline void GameObject::Position(DirectX::XMVECTOR position)
 {
-	XMStoreFloat3(&m_position, position);
-	// Update any internal states that are dependent on the position.
-	// UpdatePosition is a virtual function that is specific to the derived class.
-	UpdatePosition();
+	DirectX::XMFLOAT3 value;
+	XMStoreFloat3(&value, position);
+	Position(value);
+}
+
+__forceinline void GameObject::RenderPosition(DirectX::XMFLOAT3 position)
+{
+	m_store->RenderPosition(Index(), Simulation::MakeFloat3(position.x, position.y, position.z));
 }
 
 __forceinline DirectX::XMFLOAT3 GameObject::Position()
 {
-	return m_position;
+	Simulation::Float3 position = m_store->Position(Index());
+	return DirectX::XMFLOAT3(position.x, position.y, position.z);
 }
 
 __forceinline DirectX::XMVECTOR GameObject::VectorPosition()
 {
-	return DirectX::XMLoadFloat3(&m_position);
+	DirectX::XMFLOAT3 position = Position();
+	return DirectX::XMLoadFloat3(&position);
 }
 
 __forceinline void GameObject::Velocity(DirectX::XMFLOAT3 velocity)
 {
-	m_velocity = velocity;
+	m_store->Velocity(Index(), Simulation::MakeFloat3(velocity.x, velocity.y, velocity.z));
 }
 
 __forceinline void GameObject::Velocity(DirectX::XMVECTOR velocity)
 {
-	XMStoreFloat3(&m_velocity, velocity);
+	DirectX::XMFLOAT3 value;
+	XMStoreFloat3(&value, velocity);
+	Velocity(value);
 }
 
 __forceinline DirectX::XMFLOAT3 GameObject::Velocity()
 {
-	return m_velocity;
+	Simulation::Float3 velocity = m_store->Velocity(Index());
+	return DirectX::XMFLOAT3(velocity.x, velocity.y, velocity.z);
 }
 
 __forceinline DirectX::XMVECTOR GameObject::VectorVelocity()
 {
-	return DirectX::XMLoadFloat3(&m_velocity);
+	DirectX::XMFLOAT3 velocity = Velocity();
+	return DirectX::XMLoadFloat3(&velocity);
 }
 
-
-__forceinline void GameObject::NormalMaterial(_In_ Material^ material)
+__forceinline void GameObject::RenderResources(Simulation::RenderHandle handle)
 {
-	m_normalMaterial = material;
+	m_store->RenderHandles()[Index()] = handle;
 }
 
-__forceinline Material^ GameObject::NormalMaterial()
+__forceinline Simulation::RenderHandle GameObject::RenderResources()
 {
-	return m_normalMaterial;
+	return m_store->RenderHandles()[Index()];
 }
 
-
-__forceinline void GameObject::Mesh(_In_ MeshObject^ mesh)
-{
-	m_mesh = mesh;
-}
-
-
 __forceinline DirectX::XMMATRIX GameObject::ModelMatrix()
 {
-	return DirectX::XMLoadFloat4x4(&m_modelMatrix);
+	return DirectX::XMLoadFloat4x4(reinterpret_cast<const DirectX::XMFLOAT4X4*>(&m_store->Transforms()[Index()]));
 }
@@ -3,61 +3,35 @@
 
 using namespace DirectX;
 
-SumoBlock::SumoBlock()
+SumoBlock::SumoBlock(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity) :
+	GameObject(store, entity)
 {
-	Initialize(XMFLOAT3(0, 0, 0), nullptr);
+	Initialize(nullptr);
 
 }
 
-SumoBlock::SumoBlock(DirectX::XMFLOAT3 position, SumoBlock^ target)
+SumoBlock::SumoBlock(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity, SumoBlock^ target) :
+	GameObject(store, entity)
 {
-	Initialize(position, target);
+	Initialize(target);
 }
 
-void SumoBlock::Initialize(DirectX::XMFLOAT3 position, SumoBlock^ target)
+void SumoBlock::Initialize(SumoBlock^ target)
 {
-	m_target = target;
-	if (target != nullptr)
-	{
-		m_angle = XMVectorGetY(XMVector3AngleBetweenNormals(XMVector3Normalize(m_target->VectorPosition() - VectorPosition()), XMVector3Normalize(XMVectorSet(1.0f, 0.0f, 0.0f, 1.0f))));
-	}
-	Position(position);
-	XMMATRIX mat1 = XMMatrixIdentity();
-	XMStoreFloat4x4(&m_rotationMatrix, mat1);
+	Basis(XMMatrixScaling(1.0f, 1.0f, 1.0f));
+	Target(target);
 }
 
 
 void SumoBlock::Target(SumoBlock^ target)
 {
 	m_target = target;
+
+	//Face the target.
+	m_store->FacingTarget(Index(), (target != nullptr) ? target->Entity() : Simulation::InvalidEntity);
 }
 
 SumoBlock^ SumoBlock::Target()
 {
 	return m_target;
 }
-
-void SumoBlock::UpdatePosition()
-{
-	if (m_target != nullptr)
-	{
-		//Face the target.
-		XMVECTOR direction = XMVector3Normalize(m_target->VectorPosition() - VectorPosition());
-		float ans = XMVectorGetY(XMVector2AngleBetweenNormals(direction, XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f)));
-		m_angle = ans;
-
-		//if you are in the upper arc
-		if (XMVectorGetZ(direction) > 0)
-		{
-			m_angle *= -1;
-		}
-
-		XMStoreFloat4x4(&m_modelMatrix, XMMatrixScaling(1.0f, 1.0f, 1.0f) * XMMatrixRotationY(m_angle) * XMMatrixTranslation(m_position.x, m_position.y, m_position.z));
-	}
-	else
-	{
-		XMStoreFloat4x4(&m_modelMatrix, XMMatrixScaling(1.0f, 1.0f, 1.0f) *	XMLoadFloat4x4(&m_rotationMatrix) *	XMMatrixTranslation(m_position.x, m_position.y, m_position.z) );
-	}
-
-
-}
\ No newline at end of file
@@ -1,24 +1,22 @@
 #pragma once
 
 #include "GameObject.h"
+
+// SumoBlock:
+// A sumo wrestler.  It is drawn as a unit block turned to face its target, if it
+// has one; the facing is kept up to date by Simulation::UpdateTransforms.
+
 ref class SumoBlock : public GameObject
 {
 internal:
-	SumoBlock();
-	SumoBlock( DirectX::XMFLOAT3 position, SumoBlock^ target );
-	void Initialize(DirectX::XMFLOAT3 position, SumoBlock^ target);
+	SumoBlock(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity);
+	SumoBlock(_In_ Simulation::EntityStore* store, Simulation::EntityHandle entity, SumoBlock^ target);
+	void Initialize(SumoBlock^ target);
 	void Target(SumoBlock^ target);
 	SumoBlock^ Target();
-protected:
-	void UpdatePosition() override;
-	
-	 
 
 private:
-	DirectX::XMFLOAT4X4 m_rotationMatrix;
 	SumoBlock^ m_target;
-	float m_angle;
 
 };
 
-
@@ -7,13 +7,14 @@ using namespace DirectX;
 
 MeshObject::MeshObject() :
 m_vertexCount(0),
-m_indexCount(0)
+m_indexCount(0),
+m_boundingRadius(0.0f)
 {
 }
 
 //--------------------------------------------------------------------------------
 
-void MeshObject::Render(_In_ ID3D11DeviceContext *context)
+void MeshObject::Bind(_In_ ID3D11DeviceContext *context)
 {
 	uint32 stride = sizeof(PNTVertex);
 	uint32 offset = 0;
@@ -21,7 +22,6 @@ void MeshObject::Render(_In_ ID3D11DeviceContext *context)
 	context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
 	context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
 	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	context->DrawIndexed(m_indexCount, 0, 0);
 }
 
 //--------------------------------------------------------------------------------
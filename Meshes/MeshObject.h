@@ -5,21 +5,26 @@
 // list.  Each of the derived classes is just the constructor for the specific
 // geometry primitive.  This abstract class does not place any requirements on
 // the format of the geometry directly.
-// The primary method of the MeshObject is Render.  The default implementation
-// just sets the IndexBuffer, VertexBuffer and topology to a TriangleList and
-// makes a  DrawIndexed call on the context.  It assumes all other states have
-// been set on the context already.
+// The primary method of the MeshObject is Bind.  The default implementation
+// just sets the IndexBuffer, VertexBuffer and topology to a TriangleList.  The
+// draw itself is recorded in a CommandList with IndexCount() indices and made
+// by the D3D11Backend, which sets all other states.  BoundingRadius() bounds
+// the geometry for frustum culling.
 
 ref class MeshObject abstract
 {
 internal:
 	MeshObject();
 
-	virtual void Render(_In_ ID3D11DeviceContext *context);
+	virtual void Bind(_In_ ID3D11DeviceContext *context);
+
+	int IndexCount() { return m_indexCount; }
+	float BoundingRadius() { return m_boundingRadius; }
 
 protected private:
 	Microsoft::WRL::ComPtr<ID3D11Buffer>  m_vertexBuffer;
 	Microsoft::WRL::ComPtr<ID3D11Buffer>  m_indexBuffer;
 	int                                   m_vertexCount;
 	int                                   m_indexCount;
+	float                                 m_boundingRadius;     // Around the mesh's origin, for culling.
 };
@@ -0,0 +1,107 @@
+#include "CommandList.h"
+
+#include <cstring>
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+void CommandList::Clear()
+{
+	m_commands.clear();
+	m_uploadData.clear();
+}
+
+//----------------------------------------------------------------------
+
+RenderCommand& CommandList::Add(CommandType type)
+{
+	RenderCommand command = { type, 0, NoResource, NoResource, 0, 0, 0 };
+	m_commands.push_back(command);
+	return m_commands.back();
+}
+
+//----------------------------------------------------------------------
+
+uint32_t CommandList::Reserve(uint32_t size)
+{
+	uint32_t offset = static_cast<uint32_t>(m_uploadData.size());
+	m_uploadData.resize(offset + ((size + 15) & ~15u));
+	return offset;
+}
+
+//----------------------------------------------------------------------
+
+void CommandList::SetShaders(ResourceId vertexShader, ResourceId pixelShader)
+{
+	RenderCommand& command = Add(CommandType::SetShaders);
+	command.resource0 = vertexShader;
+	command.resource1 = pixelShader;
+}
+
+//----------------------------------------------------------------------
+
+void CommandList::SetTexture(ResourceId texture)
+{
+	Add(CommandType::SetTexture).resource0 = texture;
+}
+
+//----------------------------------------------------------------------
+
+void CommandList::SetMesh(ResourceId mesh)
+{
+	Add(CommandType::SetMesh).resource0 = mesh;
+}
+
+//----------------------------------------------------------------------
+
+void CommandList::UploadConstants(ConstantSlot slot, const void* data, uint32_t size)
+{
+	uint32_t offset = Reserve(size);
+	memcpy(m_uploadData.data() + offset, data, size);
+
+	RenderCommand& command = Add(CommandType::UploadConstants);
+	command.resource0 = static_cast<ResourceId>(slot);
+	command.value0 = offset;
+	command.value1 = size;
+}
+
+//----------------------------------------------------------------------
+
+void CommandList::DrawIndexed(uint32_t indexCount, uint32_t firstIndex)
+{
+	RenderCommand& command = Add(CommandType::DrawIndexed);
+	command.value0 = indexCount;
+	command.value1 = firstIndex;
+}
+
+//----------------------------------------------------------------------
+
+InstanceData* CommandList::UploadInstances(uint32_t count)
+{
+	uint32_t size = count * static_cast<uint32_t>(sizeof(InstanceData));
+	uint32_t offset = Reserve(size);
+
+	RenderCommand& command = Add(CommandType::UploadInstances);
+	command.value0 = offset;
+	command.value1 = size;
+	return reinterpret_cast<InstanceData*>(m_uploadData.data() + offset);
+}
+
+//----------------------------------------------------------------------
+
+void CommandList::SetInstances(uint32_t firstInstance)
+{
+	Add(CommandType::SetInstances).value0 = firstInstance;
+}
+
+//----------------------------------------------------------------------
+
+void CommandList::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount)
+{
+	RenderCommand& command = Add(CommandType::DrawIndexedInstanced);
+	command.value0 = indexCount;
+	command.value1 = instanceCount;
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,109 @@
+#pragma once
+
+// CommandList:
+// A frame's drawing recorded as plain data instead of calls on a device
+// context, so the same frame can be submitted to Direct3D, thrown away, or
+// counted and inspected on a machine with no GPU.  A RenderBackend consumes the
+// list.
+//
+// Each command is a fixed 16 byte record: a pipeline state to bind, a constant
+// buffer to fill, or a draw.  Resources are named by small ids that the backend
+// maps to its own objects, so nothing in the list depends on the graphics API.
+// Constant data is copied into one block owned by the list and commands refer to
+// it by offset, which keeps the commands themselves small and cheap to move.
+//
+// Instanced draws read a per instance stream of InstanceData from the same
+// block.  A frame uploads one stream, filled in place through the pointer
+// UploadInstances() returns, and each batch selects its range of it with
+// SetInstances() before drawing.
+//
+// Clear() keeps the memory of the previous frame, so recording a frame of the
+// same size again doesn't allocate.
+
+#include "ShaderConstants.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	// Names a shader, texture or mesh.  The backend that executes the list decides
+	// what each id refers to.
+	typedef uint16_t ResourceId;
+
+	static const ResourceId NoResource = 0xffff;
+
+	// The constant buffer registers the shaders read, b0 to b3.
+	enum class ConstantSlot : uint16_t
+	{
+		NeverChanges,
+		ChangeOnResize,
+		ChangesEveryFrame,
+		ChangesEveryPrim,
+		Count
+	};
+
+	enum class CommandType : uint8_t
+	{
+		SetShaders,           // resource0: vertex shader, resource1: pixel shader.
+		SetTexture,           // resource0: the texture for register t0.
+		SetMesh,              // resource0: the mesh whose vertex and index buffers to bind.
+		UploadConstants,      // resource0: the ConstantSlot, value0: offset of the data, value1: its size.
+		DrawIndexed,          // value0: index count, value1: first index.
+		UploadInstances,      // value0: offset of the InstanceData, value1: its size.
+		SetInstances,         // value0: the first instance the following draws read.
+		DrawIndexedInstanced, // value0: index count, value1: instance count.
+	};
+
+	struct RenderCommand
+	{
+		CommandType type;
+		uint8_t     reserved;
+		ResourceId  resource0;
+		ResourceId  resource1;
+		uint16_t    reserved1;
+		uint32_t    value0;
+		uint32_t    value1;
+	};
+
+	static_assert(sizeof(RenderCommand) == 16, "RenderCommand should stay 16 bytes");
+
+	class CommandList
+	{
+	public:
+		// Forget the recorded commands and data, keeping their memory.
+		void Clear();
+
+		void SetShaders(ResourceId vertexShader, ResourceId pixelShader);
+		void SetTexture(ResourceId texture);
+		void SetMesh(ResourceId mesh);
+		void UploadConstants(ConstantSlot slot, const void* data, uint32_t size);
+		void DrawIndexed(uint32_t indexCount, uint32_t firstIndex);
+
+		// Make room for 'count' instances and record their upload.  The caller fills
+		// them in through the pointer, which stays valid until the next upload.
+		InstanceData* UploadInstances(uint32_t count);
+		void SetInstances(uint32_t firstInstance);
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount);
+
+		template <typename T>
+		void UploadConstants(ConstantSlot slot, const T& data)
+		{
+			UploadConstants(slot, &data, static_cast<uint32_t>(sizeof(T)));
+		}
+
+		uint32_t Count() const                      { return static_cast<uint32_t>(m_commands.size()); }
+		const RenderCommand* Commands() const       { return m_commands.data(); }
+
+		// The data of an UploadConstants or UploadInstances command.
+		const uint8_t* UploadData(const RenderCommand& command) const { return m_uploadData.data() + command.value0; }
+		uint32_t UploadBytes() const                { return static_cast<uint32_t>(m_uploadData.size()); }
+
+	private:
+		RenderCommand& Add(CommandType type);
+		uint32_t Reserve(uint32_t size);
+
+		std::vector<RenderCommand> m_commands;
+		std::vector<uint8_t>       m_uploadData;       // Each upload starts at a multiple of 16 bytes.
+	};
+}
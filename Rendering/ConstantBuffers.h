@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include "ShaderConstants.h"
+
+#include <cstddef>
+
 struct PNTVertex
 {
     DirectX::XMFLOAT3 position;
@@ -22,6 +26,20 @@ static D3D11_INPUT_ELEMENT_DESC PNTVertexLayout[] =
 	{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 };
 
+// PNTVertex in slot 0, and a Rendering::InstanceData per instance in slot 1: the
+// rows of the world matrix, then the tint.
+static D3D11_INPUT_ELEMENT_DESC PNTInstancedLayout[] =
+{
+    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "INSTANCEWORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INSTANCEWORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INSTANCEWORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INSTANCEWORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INSTANCETINT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+};
+
 struct ConstantBufferNeverChanges
 {
     DirectX::XMFLOAT4 lightPosition[4];
@@ -47,3 +65,11 @@ struct ConstantBufferChangesEveryPrim
     float specularPower;
 };
 
+// The software renderer reads the same bytes through the twins in ShaderConstants.h.
+static_assert(sizeof(PNTVertex) == sizeof(Rendering::PNTVertex), "PNTVertex must match Rendering::PNTVertex");
+static_assert(sizeof(ConstantBufferNeverChanges) == sizeof(Rendering::ConstantBufferNeverChanges), "ConstantBufferNeverChanges must match its twin");
+static_assert(sizeof(ConstantBufferChangeOnResize) == sizeof(Rendering::ConstantBufferChangeOnResize), "ConstantBufferChangeOnResize must match its twin");
+static_assert(sizeof(ConstantBufferChangesEveryFrame) == sizeof(Rendering::ConstantBufferChangesEveryFrame), "ConstantBufferChangesEveryFrame must match its twin");
+static_assert(sizeof(ConstantBufferChangesEveryPrim) == sizeof(Rendering::ConstantBufferChangesEveryPrim), "ConstantBufferChangesEveryPrim must match its twin");
+static_assert(offsetof(ConstantBufferChangesEveryPrim, specularPower) == offsetof(Rendering::ConstantBufferChangesEveryPrim, specularPower), "ConstantBufferChangesEveryPrim must match its twin");
+static_assert(sizeof(Rendering::InstanceData) == 5 * sizeof(DirectX::XMFLOAT4), "InstanceData must match PNTInstancedLayout");
@@ -0,0 +1,307 @@
+#include "pch.h"
+#include "D3D11Backend.h"
+
+using namespace Microsoft::WRL;
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+void D3D11Backend::Reset(
+    _In_ ID3D11DeviceContext* context,
+    _In_ ID3D11SamplerState* sampler,
+    _In_reads_(4) ID3D11Buffer* const* constantBuffers
+    )
+{
+    m_context = context;
+    m_sampler = sampler;
+    for (int slot = 0; slot < static_cast<int>(ConstantSlot::Count); slot++)
+    {
+        m_constantBuffers[slot] = constantBuffers[slot];
+    }
+
+    m_instanceBuffer = nullptr;
+    m_instanceCapacity = 0;
+
+    // The ring needs constant buffer offsetting, and NO_OVERWRITE maps of dynamic
+    // constant buffers, from the driver.
+    m_context1 = nullptr;
+    m_constantRing = nullptr;
+    m_frameQueries.clear();
+    m_constantArena = UploadArena();
+    m_frame = 0;
+    m_constantRingWritten = false;
+
+    ComPtr<ID3D11Device> device;
+    context->GetDevice(&device);
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+    ZeroMemory(&options, sizeof(options));
+    if (SUCCEEDED(m_context.As(&m_context1)) &&
+        SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+        options.ConstantBufferOffsetting &&
+        options.MapNoOverwriteOnDynamicConstantBuffer)
+    {
+        const UploadArenaSettings& settings = m_constantArena.Settings();
+
+        D3D11_BUFFER_DESC bufferDesc = {0};
+        bufferDesc.ByteWidth = settings.capacity;
+        bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+        bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        DX::ThrowIfFailed(
+            device->CreateBuffer(&bufferDesc, nullptr, &m_constantRing)
+            );
+
+        D3D11_QUERY_DESC queryDesc = { D3D11_QUERY_EVENT, 0 };
+        m_frameQueries.resize(settings.framesInFlight);
+        for (uint32 i = 0; i < settings.framesInFlight; i++)
+        {
+            DX::ThrowIfFailed(
+                device->CreateQuery(&queryDesc, &m_frameQueries[i])
+                );
+        }
+    }
+    else
+    {
+        m_context1 = nullptr;
+    }
+
+    m_vertexShaders.clear();
+    m_inputLayouts.clear();
+    m_pixelShaders.clear();
+    m_textures.clear();
+    m_meshes.clear();
+}
+
+//----------------------------------------------------------------------
+
+ResourceId D3D11Backend::AddVertexShader(_In_ ID3D11VertexShader* shader, _In_ ID3D11InputLayout* inputLayout)
+{
+    m_vertexShaders.push_back(shader);
+    m_inputLayouts.push_back(inputLayout);
+    return static_cast<ResourceId>(m_vertexShaders.size() - 1);
+}
+
+//----------------------------------------------------------------------
+
+ResourceId D3D11Backend::AddPixelShader(_In_ ID3D11PixelShader* shader)
+{
+    m_pixelShaders.push_back(shader);
+    return static_cast<ResourceId>(m_pixelShaders.size() - 1);
+}
+
+//----------------------------------------------------------------------
+
+ResourceId D3D11Backend::AddTexture(_In_ ID3D11ShaderResourceView* texture)
+{
+    m_textures.push_back(texture);
+    return static_cast<ResourceId>(m_textures.size() - 1);
+}
+
+//----------------------------------------------------------------------
+
+ResourceId D3D11Backend::AddMesh(_In_ MeshObject^ mesh)
+{
+    m_meshes.push_back(mesh);
+    return static_cast<ResourceId>(m_meshes.size() - 1);
+}
+
+//----------------------------------------------------------------------
+
+void D3D11Backend::UploadInstances(_In_reads_bytes_(size) const void* data, uint32 size)
+{
+    if (size > m_instanceCapacity)
+    {
+        // Grow geometrically so a crowd that keeps growing doesn't reallocate every frame.
+        ComPtr<ID3D11Device> device;
+        m_context->GetDevice(&device);
+
+        D3D11_BUFFER_DESC bufferDesc = {0};
+        bufferDesc.ByteWidth = max(size, 2 * m_instanceCapacity);
+        bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+        bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        m_instanceBuffer = nullptr;
+        DX::ThrowIfFailed(
+            device->CreateBuffer(&bufferDesc, nullptr, &m_instanceBuffer)
+            );
+        m_instanceCapacity = bufferDesc.ByteWidth;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    DX::ThrowIfFailed(
+        m_context->Map(m_instanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)
+        );
+    memcpy(mapped.pData, data, size);
+    m_context->Unmap(m_instanceBuffer.Get(), 0);
+}
+
+//----------------------------------------------------------------------
+
+bool D3D11Backend::FrameFinished(uint64 frame, bool wait)
+{
+    ID3D11Query* query = m_frameQueries[frame % m_frameQueries.size()].Get();
+    HRESULT hr;
+    do
+    {
+        hr = m_context->GetData(query, nullptr, 0, wait ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH);
+        DX::ThrowIfFailed(hr);
+    }
+    while (hr == S_FALSE && wait);
+    return hr == S_OK;
+}
+
+//----------------------------------------------------------------------
+
+void D3D11Backend::WriteConstants(const CommandList& commands)
+{
+    // Free the memory of the frames the GPU has finished, waiting for the oldest
+    // while the CPU is as many frames ahead as the arena allows.
+    while (m_constantArena.FramesInFlight() > 0 &&
+        FrameFinished(m_constantArena.OldestFrame(), m_constantArena.MustWait()))
+    {
+        m_constantArena.Retire(m_constantArena.OldestFrame());
+    }
+
+    m_frame++;
+    m_constantArena.BeginFrame(m_frame);
+    m_constantOffsets.clear();
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    DX::ThrowIfFailed(
+        m_context->Map(m_constantRing.Get(), 0, m_constantRingWritten ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD, 0, &mapped)
+        );
+    m_constantRingWritten = true;
+
+    const RenderCommand* command = commands.Commands();
+    for (uint32 i = 0; i < commands.Count(); i++)
+    {
+        if (command[i].type != CommandType::UploadConstants)
+        {
+            continue;
+        }
+
+        uint32 offset = m_constantArena.Allocate(command[i].value1);
+        while (offset == UploadArena::NoSpace && m_constantArena.FramesInFlight() > 0)
+        {
+            FrameFinished(m_constantArena.OldestFrame(), true);
+            m_constantArena.Retire(m_constantArena.OldestFrame());
+            offset = m_constantArena.Allocate(command[i].value1);
+        }
+        if (offset != UploadArena::NoSpace)
+        {
+            memcpy(static_cast<uint8*>(mapped.pData) + offset, commands.UploadData(command[i]), command[i].value1);
+        }
+        m_constantOffsets.push_back(offset);
+    }
+
+    m_context->Unmap(m_constantRing.Get(), 0);
+}
+
+//----------------------------------------------------------------------
+
+void D3D11Backend::Execute(const CommandList& commands)
+{
+    ID3D11DeviceContext* context = m_context.Get();
+
+    // The game uses the same constant buffers and sampler for all shaders, so they
+    // are set once per list.
+    for (int slot = 0; slot < static_cast<int>(ConstantSlot::Count); slot++)
+    {
+        context->VSSetConstantBuffers(slot, 1, m_constantBuffers[slot].GetAddressOf());
+    }
+    context->PSSetConstantBuffers(2, 1, m_constantBuffers[static_cast<int>(ConstantSlot::ChangesEveryFrame)].GetAddressOf());
+    context->PSSetConstantBuffers(3, 1, m_constantBuffers[static_cast<int>(ConstantSlot::ChangesEveryPrim)].GetAddressOf());
+    context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
+
+    if (m_context1 != nullptr)
+    {
+        WriteConstants(commands);
+    }
+
+    uint32 upload = 0;
+    const RenderCommand* command = commands.Commands();
+    for (uint32 i = 0; i < commands.Count(); i++)
+    {
+        switch (command[i].type)
+        {
+        case CommandType::SetShaders:
+            context->IASetInputLayout(m_inputLayouts[command[i].resource0].Get());
+            context->VSSetShader(m_vertexShaders[command[i].resource0].Get(), nullptr, 0);
+            context->PSSetShader(m_pixelShaders[command[i].resource1].Get(), nullptr, 0);
+            break;
+
+        case CommandType::SetTexture:
+            context->PSSetShaderResources(0, 1, m_textures[command[i].resource0].GetAddressOf());
+            break;
+
+        case CommandType::SetMesh:
+            m_meshes[command[i].resource0]->Bind(context);
+            break;
+
+        case CommandType::UploadConstants:
+        {
+            uint32 slot = command[i].resource0;
+            uint32 offset = (m_context1 != nullptr) ? m_constantOffsets[upload++] : UploadArena::NoSpace;
+            if (offset != UploadArena::NoSpace)
+            {
+                // Ranges are given in 16 byte constants, in multiples of 16 constants.
+                UINT firstConstant = offset / 16;
+                UINT constantCount = (command[i].value1 + 255) / 256 * 16;
+                m_context1->VSSetConstantBuffers1(slot, 1, m_constantRing.GetAddressOf(), &firstConstant, &constantCount);
+                if (slot >= static_cast<uint32>(ConstantSlot::ChangesEveryFrame))
+                {
+                    m_context1->PSSetConstantBuffers1(slot, 1, m_constantRing.GetAddressOf(), &firstConstant, &constantCount);
+                }
+                break;
+            }
+
+            context->UpdateSubresource(
+                m_constantBuffers[slot].Get(),
+                0,
+                nullptr,
+                commands.UploadData(command[i]),
+                0,
+                0
+                );
+            if (m_context1 != nullptr)
+            {
+                // An earlier upload may have left the slot bound to the ring.
+                context->VSSetConstantBuffers(slot, 1, m_constantBuffers[slot].GetAddressOf());
+                if (slot >= static_cast<uint32>(ConstantSlot::ChangesEveryFrame))
+                {
+                    context->PSSetConstantBuffers(slot, 1, m_constantBuffers[slot].GetAddressOf());
+                }
+            }
+            break;
+        }
+
+        case CommandType::DrawIndexed:
+            context->DrawIndexed(command[i].value0, command[i].value1, 0);
+            break;
+
+        case CommandType::UploadInstances:
+            UploadInstances(commands.UploadData(command[i]), command[i].value1);
+            break;
+
+        case CommandType::SetInstances:
+        {
+            uint32 stride = sizeof(InstanceData);
+            uint32 offset = command[i].value0 * stride;
+            context->IASetVertexBuffers(1, 1, m_instanceBuffer.GetAddressOf(), &stride, &offset);
+            break;
+        }
+
+        case CommandType::DrawIndexedInstanced:
+            context->DrawIndexedInstanced(command[i].value0, command[i].value1, 0, 0, 0);
+            break;
+        }
+    }
+
+    if (m_context1 != nullptr)
+    {
+        context->End(m_frameQueries[m_frame % m_frameQueries.size()].Get());
+        m_constantArena.EndFrame();
+    }
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,76 @@
+#pragma once
+
+// D3D11Backend:
+// Submits CommandLists to a Direct3D 11 device context.  The renderer registers
+// its shaders, textures and meshes once they are loaded, and records draws with
+// the ids the Add methods return.
+//
+// Every Execute() first binds the state all of the game's shaders share: the
+// four constant buffers for both stages and the linear sampler.  The commands
+// then set the rest, one context call each; each vertex shader is registered
+// with its input layout, which is bound with it.
+//
+// Instance streams go into one dynamic vertex buffer, rewritten with
+// WRITE_DISCARD by each upload and grown when a frame's stream doesn't fit, and
+// SetInstances binds it to slot 1 at the batch's first instance.
+//
+// Where the device can bind constant buffer ranges (Direct3D 11.1), every
+// constant upload of a list is written into one ring of dynamic constant buffer
+// memory, through a single NO_OVERWRITE mapping before the list's draws, and
+// bound by offset instead of updated with UpdateSubresource.  An UploadArena
+// hands out the ring a frame at a time, 256 bytes per upload, and an event query
+// ended after each frame tells it when the GPU is done with the frame's memory.
+// Uploads that don't fit fall back to UpdateSubresource.
+
+#include "RenderBackend.h"
+#include "UploadArena.h"
+#include "../Meshes/MeshObject.h"
+
+class D3D11Backend : public Rendering::RenderBackend
+{
+public:
+    D3D11Backend() : m_instanceCapacity(0), m_frame(0), m_constantRingWritten(false) {}
+
+    // The context to submit to and the pipeline state shared by every draw.  Drops
+    // any shaders, textures and meshes registered before.
+    void Reset(
+        _In_ ID3D11DeviceContext* context,
+        _In_ ID3D11SamplerState* sampler,
+        _In_reads_(4) ID3D11Buffer* const* constantBuffers
+        );
+
+    Rendering::ResourceId AddVertexShader(_In_ ID3D11VertexShader* shader, _In_ ID3D11InputLayout* inputLayout);
+    Rendering::ResourceId AddPixelShader(_In_ ID3D11PixelShader* shader);
+    Rendering::ResourceId AddTexture(_In_ ID3D11ShaderResourceView* texture);
+    Rendering::ResourceId AddMesh(_In_ MeshObject^ mesh);
+
+    virtual void Execute(const Rendering::CommandList& commands) override;
+
+private:
+    D3D11Backend(const D3D11Backend&);
+    D3D11Backend& operator=(const D3D11Backend&);
+
+    void UploadInstances(_In_reads_bytes_(size) const void* data, uint32 size);
+    void WriteConstants(const Rendering::CommandList& commands);
+    bool FrameFinished(uint64 frame, bool wait);
+
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext>                     m_context;
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext1>                    m_context1;             // Null unless the ring is used.
+    Microsoft::WRL::ComPtr<ID3D11SamplerState>                      m_sampler;
+    Microsoft::WRL::ComPtr<ID3D11Buffer>                            m_constantBuffers[static_cast<int>(Rendering::ConstantSlot::Count)];
+    Microsoft::WRL::ComPtr<ID3D11Buffer>                            m_instanceBuffer;
+    uint32                                                          m_instanceCapacity;     // Bytes.
+
+    Rendering::UploadArena                                          m_constantArena;
+    Microsoft::WRL::ComPtr<ID3D11Buffer>                            m_constantRing;
+    std::vector<Microsoft::WRL::ComPtr<ID3D11Query>>                m_frameQueries;         // Indexed by frame modulo their count.
+    std::vector<uint32>                                             m_constantOffsets;      // Per upload of the list, or NoSpace.
+    uint64                                                          m_frame;
+    bool                                                            m_constantRingWritten;
+
+    std::vector<Microsoft::WRL::ComPtr<ID3D11VertexShader>>         m_vertexShaders;
+    std::vector<Microsoft::WRL::ComPtr<ID3D11InputLayout>>          m_inputLayouts;         // One per vertex shader.
+    std::vector<Microsoft::WRL::ComPtr<ID3D11PixelShader>>          m_pixelShaders;
+    std::vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>>   m_textures;
+    std::vector<MeshObject^>                                        m_meshes;
+};
@@ -0,0 +1,85 @@
+#include "DrawPackets.h"
+
+#include <cstring>
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+uint64_t Rendering::MakeSortKey(RenderPass pass, uint16_t vertexShader, uint16_t pixelShader, uint16_t texture, uint16_t mesh, float depth)
+{
+	uint32_t depthBits = 0;
+	if (depth > 0.0f)
+	{
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+	}
+
+	return
+		(static_cast<uint64_t>(static_cast<uint8_t>(pass) & 0x3) << 62) |
+		(static_cast<uint64_t>(vertexShader & 0x3F) << 56) |
+		(static_cast<uint64_t>(pixelShader & 0x3F) << 50) |
+		(static_cast<uint64_t>(texture & 0xFFF) << 38) |
+		(static_cast<uint64_t>(mesh & 0xFFF) << 26) |
+		static_cast<uint64_t>(depthBits >> 5);
+}
+
+//----------------------------------------------------------------------
+
+void Rendering::SortDrawPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch)
+{
+	size_t count = packets.size();
+	if (count < 2)
+	{
+		return;
+	}
+	scratch.resize(count);
+
+	// Count every byte of every key in one pass.  The histograms live on the stack,
+	// so sorting a frame doesn't allocate.
+	static const int Digits = 8;
+	uint32_t histograms[Digits][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t key = packets[i].key;
+		for (int digit = 0; digit < Digits; digit++)
+		{
+			histograms[digit][(key >> (8 * digit)) & 0xFF]++;
+		}
+	}
+
+	DrawPacket* source = packets.data();
+	DrawPacket* destination = scratch.data();
+	for (int digit = 0; digit < Digits; digit++)
+	{
+		uint32_t* histogram = histograms[digit];
+		int shift = 8 * digit;
+		if (histogram[(source[0].key >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		uint32_t offset = 0;
+		for (int value = 0; value < 256; value++)
+		{
+			uint32_t bucket = histogram[value];
+			histogram[value] = offset;
+			offset += bucket;
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+		}
+
+		DrawPacket* swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	if (source != packets.data())
+	{
+		packets.swap(scratch);
+	}
+}
+
+//----------------------------------------------------------------------
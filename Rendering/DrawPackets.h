@@ -0,0 +1,44 @@
+#pragma once
+
+// DrawPackets:
+// One packet per draw of a frame, ordered by a 64 bit sort key so draws that
+// share state end up next to each other.  From the most significant bits down
+// the key holds:
+//     pass      2 bits    Opaque first; room for passes drawn after it.
+//     shaders  12 bits    The vertex shader id in the high 6 bits, the pixel shader's in the low 6.
+//     texture  12 bits
+//     mesh     12 bits
+//     depth    26 bits    View space depth, so each run of equal state draws front to back.
+// Ids too large for their field are masked; the packets still sort, only draws
+// of those resources may not be grouped together.
+//
+// The depth is the top bits of the depth's float encoding, which orders the same
+// as the depths themselves for any depth not behind the camera.
+//
+// SortDrawPackets() is a least significant digit radix sort, a byte at a time.
+// Bytes that are the same in every key, which are most of them when a scene has
+// a handful of materials, are skipped, so a frame typically sorts in three or
+// four passes over the packets.  It is stable, so draws with equal keys keep
+// their order.
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	enum class RenderPass : uint8_t
+	{
+		Opaque,
+	};
+
+	struct DrawPacket
+	{
+		uint64_t key;
+		uint32_t entity;    // The entity to draw, an index into the scene's arrays.
+	};
+
+	uint64_t MakeSortKey(RenderPass pass, uint16_t vertexShader, uint16_t pixelShader, uint16_t texture, uint16_t mesh, float depth);
+
+	// Sort 'packets' by key.  'scratch' is resized to match and used as the second buffer.
+	void SortDrawPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch);
+}
@@ -0,0 +1,101 @@
+#include "FrameBuffer.h"
+
+#include <cstdio>
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+namespace
+{
+	uint32_t ToUnorm(float value)
+	{
+		// Written so NaN, which fails every comparison, becomes 0 as it does on a GPU.
+		if (!(value > 0.0f))
+		{
+			return 0;
+		}
+		if (value >= 1.0f)
+		{
+			return 255;
+		}
+		return static_cast<uint32_t>(value * 255.0f + 0.5f);
+	}
+}
+
+//----------------------------------------------------------------------
+
+uint32_t Rendering::PackColor(float red, float green, float blue, float alpha)
+{
+	return ToUnorm(red) | (ToUnorm(green) << 8) | (ToUnorm(blue) << 16) | (ToUnorm(alpha) << 24);
+}
+
+//----------------------------------------------------------------------
+
+FrameBuffer::FrameBuffer(uint32_t width, uint32_t height) :
+	m_width(width),
+	m_height(height),
+	m_stride((width + 3) & ~3u),
+	m_colors(static_cast<size_t>(m_stride) * height, 0),
+	m_depths(static_cast<size_t>(m_stride) * height, 1.0f)
+{
+}
+
+//----------------------------------------------------------------------
+
+uint64_t FrameBuffer::Checksum() const
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (uint32_t y = 0; y < m_height; y++)
+	{
+		const uint32_t* row = &m_colors[y * m_stride];
+		for (uint32_t x = 0; x < m_width; x++)
+		{
+			for (int byte = 0; byte < 4; byte++)
+			{
+				hash ^= (row[x] >> (8 * byte)) & 0xFF;
+				hash *= 1099511628211ull;
+			}
+		}
+	}
+	return hash;
+}
+
+//----------------------------------------------------------------------
+
+bool FrameBuffer::SaveTarga(const char* path) const
+{
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Uncompressed true color, 8 bits of alpha, rows from the top.
+	uint8_t header[18] = { 0 };
+	header[2] = 2;
+	header[12] = static_cast<uint8_t>(m_width);
+	header[13] = static_cast<uint8_t>(m_width >> 8);
+	header[14] = static_cast<uint8_t>(m_height);
+	header[15] = static_cast<uint8_t>(m_height >> 8);
+	header[16] = 32;
+	header[17] = 0x28;
+	bool written = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+	std::vector<uint8_t> row(m_width * 4);
+	for (uint32_t y = 0; y < m_height && written; y++)
+	{
+		for (uint32_t x = 0; x < m_width; x++)
+		{
+			uint32_t color = Pixel(x, y);
+			row[x * 4] = static_cast<uint8_t>(color >> 16);
+			row[x * 4 + 1] = static_cast<uint8_t>(color >> 8);
+			row[x * 4 + 2] = static_cast<uint8_t>(color);
+			row[x * 4 + 3] = static_cast<uint8_t>(color >> 24);
+		}
+		written = fwrite(row.data(), 1, row.size(), file) == row.size();
+	}
+	return (fclose(file) == 0) && written;
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,50 @@
+#pragma once
+
+// FrameBuffer:
+// An in-memory render target and depth buffer for the software renderer.  Colors
+// are 8 bit UNORM RGBA, packed red in the low byte, and depths are floats cleared
+// to 1.  Rows are padded to a multiple of four pixels so the rasterizer can read
+// and write four pixels at a time; the padding is never part of the image.
+//
+// Checksum() hashes the image alone, for comparing frames against golden images
+// without keeping the pictures, and SaveTarga() writes it out to look at.
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	class FrameBuffer
+	{
+	public:
+		FrameBuffer(uint32_t width, uint32_t height);
+
+		uint32_t Width() const                      { return m_width; }
+		uint32_t Height() const                     { return m_height; }
+		uint32_t Stride() const                     { return m_stride; }
+
+		uint32_t* Colors()                          { return m_colors.data(); }
+		const uint32_t* Colors() const              { return m_colors.data(); }
+		float* Depths()                             { return m_depths.data(); }
+		const float* Depths() const                 { return m_depths.data(); }
+
+		uint32_t Pixel(uint32_t x, uint32_t y) const { return m_colors[y * m_stride + x]; }
+
+		// FNV-1a over the colors of the image.
+		uint64_t Checksum() const;
+
+		// Write the image to an uncompressed 32 bit TGA file.
+		bool SaveTarga(const char* path) const;
+
+	private:
+		uint32_t              m_width;
+		uint32_t              m_height;
+		uint32_t              m_stride;
+		std::vector<uint32_t> m_colors;
+		std::vector<float>    m_depths;
+	};
+
+	// Convert a color to the packed UNORM form, clamping each channel to [0, 1] and
+	// rounding to the nearest step as a GPU does.
+	uint32_t PackColor(float red, float green, float blue, float alpha);
+}
@@ -0,0 +1,410 @@
+#include "FrustumCulling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_CULL_SSE2
+#include <emmintrin.h>
+// The AVX2 kernel, which uses FMA, is built whatever the compiler targets and
+// picked when the processor has both.
+#if defined(_MSC_VER)
+#define SUMO_CULL_AVX2
+#define SUMO_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SUMO_CULL_AVX2
+#define SUMO_AVX2_TARGET __attribute__((target("avx2,fma")))
+#include <immintrin.h>
+#endif
+#endif
+
+using namespace Rendering;
+
+namespace
+{
+	// Spheres per chunk when culling on several threads: enough that a chunk's
+	// spheres take a few tens of microseconds.
+	const uint32_t ChunkSize = 16384;
+
+	float Length3(float x, float y, float z)
+	{
+		return std::sqrt(x * x + y * y + z * z);
+	}
+
+#if defined(SUMO_CULL_AVX2)
+	bool ProcessorHasAvx2()
+	{
+#if defined(_MSC_VER)
+		// AVX2 needs the processor to have it and the OS to save the AVX registers.
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+		__cpuid(info, 1);
+		const int HasFma = 1 << 12;
+		const int OsSavesRegisters = 1 << 27;
+		const int HasAvx = 1 << 28;
+		const int Needed = HasFma | OsSavesRegisters | HasAvx;
+		if ((info[2] & Needed) != Needed || (_xgetbv(0) & 6) != 6)
+		{
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+	}
+
+	const bool s_useAvx2 = ProcessorHasAvx2();
+#else
+	const bool s_useAvx2 = false;
+#endif
+
+	// The value of a row for a point.  The vector kernels compute it in the same
+	// order, with fused multiply-adds for AVX2, so every kernel culls exactly the
+	// same spheres as the scalar test.
+	template <bool Fused>
+	inline float RowValue(const Float4& row, float x, float y, float z)
+	{
+		return Fused ?
+			std::fma(z, row.z, std::fma(y, row.y, std::fma(x, row.x, row.w))) :
+			((x * row.x + y * row.y) + z * row.z) + row.w;
+	}
+
+	template <bool Fused>
+	uint32_t CullSpheresScalarAs(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		uint32_t written = 0;
+		for (uint32_t i = begin; i < end; i++)
+		{
+			float x = spheres.centerX[i];
+			float y = spheres.centerY[i];
+			float z = spheres.centerZ[i];
+			float radius = (spheres.radius != nullptr) ? spheres.radius[i] : spheres.sharedRadius;
+
+			float clipX = RowValue<Fused>(frustum.clipX, x, y, z);
+			float clipY = RowValue<Fused>(frustum.clipY, x, y, z);
+			float depth = RowValue<Fused>(frustum.depth, x, y, z);
+			float w = Fused ? std::fma(depth, frustum.wScale, frustum.wOffset) : depth * frustum.wScale + frustum.wOffset;
+
+			// How far the sphere reaches outside each pair of planes, scaled as the test is.
+			float outsideX = (std::fabs(clipX) - w) - radius * frustum.xScale;
+			float outsideY = (std::fabs(clipY) - w) - radius * frustum.yScale;
+			float outsideNear = (0.0f - depth) - radius;
+			float outsideFar = (depth - frustum.depthRange) - radius;
+
+			visible[written] = i;
+			written += (outsideX <= 0.0f && outsideY <= 0.0f && outsideNear <= 0.0f && outsideFar <= 0.0f) ? 1 : 0;
+		}
+		return written;
+	}
+}
+
+#if defined(SUMO_CULL_SSE2)
+
+namespace
+{
+	// For each 8 bit mask, the lanes that are set, packed to the front, and how many
+	// there are.
+	struct LaneTable
+	{
+		uint32_t lanes[256][8];
+		uint32_t counts[256];
+
+		LaneTable()
+		{
+			for (uint32_t mask = 0; mask < 256; mask++)
+			{
+				uint32_t count = 0;
+				for (uint32_t lane = 0; lane < 8; lane++)
+				{
+					if ((mask >> lane) & 1)
+					{
+						lanes[mask][count++] = lane;
+					}
+				}
+				counts[mask] = count;
+				for (uint32_t lane = count; lane < 8; lane++)
+				{
+					lanes[mask][lane] = 0;
+				}
+			}
+		}
+	};
+
+	const LaneTable s_laneTable;
+
+	// Append the indices of the set lanes of an 8 bit mask.  The stores write eight
+	// indices whatever the mask and the count only advances past the visible ones,
+	// so there is no branch per sphere; they never reach past the eighth sphere's slot.
+	inline uint32_t AppendVisible(uint32_t mask, uint32_t first, uint32_t* visible, uint32_t written)
+	{
+		__m128i base = _mm_set1_epi32(static_cast<int>(first));
+		const __m128i* lanes = reinterpret_cast<const __m128i*>(s_laneTable.lanes[mask]);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(visible + written), _mm_add_epi32(_mm_loadu_si128(lanes), base));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(visible + written + 4), _mm_add_epi32(_mm_loadu_si128(lanes + 1), base));
+		return written + s_laneTable.counts[mask];
+	}
+}
+
+#endif
+
+//----------------------------------------------------------------------
+
+Frustum Rendering::ExtractFrustum(const Float4x4& view, const Float4x4& projection)
+{
+	// With row vectors clip = p * m, so each clip space coordinate, and each plane,
+	// comes from the columns of m.
+	Float4x4 m = MatrixMultiply(view, projection);
+	Float4 columns[4];
+	for (int column = 0; column < 4; column++)
+	{
+		columns[column] = MakeFloat4(m.m[0][column], m.m[1][column], m.m[2][column], m.m[3][column]);
+	}
+	const Float4& x = columns[0];
+	const Float4& y = columns[1];
+	const Float4& z = columns[2];
+	const Float4& w = columns[3];
+
+	Frustum frustum;
+	frustum.clipX = x;
+	frustum.clipY = y;
+
+	// Direct3D's near plane is z = 0 and its far plane z = w.
+	float nearScale = 1.0f / Length3(z.x, z.y, z.z);
+	frustum.depth = MakeFloat4(z.x * nearScale, z.y * nearScale, z.z * nearScale, z.w * nearScale);
+	const Float4& depth = frustum.depth;
+	frustum.wScale = w.x * depth.x + w.y * depth.y + w.z * depth.z;
+	frustum.wOffset = w.w - frustum.wScale * depth.w;
+
+	// The far plane's distance from the point of the near plane nearest the origin.
+	float farX = w.x - z.x;
+	float farY = w.y - z.y;
+	float farZ = w.z - z.z;
+	float farW = w.w - z.w;
+	frustum.depthRange = (-depth.w * (farX * depth.x + farY * depth.y + farZ * depth.z) + farW) / Length3(farX, farY, farZ);
+
+	frustum.xScale = std::max(Length3(w.x + x.x, w.y + x.y, w.z + x.z), Length3(w.x - x.x, w.y - x.y, w.z - x.z));
+	frustum.yScale = std::max(Length3(w.x + y.x, w.y + y.y, w.z + y.z), Length3(w.x - y.x, w.y - y.y, w.z - y.z));
+	return frustum;
+}
+
+//----------------------------------------------------------------------
+
+uint32_t Rendering::CullSpheresScalar(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible)
+{
+	return s_useAvx2 ?
+		CullSpheresScalarAs<true>(frustum, spheres, begin, end, visible) :
+		CullSpheresScalarAs<false>(frustum, spheres, begin, end, visible);
+}
+
+//----------------------------------------------------------------------
+
+#if defined(SUMO_CULL_AVX2)
+
+namespace
+{
+	template <bool SharedRadius>
+	SUMO_AVX2_TARGET uint32_t CullSpheresAvx2(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		const __m256 x0 = _mm256_set1_ps(frustum.clipX.x);
+		const __m256 x1 = _mm256_set1_ps(frustum.clipX.y);
+		const __m256 x2 = _mm256_set1_ps(frustum.clipX.z);
+		const __m256 x3 = _mm256_set1_ps(frustum.clipX.w);
+		const __m256 y0 = _mm256_set1_ps(frustum.clipY.x);
+		const __m256 y1 = _mm256_set1_ps(frustum.clipY.y);
+		const __m256 y2 = _mm256_set1_ps(frustum.clipY.z);
+		const __m256 y3 = _mm256_set1_ps(frustum.clipY.w);
+		const __m256 d0 = _mm256_set1_ps(frustum.depth.x);
+		const __m256 d1 = _mm256_set1_ps(frustum.depth.y);
+		const __m256 d2 = _mm256_set1_ps(frustum.depth.z);
+		const __m256 d3 = _mm256_set1_ps(frustum.depth.w);
+		const __m256 wScale = _mm256_set1_ps(frustum.wScale);
+		const __m256 wOffset = _mm256_set1_ps(frustum.wOffset);
+		const __m256 xScale = _mm256_set1_ps(frustum.xScale);
+		const __m256 yScale = _mm256_set1_ps(frustum.yScale);
+		const __m256 depthRange = _mm256_set1_ps(frustum.depthRange);
+		const __m256 sharedRadius = _mm256_set1_ps(spheres.sharedRadius);
+		const __m256 sharedX = _mm256_set1_ps(spheres.sharedRadius * frustum.xScale);
+		const __m256 sharedY = _mm256_set1_ps(spheres.sharedRadius * frustum.yScale);
+		const __m256 sign = _mm256_set1_ps(-0.0f);
+		const __m256 zero = _mm256_setzero_ps();
+
+		uint32_t written = 0;
+		uint32_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 x = _mm256_loadu_ps(spheres.centerX + i);
+			__m256 y = _mm256_loadu_ps(spheres.centerY + i);
+			__m256 z = _mm256_loadu_ps(spheres.centerZ + i);
+			__m256 radius = SharedRadius ? sharedRadius : _mm256_loadu_ps(spheres.radius + i);
+			__m256 radiusX = SharedRadius ? sharedX : _mm256_mul_ps(radius, xScale);
+			__m256 radiusY = SharedRadius ? sharedY : _mm256_mul_ps(radius, yScale);
+
+			__m256 clipX = _mm256_fmadd_ps(z, x2, _mm256_fmadd_ps(y, x1, _mm256_fmadd_ps(x, x0, x3)));
+			__m256 clipY = _mm256_fmadd_ps(z, y2, _mm256_fmadd_ps(y, y1, _mm256_fmadd_ps(x, y0, y3)));
+			__m256 depth = _mm256_fmadd_ps(z, d2, _mm256_fmadd_ps(y, d1, _mm256_fmadd_ps(x, d0, d3)));
+			__m256 w = _mm256_fmadd_ps(depth, wScale, wOffset);
+
+			// The sphere is visible when it reaches outside none of the planes.
+			__m256 outsideX = _mm256_sub_ps(_mm256_sub_ps(_mm256_andnot_ps(sign, clipX), w), radiusX);
+			__m256 outsideY = _mm256_sub_ps(_mm256_sub_ps(_mm256_andnot_ps(sign, clipY), w), radiusY);
+			__m256 outsideNear = _mm256_sub_ps(_mm256_sub_ps(zero, depth), radius);
+			__m256 outsideFar = _mm256_sub_ps(_mm256_sub_ps(depth, depthRange), radius);
+			__m256 outside = _mm256_max_ps(_mm256_max_ps(outsideX, outsideY), _mm256_max_ps(outsideNear, outsideFar));
+
+			uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(outside, zero, _CMP_LE_OQ)));
+			__m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s_laneTable.lanes[mask]));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(visible + written), _mm256_add_epi32(lanes, _mm256_set1_epi32(static_cast<int>(i))));
+			written += s_laneTable.counts[mask];
+		}
+
+		return written + CullSpheresScalarAs<true>(frustum, spheres, i, end, visible + written);
+	}
+}
+
+#endif
+
+#if defined(SUMO_CULL_SSE2)
+
+namespace
+{
+	template <bool SharedRadius>
+	uint32_t CullSpheresSse2(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		const __m128 x0 = _mm_set1_ps(frustum.clipX.x);
+		const __m128 x1 = _mm_set1_ps(frustum.clipX.y);
+		const __m128 x2 = _mm_set1_ps(frustum.clipX.z);
+		const __m128 x3 = _mm_set1_ps(frustum.clipX.w);
+		const __m128 y0 = _mm_set1_ps(frustum.clipY.x);
+		const __m128 y1 = _mm_set1_ps(frustum.clipY.y);
+		const __m128 y2 = _mm_set1_ps(frustum.clipY.z);
+		const __m128 y3 = _mm_set1_ps(frustum.clipY.w);
+		const __m128 d0 = _mm_set1_ps(frustum.depth.x);
+		const __m128 d1 = _mm_set1_ps(frustum.depth.y);
+		const __m128 d2 = _mm_set1_ps(frustum.depth.z);
+		const __m128 d3 = _mm_set1_ps(frustum.depth.w);
+		const __m128 wScale = _mm_set1_ps(frustum.wScale);
+		const __m128 wOffset = _mm_set1_ps(frustum.wOffset);
+		const __m128 xScale = _mm_set1_ps(frustum.xScale);
+		const __m128 yScale = _mm_set1_ps(frustum.yScale);
+		const __m128 depthRange = _mm_set1_ps(frustum.depthRange);
+		const __m128 sharedRadius = _mm_set1_ps(spheres.sharedRadius);
+		const __m128 sharedX = _mm_set1_ps(spheres.sharedRadius * frustum.xScale);
+		const __m128 sharedY = _mm_set1_ps(spheres.sharedRadius * frustum.yScale);
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		// Eight spheres a pass, as two groups of four, so the compaction handles
+		// eight at a time as it does for AVX2.
+		uint32_t written = 0;
+		uint32_t i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			uint32_t mask = 0;
+			for (uint32_t group = 0; group < 8; group += 4)
+			{
+				uint32_t first = i + group;
+				__m128 x = _mm_loadu_ps(spheres.centerX + first);
+				__m128 y = _mm_loadu_ps(spheres.centerY + first);
+				__m128 z = _mm_loadu_ps(spheres.centerZ + first);
+				__m128 radius = SharedRadius ? sharedRadius : _mm_loadu_ps(spheres.radius + first);
+				__m128 radiusX = SharedRadius ? sharedX : _mm_mul_ps(radius, xScale);
+				__m128 radiusY = SharedRadius ? sharedY : _mm_mul_ps(radius, yScale);
+
+				__m128 clipX = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x0), _mm_mul_ps(y, x1)), _mm_mul_ps(z, x2)), x3);
+				__m128 clipY = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, y0), _mm_mul_ps(y, y1)), _mm_mul_ps(z, y2)), y3);
+				__m128 depth = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, d0), _mm_mul_ps(y, d1)), _mm_mul_ps(z, d2)), d3);
+				__m128 w = _mm_add_ps(_mm_mul_ps(depth, wScale), wOffset);
+
+				__m128 outsideX = _mm_sub_ps(_mm_sub_ps(_mm_andnot_ps(sign, clipX), w), radiusX);
+				__m128 outsideY = _mm_sub_ps(_mm_sub_ps(_mm_andnot_ps(sign, clipY), w), radiusY);
+				__m128 outsideNear = _mm_sub_ps(_mm_sub_ps(zero, depth), radius);
+				__m128 outsideFar = _mm_sub_ps(_mm_sub_ps(depth, depthRange), radius);
+				__m128 outside = _mm_max_ps(_mm_max_ps(outsideX, outsideY), _mm_max_ps(outsideNear, outsideFar));
+
+				mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(outside, zero))) << group;
+			}
+			written = AppendVisible(mask, i, visible, written);
+		}
+
+		return written + CullSpheresScalarAs<false>(frustum, spheres, i, end, visible + written);
+	}
+}
+
+uint32_t Rendering::CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible)
+{
+	bool shared = spheres.radius == nullptr;
+#if defined(SUMO_CULL_AVX2)
+	if (s_useAvx2)
+	{
+		return shared ?
+			CullSpheresAvx2<true>(frustum, spheres, begin, end, visible) :
+			CullSpheresAvx2<false>(frustum, spheres, begin, end, visible);
+	}
+#endif
+	return shared ?
+		CullSpheresSse2<true>(frustum, spheres, begin, end, visible) :
+		CullSpheresSse2<false>(frustum, spheres, begin, end, visible);
+}
+
+const char* Rendering::CullingInstructionSet()
+{
+	return s_useAvx2 ? "AVX2" : "SSE2";
+}
+
+#else
+
+uint32_t Rendering::CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible)
+{
+	return CullSpheresScalar(frustum, spheres, begin, end, visible);
+}
+
+const char* Rendering::CullingInstructionSet()
+{
+	return "scalar";
+}
+
+#endif
+
+//----------------------------------------------------------------------
+
+FrustumCuller::FrustumCuller() :
+	m_jobs(nullptr)
+{
+}
+
+//----------------------------------------------------------------------
+
+uint32_t FrustumCuller::Cull(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t count, uint32_t* visible)
+{
+	if (m_jobs == nullptr || m_jobs->ThreadCount() == 1 || count <= ChunkSize)
+	{
+		return CullSpheres(frustum, spheres, 0, count, visible);
+	}
+
+	// Each chunk writes its list where its spheres start, then the lists are moved
+	// down to follow each other.
+	uint32_t chunks = (count + ChunkSize - 1) / ChunkSize;
+	m_chunkCounts.resize(chunks);
+	m_jobs->ParallelFor(count, ChunkSize, [&](uint32_t begin, uint32_t end)
+	{
+		m_chunkCounts[begin / ChunkSize] = CullSpheres(frustum, spheres, begin, end, visible + begin);
+	});
+
+	uint32_t written = m_chunkCounts[0];
+	for (uint32_t chunk = 1; chunk < chunks; chunk++)
+	{
+		memmove(visible + written, visible + chunk * ChunkSize, m_chunkCounts[chunk] * sizeof(uint32_t));
+		written += m_chunkCounts[chunk];
+	}
+	return written;
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,98 @@
+#pragma once
+
+// FrustumCulling:
+// Finds the objects whose bounding spheres are at least partly inside the
+// camera's view frustum, so only those are recorded and drawn.
+//
+// ExtractFrustum() takes the frustum from the camera's view and projection
+// matrices, untransposed as Camera::View() and Camera::Projection() return
+// them.  Rather than testing six planes, it keeps the three rows of the combined
+// matrix that give a point's clip space x and y and its depth past the near
+// plane, and clip space w as a function of that depth.  A sphere is then outside
+// the left or right plane when |x| - w exceeds its scaled radius, and likewise
+// for y, so the six plane tests take three dot products instead of six.  That
+// holds for projections whose w depends only on depth, as perspective and
+// orthographic ones do.  Off-center projections, whose left and right planes
+// have normals of different lengths, are tested against the longer one, which
+// never culls a sphere that is inside.
+//
+// The spheres are read as a structure of arrays, a center axis per array and
+// a radius per sphere or one radius shared by all of them, which spares
+// streaming a radius array for objects of the same size.  They are tested eight
+// at a time: in one AVX2 register, or two SSE2 registers, with any left over
+// going through the scalar version of the same test.  x86 builds check the
+// processor once and use the AVX2 kernel when it has AVX2 and FMA.  That kernel
+// uses fused multiply-adds, and the scalar test then rounds the same way, so
+// both always pick the same spheres.  The test is
+// conservative: a sphere near a corner of the frustum, outside it but inside
+// all six planes, counts as visible.
+//
+// The result is a compact list of the visible objects' indices in increasing
+// order.  With a JobSystem the spheres are cut into fixed chunks that are culled
+// in parallel and their lists joined in chunk order, so every thread count gives
+// the same list.
+
+#include "RenderMath.h"
+#include "../Simulation/JobSystem.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	// Each row gives a value for a point as row.x * x + row.y * y + row.z * z + row.w.
+	struct Frustum
+	{
+		Float4 clipX;
+		Float4 clipY;
+		Float4 depth;       // The distance in front of the near plane.
+		float  wScale;      // Clip space w = depth * wScale + wOffset.
+		float  wOffset;
+		float  xScale;      // How much |x| - w grows per unit of distance outside the left or right plane.
+		float  yScale;      // The same for the bottom and top planes.
+		float  depthRange;  // From the near plane to the far plane.
+	};
+
+	// Direct3D's clip space, with z from 0 at the near plane to w at the far one.
+	Frustum ExtractFrustum(const Float4x4& view, const Float4x4& projection);
+
+	struct BoundingSpheres
+	{
+		const float* centerX;
+		const float* centerY;
+		const float* centerZ;
+		const float* radius;        // Per sphere, or null when every sphere has sharedRadius.
+		float        sharedRadius;
+	};
+
+	// Write the indices in [begin, end) of the spheres inside the frustum to
+	// 'visible' and return how many there are.  'visible' has room for end - begin.
+	uint32_t CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible);
+
+	// Always uses the scalar test, for platforms without SIMD and for comparison.
+	// It rounds as the kernel CullSpheres picked does.
+	uint32_t CullSpheresScalar(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible);
+
+	// "AVX2", "SSE2" or "scalar": the kernel CullSpheres uses.
+	const char* CullingInstructionSet();
+
+	class FrustumCuller
+	{
+	public:
+		FrustumCuller();
+
+		// The threads to cull with; without a JobSystem everything runs on the calling thread.
+		void Jobs(Simulation::JobSystem* jobs)      { m_jobs = jobs; }
+
+		// Cull 'count' spheres into 'visible', which has room for all of them, and
+		// return how many are visible.
+		uint32_t Cull(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t count, uint32_t* visible);
+
+	private:
+		FrustumCuller(const FrustumCuller&);
+		FrustumCuller& operator=(const FrustumCuller&);
+
+		Simulation::JobSystem* m_jobs;
+		std::vector<uint32_t>  m_chunkCounts;   // Visible spheres in each chunk.
+	};
+}
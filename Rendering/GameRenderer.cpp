@@ -188,6 +188,16 @@ task<void> GameRenderer::CreateGameDeviceResourcesAsync(_In_ SumoDX^ game)
     tasks.push_back(loader->LoadShaderAsync("PixelShader.cso", &m_pixelShader));
   //  tasks.push_back(loader->LoadShaderAsync("PixelShaderFlat.cso", &m_pixelShaderFlat));
 
+    // Instanced draws need feature level 9_3; below it every sumo is drawn on its own.
+    m_vertexShaderInstanced = nullptr;
+    m_pixelShaderInstanced = nullptr;
+    m_instancedLayout = nullptr;
+    if (m_featureLevel >= D3D_FEATURE_LEVEL_9_3)
+    {
+        tasks.push_back(loader->LoadShaderAsync("VertexShaderInstanced.cso", PNTInstancedLayout, ARRAYSIZE(PNTInstancedLayout), &m_vertexShaderInstanced, &m_instancedLayout));
+        tasks.push_back(loader->LoadShaderAsync("PixelShaderInstanced.cso", &m_pixelShaderInstanced));
+    }
+
     // Make sure the previous versions if any of the textures are released.
 	m_playerTexture = nullptr;
     m_cylinderTexture = nullptr;
@@ -225,70 +235,99 @@ void GameRenderer::FinalizeCreateGameDeviceResources()
     // These are handled here to ensure that the d3dContext is only
     // used in one thread.
 
-    ConstantBufferNeverChanges constantBufferNeverChanges;
-    constantBufferNeverChanges.lightPosition[0] = XMFLOAT4( 3.5f, 2.5f,  5.5f, 1.0f);
-    constantBufferNeverChanges.lightPosition[1] = XMFLOAT4( 3.5f, 2.5f, -5.5f, 1.0f);
-    constantBufferNeverChanges.lightPosition[2] = XMFLOAT4(-3.5f, 2.5f, -5.5f, 1.0f);
-    constantBufferNeverChanges.lightPosition[3] = XMFLOAT4( 3.5f, 2.5f,  5.5f, 1.0f);
-    constantBufferNeverChanges.lightColor = XMFLOAT4(0.25f, 0.25f, 0.25f, 1.0f);
+    // The lights and materials are shared with the software renderer.
+    Rendering::ConstantBufferNeverChanges constantBufferNeverChanges = Rendering::GameLights();
     m_d3dContext->UpdateSubresource(m_constantBufferNeverChanges.Get(), 0, nullptr, &constantBufferNeverChanges, 0, 0);
 
-	Material^ playerMaterial = ref new Material(
-		XMFLOAT4(0.8f, 0.8f, 0.8f, .5f),
-		XMFLOAT4(1.0f, 1.0f, 1.0f, .5f),
-		XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f),
-		15.0f,
-		m_playerTexture.Get(),
-		m_vertexShader.Get(),
-		m_pixelShader.Get()
-		);
-
-	Material^ enemyMaterial = ref new Material(
-		XMFLOAT4(0.8f, 0.8f, 0.8f, .5f),
-		XMFLOAT4(0.65f, 0.65f, 0.6f, .5f),
-		XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f),
-		15.0f,
-		m_enemyTexture.Get(),
-		m_vertexShader.Get(),
-		m_pixelShader.Get()
-		);
-
-	Material^ cylinderMaterial = ref new Material(
-		XMFLOAT4(0.8f, 0.8f, 0.8f, .5f),
-		XMFLOAT4(0.8f, 0.8f, 0.8f, .5f),
-		XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f),
-		15.0f,
-		m_cylinderTexture.Get(),
-		m_vertexShader.Get(),
-		m_pixelShader.Get()
-		);
-   
+    // Register the shaders, textures and meshes with the backend, which hands back the
+    // ids the command lists refer to them by.
+    ID3D11Buffer* constantBuffers[] = {
+        m_constantBufferNeverChanges.Get(),
+        m_constantBufferChangeOnResize.Get(),
+        m_constantBufferChangesEveryFrame.Get(),
+        m_constantBufferChangesEveryPrim.Get(),
+    };
+    m_backend.Reset(m_d3dContext.Get(), m_samplerLinear.Get(), constantBuffers);
+
+    Rendering::ResourceId vertexShader = m_backend.AddVertexShader(m_vertexShader.Get(), m_vertexLayout.Get());
+    Rendering::ResourceId pixelShader = m_backend.AddPixelShader(m_pixelShader.Get());
+
+    // Draw each batch of blocks sharing the sumo mesh and a material with one
+    // instanced draw, when the device can.
+    bool instanced = m_vertexShaderInstanced != nullptr;
+    Rendering::ResourceId instancedVertexShader = vertexShader;
+    Rendering::ResourceId instancedPixelShader = pixelShader;
+    if (instanced)
+    {
+        instancedVertexShader = m_backend.AddVertexShader(m_vertexShaderInstanced.Get(), m_instancedLayout.Get());
+        instancedPixelShader = m_backend.AddPixelShader(m_pixelShaderInstanced.Get());
+    }
+    Rendering::SceneRecorderSettings recorderSettings = Rendering::DefaultSceneRecorderSettings();
+    recorderSettings.instanceDraws = instanced;
+    m_sceneRecorder = Rendering::SceneRecorder(recorderSettings);
+
+    Rendering::RenderMaterial playerMaterial = {
+        Rendering::PlayerMaterial(), vertexShader, pixelShader, m_backend.AddTexture(m_playerTexture.Get()),
+        instancedVertexShader, instancedPixelShader
+    };
+    Rendering::RenderMaterial enemyMaterial = {
+        Rendering::EnemyMaterial(), vertexShader, pixelShader, m_backend.AddTexture(m_enemyTexture.Get()),
+        instancedVertexShader, instancedPixelShader
+    };
+    Rendering::RenderMaterial cylinderMaterial = {
+        Rendering::CylinderMaterial(), vertexShader, pixelShader, m_backend.AddTexture(m_cylinderTexture.Get()),
+        instancedVertexShader, instancedPixelShader
+    };
+
     MeshObject^ sumoMesh = ref new SumoMesh(m_d3dDevice.Get());
    
 	MeshObject^ cylinderMesh = ref new CylinderMesh(m_d3dDevice.Get(), 26);
 
+    // Register the meshes and materials.  Game objects refer to them by their index in these tables.
+    m_meshes.clear();
+    m_materials.clear();
+
+    const uint16 sumoMeshId = static_cast<uint16>(m_meshes.size());
+    Rendering::RenderMesh sumoMeshEntry = { m_backend.AddMesh(sumoMesh), static_cast<uint32>(sumoMesh->IndexCount()), sumoMesh->BoundingRadius() };
+    m_meshes.push_back(sumoMeshEntry);
+    const uint16 cylinderMeshId = static_cast<uint16>(m_meshes.size());
+    Rendering::RenderMesh cylinderMeshEntry = { m_backend.AddMesh(cylinderMesh), static_cast<uint32>(cylinderMesh->IndexCount()), cylinderMesh->BoundingRadius() };
+    m_meshes.push_back(cylinderMeshEntry);
+
+    const uint16 playerMaterialId = static_cast<uint16>(m_materials.size());
+    m_materials.push_back(playerMaterial);
+    const uint16 enemyMaterialId = static_cast<uint16>(m_materials.size());
+    m_materials.push_back(enemyMaterial);
+    const uint16 cylinderMaterialId = static_cast<uint16>(m_materials.size());
+    m_materials.push_back(cylinderMaterial);
+
     auto objects = m_game->RenderObjects();
 
     // Attach the textures to the appropriate game objects.
     for (auto object = objects.begin(); object != objects.end(); object++)
     {
-		if (AISumoBlock^ evilSumoBlock = dynamic_cast<AISumoBlock^>(*object))
+		Simulation::RenderHandle handle = { Simulation::NoRenderResource, Simulation::NoRenderResource };
+		if (dynamic_cast<AISumoBlock^>(*object) != nullptr)
 		{
-			evilSumoBlock->Mesh(sumoMesh);
-			evilSumoBlock->NormalMaterial(enemyMaterial);
+			handle.mesh = sumoMeshId;
+			handle.material = enemyMaterialId;
 		}
-		else if (SumoBlock^ sumoBlock = dynamic_cast<SumoBlock^>(*object))
+		else if (dynamic_cast<SumoBlock^>(*object) != nullptr)
 		{
-			sumoBlock->Mesh(sumoMesh);
-			sumoBlock->NormalMaterial(playerMaterial);
+			handle.mesh = sumoMeshId;
+			handle.material = playerMaterialId;
 		}
-		else if (Cylinder^ cylinder = dynamic_cast<Cylinder^>(*object))
+		else if (dynamic_cast<Cylinder^>(*object) != nullptr)
 		{
-			cylinder->Mesh(cylinderMesh);
-			cylinder->NormalMaterial(cylinderMaterial);
+			handle.mesh = cylinderMeshId;
+			handle.material = cylinderMaterialId;
 		}
+		(*object)->RenderResources(handle);
     }
 
+    // Make the render handles visible to the next frame drawn.
+    m_game->PublishScene();
+
     // Ensure that the camera has been initialized with the right Projection
     // matrix.  The camera is not created at the time the first window resize event
     // occurs.
@@ -347,40 +386,60 @@ void GameRenderer::Render()
         // This section is only used after the game state has been initialized and all device
         // resources needed for the game have been created and associated with the game objects.
 
-        // Update variables that change once per frame.
-        ConstantBufferChangesEveryFrame constantBufferChangesEveryFrame;
+        // Record the visible part of this frame's scene snapshot into the command list and
+        // submit it.  The snapshot is read in place, so no objects are copied or reference
+        // counted.
+        Rendering::ConstantBufferChangesEveryFrame constantBufferChangesEveryFrame;
         XMStoreFloat4x4(
-            &constantBufferChangesEveryFrame.view,
+            reinterpret_cast<XMFLOAT4X4*>(&constantBufferChangesEveryFrame.view),
             XMMatrixTranspose(m_game->GameCamera()->View())
             );
-        m_d3dContext->UpdateSubresource(
-            m_constantBufferChangesEveryFrame.Get(),
-            0,
-            nullptr,
-            &constantBufferChangesEveryFrame,
-            0,
-            0
-            );
 
-        // Setup the graphics pipeline. This sample uses the same InputLayout and set of
-        // constant buffers for all shaders, so they only need to be set once per frame.
-
-        m_d3dContext->IASetInputLayout(m_vertexLayout.Get());
-        m_d3dContext->VSSetConstantBuffers(0, 1, m_constantBufferNeverChanges.GetAddressOf());
-        m_d3dContext->VSSetConstantBuffers(1, 1, m_constantBufferChangeOnResize.GetAddressOf());
-        m_d3dContext->VSSetConstantBuffers(2, 1, m_constantBufferChangesEveryFrame.GetAddressOf());
-        m_d3dContext->VSSetConstantBuffers(3, 1, m_constantBufferChangesEveryPrim.GetAddressOf());
-
-        m_d3dContext->PSSetConstantBuffers(2, 1, m_constantBufferChangesEveryFrame.GetAddressOf());
-        m_d3dContext->PSSetConstantBuffers(3, 1, m_constantBufferChangesEveryPrim.GetAddressOf());
-        m_d3dContext->PSSetSamplers(0, 1, m_samplerLinear.GetAddressOf());
-
-		//now walk through the render objects list and draw each object to screen
-        auto objects = m_game->RenderObjects();
-        for (auto object = objects.begin(); object != objects.end(); object++)
-        {
-            (*object)->Render(m_d3dContext.Get(), m_constantBufferChangesEveryPrim.Get());
-        }
+        const Simulation::SceneSnapshot& scene = m_game->Scene();
+        Rendering::SceneResources resources = {
+            m_materials.data(),
+            m_meshes.data(),
+            static_cast<uint32>(m_materials.size()),
+            static_cast<uint32>(m_meshes.size())
+        };
+
+        // Cull against the camera's own projection: the display rotation applied to the
+        // projection constant only turns the image on the screen.
+        Rendering::Float4x4 view;
+        Rendering::Float4x4 projection;
+        XMStoreFloat4x4(reinterpret_cast<XMFLOAT4X4*>(&view), m_game->GameCamera()->View());
+        XMStoreFloat4x4(reinterpret_cast<XMFLOAT4X4*>(&projection), m_game->GameCamera()->Projection());
+
+        uint32 count = scene.Count();
+        m_boundsX.resize(count);
+        m_boundsY.resize(count);
+        m_boundsZ.resize(count);
+        m_boundsRadius.resize(count);
+        m_visible.resize(count);
+        Rendering::SceneBoundingSpheres(
+            scene.Transforms().begin(),
+            scene.RenderHandles().begin(),
+            count,
+            resources,
+            m_boundsX.data(),
+            m_boundsY.data(),
+            m_boundsZ.data(),
+            m_boundsRadius.data()
+            );
+        Rendering::BoundingSpheres spheres = { m_boundsX.data(), m_boundsY.data(), m_boundsZ.data(), m_boundsRadius.data(), 0.0f };
+        uint32 visibleCount = m_culler.Cull(Rendering::ExtractFrustum(view, projection), spheres, count, m_visible.data());
+
+        m_commandList.Clear();
+        m_sceneRecorder.Record(
+            scene.Transforms().begin(),
+            scene.RenderHandles().begin(),
+            visibleCount,
+            constantBufferChangesEveryFrame,
+            resources,
+            &m_commandList,
+            m_visible.data()
+            );
+        m_backend.Execute(m_commandList);
     }
 
 	//Now begin the process of drawing any HUD or 2D overlay elements on top of everything else.
@@ -29,7 +29,13 @@
 //
 // The renderer also maintains a set of texture resources that will be associated with particular game objects.
 // It knows which textures are to be associated with which objects and will do that association once the
-// textures have been loaded.
+// textures have been loaded.  The meshes and materials are kept in tables owned by the renderer; game objects
+// only store the ids (Simulation::RenderHandle) of the mesh and material they are drawn with.
+//
+// Each frame the objects outside the camera's view frustum are culled, the rest of the scene is recorded
+// into a Rendering::CommandList, sorted so objects sharing shaders, texture and mesh are drawn together
+// without binding them again, and the D3D11Backend then submits it to the device context.  The shaders,
+// textures and meshes are registered with the backend, and the command list names them by the ids it returns.
 //
 // The renderer provides a set of methods to allow for a "standard" sequence to be executed for loading general
 // game resources and for level specific resources.  Because D3D11 allows free threaded creation of objects,
@@ -48,6 +54,10 @@
 #include "DirectXBase.h"
 #include "GameInfoOverlay.h"
 #include "GameHud.h"
+#include "D3D11Backend.h"
+#include "SceneCommands.h"
+#include "FrustumCulling.h"
+#include "../Meshes/MeshObject.h"
 #include "SumoDX.h"
 
 ref class SumoDX;
@@ -120,4 +130,19 @@ protected private:
     Microsoft::WRL::ComPtr<ID3D11PixelShader>           m_pixelShader;
     Microsoft::WRL::ComPtr<ID3D11PixelShader>           m_pixelShaderFlat;
     Microsoft::WRL::ComPtr<ID3D11InputLayout>           m_vertexLayout;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader>          m_vertexShaderInstanced;
+    Microsoft::WRL::ComPtr<ID3D11PixelShader>           m_pixelShaderInstanced;
+    Microsoft::WRL::ComPtr<ID3D11InputLayout>           m_instancedLayout;
+
+    std::vector<Rendering::RenderMesh>                  m_meshes;           // Indexed by RenderHandle::mesh.
+    std::vector<Rendering::RenderMaterial>              m_materials;        // Indexed by RenderHandle::material.
+    Rendering::SceneRecorder                            m_sceneRecorder;
+    Rendering::FrustumCuller                            m_culler;
+    std::vector<float>                                  m_boundsX;          // The scene's bounding spheres, for culling.
+    std::vector<float>                                  m_boundsY;
+    std::vector<float>                                  m_boundsZ;
+    std::vector<float>                                  m_boundsRadius;
+    std::vector<uint32>                                 m_visible;          // The entities inside the view frustum.
+    Rendering::CommandList                              m_commandList;
+    D3D11Backend                                        m_backend;
 };
@@ -0,0 +1,82 @@
+#include "InstanceBuilder.h"
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+InstanceBuilder::InstanceBuilder() :
+	m_meshCount(0),
+	m_instanceCount(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void InstanceBuilder::Count(
+	const Simulation::RenderHandle* handles,
+	uint32_t count,
+	uint32_t materialCount,
+	uint32_t meshCount,
+	const uint32_t* visible)
+{
+	m_meshCount = meshCount;
+	m_cursors.assign(materialCount * meshCount, 0);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Simulation::RenderHandle handle = handles[(visible != nullptr) ? visible[i] : i];
+		if ((handle.mesh == Simulation::NoRenderResource) || (handle.material == Simulation::NoRenderResource))
+		{
+			continue;
+		}
+		m_cursors[handle.material * meshCount + handle.mesh]++;
+	}
+
+	// Lay the batches out one after another and point each cursor at its batch's start.
+	m_batches.clear();
+	m_instanceCount = 0;
+	for (uint32_t batch = 0; batch < m_cursors.size(); batch++)
+	{
+		uint32_t instances = m_cursors[batch];
+		m_cursors[batch] = m_instanceCount;
+		if (instances > 0)
+		{
+			InstanceBatch entry = {
+				static_cast<uint16_t>(batch / meshCount),
+				static_cast<uint16_t>(batch % meshCount),
+				m_instanceCount,
+				instances
+			};
+			m_batches.push_back(entry);
+			m_instanceCount += instances;
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void InstanceBuilder::Build(
+	const Simulation::Float4x4* transforms,
+	const Simulation::RenderHandle* handles,
+	uint32_t count,
+	const Float4* tints,
+	InstanceData* instances,
+	const uint32_t* visible)
+{
+	uint32_t* cursors = m_cursors.data();
+	uint32_t meshCount = m_meshCount;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t entity = (visible != nullptr) ? visible[i] : i;
+		Simulation::RenderHandle handle = handles[entity];
+		if ((handle.mesh == Simulation::NoRenderResource) || (handle.material == Simulation::NoRenderResource))
+		{
+			continue;
+		}
+
+		InstanceData& instance = instances[cursors[handle.material * meshCount + handle.mesh]++];
+		instance.world = transforms[entity];
+		instance.tint = tints[handle.material];
+	}
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,70 @@
+#pragma once
+
+// InstanceBuilder:
+// Groups a frame's entities into batches that share a mesh and a material and
+// writes the instance stream for them: each entity's world matrix and its
+// material's tint, straight from the EntityStore's transform and handle arrays.
+// Each batch's instances are contiguous, so a batch is drawn with a single
+// DrawIndexedInstanced however many entities it holds.
+//
+// Building takes two passes over the handles.  Count() sizes the batches, so
+// the caller can find room for InstanceCount() instances (usually in a
+// CommandList, through UploadInstances()); Build() then scatters every entity
+// into its batch's range.  Within a batch the instances keep entity order.
+//
+// Batches are ordered by material, then mesh, and only those with instances are
+// listed.  Entities without a mesh or a material are left out.  Given a list of
+// visible entities (see FrustumCulling.h), only the 'count' entities it names
+// are drawn.
+
+#include "../Simulation/EntityStore.h"
+#include "ShaderConstants.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	struct InstanceBatch
+	{
+		uint16_t material;          // RenderHandle ids.
+		uint16_t mesh;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	class InstanceBuilder
+	{
+	public:
+		InstanceBuilder();
+
+		// Count the instances of every batch.  Every handle's ids must be below the
+		// counts given, or NoRenderResource.  'visible', when given, lists the
+		// entities to draw in increasing order and 'count' is its length.
+		void Count(
+			const Simulation::RenderHandle* handles,
+			uint32_t count,
+			uint32_t materialCount,
+			uint32_t meshCount,
+			const uint32_t* visible = nullptr);
+
+		// Write the instances of the entities just counted into 'instances', which
+		// has room for InstanceCount() of them.  'tints' is indexed by material.
+		void Build(
+			const Simulation::Float4x4* transforms,
+			const Simulation::RenderHandle* handles,
+			uint32_t count,
+			const Float4* tints,
+			InstanceData* instances,
+			const uint32_t* visible = nullptr);
+
+		uint32_t InstanceCount() const                      { return m_instanceCount; }
+		const std::vector<InstanceBatch>& Batches() const   { return m_batches; }
+
+	private:
+		uint32_t                   m_meshCount;
+		uint32_t                   m_instanceCount;
+		std::vector<uint32_t>      m_cursors;      // Per material and mesh: its count, then where its next instance goes.
+		std::vector<InstanceBatch> m_batches;
+	};
+}
@@ -0,0 +1,141 @@
+#include "MeshData.h"
+
+#include <cmath>
+
+using namespace Rendering;
+
+namespace
+{
+	const float TwoPi = 6.283185307f;
+
+	PNTVertex MakeVertex(Float3 position, Float3 normal, Float2 textureCoordinate)
+	{
+		PNTVertex vertex = { position, normal, textureCoordinate };
+		return vertex;
+	}
+}
+
+//----------------------------------------------------------------------
+
+float MeshData::BoundingRadius() const
+{
+	float radiusSquared = 0.0f;
+	for (const PNTVertex& vertex : vertices)
+	{
+		const Float3& p = vertex.position;
+		float lengthSquared = p.x * p.x + p.y * p.y + p.z * p.z;
+		if (lengthSquared > radiusSquared)
+		{
+			radiusSquared = lengthSquared;
+		}
+	}
+	return sqrtf(radiusSquared);
+}
+
+//----------------------------------------------------------------------
+
+MeshData Rendering::SumoMeshData()
+{
+	const PNTVertex sumoVertices[] =
+	{
+		{ { -0.5f, -0.5f, -0.5f }, { -1.0f, -1.0f, -1.0f }, { 0.63f, 0.005f } },
+		{ { -0.5f, -0.5f, 0.5f }, { -1.0f, -1.0f, 1.0f }, { 0.99f, 0.005f } },
+		{ { -0.5f, 0.5f, -0.5f }, { -1.0f, 1.0f, -1.0f }, { 0.6345f, 0.01f } },
+		{ { -0.5f, 0.5f, 0.5f }, { -1.0f, 1.0f, 1.0f }, { 0.99f, 0.01f } },
+		{ { 0.5f, -0.5f, -0.5f }, { 1.0f, -1.0f, -1.0f }, { 0.6f, 0.36f } },
+		{ { 0.5f, -0.5f, 0.5f }, { 1.0f, -1.0f, 1.0f }, { 0.99f, 0.36f } },
+		{ { 0.5f, 0.5f, -0.5f }, { 1.0f, 1.0f, -1.0f }, { 0.6345f, 0.3655f } },
+		{ { 0.5f, 0.5f, 0.5f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, 0.3655f } }
+	};
+	const uint16_t sumoIndices[] =
+	{
+		0, 1, 2, // -x
+		1, 3, 2,
+
+		4, 6, 5, // +x
+		5, 6, 7,
+
+		0, 5, 1, // -y
+		0, 4, 5,
+
+		2, 7, 6, // +y
+		2, 3, 7,
+
+		0, 6, 4, // -z
+		0, 2, 6,
+
+		1, 7, 3, // +z
+		1, 5, 7
+	};
+
+	MeshData mesh;
+	mesh.vertices.assign(sumoVertices, sumoVertices + sizeof(sumoVertices) / sizeof(sumoVertices[0]));
+	mesh.indices.assign(sumoIndices, sumoIndices + sizeof(sumoIndices) / sizeof(sumoIndices[0]));
+	return mesh;
+}
+
+//----------------------------------------------------------------------
+
+MeshData Rendering::CylinderMeshData(uint32_t segments)
+{
+	MeshData mesh;
+	mesh.vertices.reserve(6 * (segments + 1));
+
+	// Each ring of points is repeated with the normals of the surfaces that meet there.
+	// The texture wraps once around the side, from the top edge to the bottom.
+	struct Ring
+	{
+		bool  edge;         // On the rim, rather than the center of the top or bottom.
+		float z;
+		int   normal;       // 1 for up, -1 for down, 0 for out from the side.
+	};
+	const Ring rings[] =
+	{
+		{ false, 1.0f, 1 },     // Top center point (multiple points for texture coordinates).
+		{ true, 1.0f, 1 },      // Top edge of cylinder: normals point up for lighting of top surface.
+		{ true, 1.0f, 0 },      // Top edge of cylinder: normals point out for lighting of the side surface.
+		{ true, 0.0f, 0 },      // Bottom edge of cylinder: normals point out for lighting of the side surface.
+		{ true, 0.0f, -1 },     // Bottom edge of cylinder: normals point down for lighting of the bottom surface.
+		{ false, 0.0f, -1 },    // Bottom center of cylinder: normals point down for lighting on the bottom surface.
+	};
+	for (const Ring& ring : rings)
+	{
+		for (uint32_t a = 0; a <= segments; a++)
+		{
+			float u = static_cast<float>(a) / static_cast<float>(segments);
+			float angle = u * TwoPi;
+			float x = ring.edge ? std::cos(angle) : 0.0f;
+			float y = ring.edge ? std::sin(angle) : 0.0f;
+			Float3 normal = (ring.normal == 0) ?
+				Simulation::MakeFloat3(std::cos(angle), std::sin(angle), 0.0f) :
+				Simulation::MakeFloat3(0.0f, 0.0f, static_cast<float>(ring.normal));
+			mesh.vertices.push_back(MakeVertex(Simulation::MakeFloat3(x, y, ring.z), normal, MakeFloat2(u, 1.0f - ring.z)));
+		}
+	}
+
+	// The top and bottom are fans of single triangles; the rings between are quads.
+	mesh.indices.reserve(3 * segments * 5);
+	for (uint32_t a = 0; a < 6; a += 2)
+	{
+		uint16_t p1 = static_cast<uint16_t>(a * (segments + 1));
+		uint16_t p2 = static_cast<uint16_t>((a + 1) * (segments + 1));
+		for (uint16_t b = 0; b < segments; b++)
+		{
+			if (a < 4)
+			{
+				mesh.indices.push_back(b + p1);
+				mesh.indices.push_back(b + p2);
+				mesh.indices.push_back(b + p2 + 1);
+			}
+			if (a > 0)
+			{
+				mesh.indices.push_back(b + p1);
+				mesh.indices.push_back(b + p2 + 1);
+				mesh.indices.push_back(b + p1 + 1);
+			}
+		}
+	}
+	return mesh;
+}
+
+//----------------------------------------------------------------------
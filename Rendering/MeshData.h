@@ -0,0 +1,32 @@
+#pragma once
+
+// MeshData:
+// The geometry of the game's meshes as plain arrays of PNTVertex and 16 bit
+// indices, a triangle list in the layout of PNTVertexLayout.  SumoMesh and
+// CylinderMesh upload these to the GPU, and the software renderer draws them
+// directly, so both renderers draw the same triangles.
+
+#include "ShaderConstants.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	struct MeshData
+	{
+		std::vector<PNTVertex> vertices;
+		std::vector<uint16_t>  indices;
+
+		uint32_t TriangleCount() const              { return static_cast<uint32_t>(indices.size() / 3); }
+
+		// The radius of the smallest sphere around the mesh's origin that holds every vertex.
+		float BoundingRadius() const;
+	};
+
+	// A unit cube centered on the origin, textured with the sumo's face.
+	MeshData SumoMeshData();
+
+	// A closed cylinder of radius 1 along z from 0 to 1, with 'segments' sides.
+	MeshData CylinderMeshData(uint32_t segments);
+}
@@ -0,0 +1,155 @@
+#include "RenderBackend.h"
+
+#include <cstring>
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+namespace
+{
+	const uint64_t FnvOffset = 14695981039346656037ull;
+	const uint64_t FnvPrime = 1099511628211ull;
+
+	uint64_t Fnv(uint64_t hash, const uint8_t* data, uint32_t size)
+	{
+		for (uint32_t i = 0; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= FnvPrime;
+		}
+		return hash;
+	}
+}
+
+//----------------------------------------------------------------------
+
+void NullBackend::Execute(const CommandList& commands)
+{
+	// Decode the commands as a real backend would, but drop them.
+	uint64_t executed = 0;
+	const RenderCommand* command = commands.Commands();
+	for (uint32_t i = 0; i < commands.Count(); i++)
+	{
+		switch (command[i].type)
+		{
+		case CommandType::SetShaders:
+		case CommandType::SetTexture:
+		case CommandType::SetMesh:
+		case CommandType::UploadConstants:
+		case CommandType::DrawIndexed:
+		case CommandType::UploadInstances:
+		case CommandType::SetInstances:
+		case CommandType::DrawIndexedInstanced:
+			executed++;
+			break;
+		}
+	}
+	m_executed += executed;
+}
+
+//----------------------------------------------------------------------
+
+RecordingBackend::RecordingBackend()
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+//----------------------------------------------------------------------
+
+void RecordingBackend::Execute(const CommandList& commands)
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+	m_stats.commands = commands.Count();
+
+	ResourceId vertexShader = NoResource;
+	ResourceId pixelShader = NoResource;
+	ResourceId texture = NoResource;
+	ResourceId mesh = NoResource;
+	uint64_t constantHashes[static_cast<int>(ConstantSlot::Count)] = { 0 };
+	const InstanceData* instances = nullptr;
+	uint32_t firstInstance = 0;
+	const RenderCommand* command = commands.Commands();
+	for (uint32_t i = 0; i < commands.Count(); i++)
+	{
+		switch (command[i].type)
+		{
+		case CommandType::SetShaders:
+			m_stats.shaderChanges++;
+			if (command[i].resource0 == vertexShader && command[i].resource1 == pixelShader)
+			{
+				m_stats.redundantChanges++;
+			}
+			vertexShader = command[i].resource0;
+			pixelShader = command[i].resource1;
+			break;
+
+		case CommandType::SetTexture:
+			m_stats.textureChanges++;
+			if (command[i].resource0 == texture)
+			{
+				m_stats.redundantChanges++;
+			}
+			texture = command[i].resource0;
+			break;
+
+		case CommandType::SetMesh:
+			m_stats.meshChanges++;
+			if (command[i].resource0 == mesh)
+			{
+				m_stats.redundantChanges++;
+			}
+			mesh = command[i].resource0;
+			break;
+
+		case CommandType::UploadConstants:
+			m_stats.constantUploads++;
+			m_stats.constantBytes += command[i].value1;
+			constantHashes[command[i].resource0 % static_cast<int>(ConstantSlot::Count)] =
+				Fnv(FnvOffset, commands.UploadData(command[i]), command[i].value1);
+			break;
+
+		case CommandType::DrawIndexed:
+		{
+			m_stats.draws++;
+			m_stats.triangles += command[i].value0 / 3;
+			const ResourceId state[] = { vertexShader, pixelShader, texture, mesh };
+			uint64_t hash = Fnv(FnvOffset, reinterpret_cast<const uint8_t*>(state), sizeof(state));
+			hash = Fnv(hash, reinterpret_cast<const uint8_t*>(constantHashes), sizeof(constantHashes));
+			hash = Fnv(hash, reinterpret_cast<const uint8_t*>(&command[i].value0), 2 * sizeof(uint32_t));
+			m_stats.drawHash += hash;
+			break;
+		}
+
+		case CommandType::UploadInstances:
+			m_stats.instanceBytes += command[i].value1;
+			instances = reinterpret_cast<const InstanceData*>(commands.UploadData(command[i]));
+			break;
+
+		case CommandType::SetInstances:
+			firstInstance = command[i].value0;
+			break;
+
+		case CommandType::DrawIndexedInstanced:
+		{
+			m_stats.draws++;
+			m_stats.instances += command[i].value1;
+			m_stats.triangles += command[i].value0 / 3 * command[i].value1;
+			const ResourceId state[] = { vertexShader, pixelShader, texture, mesh };
+			uint64_t hash = Fnv(FnvOffset, reinterpret_cast<const uint8_t*>(state), sizeof(state));
+			hash = Fnv(hash, reinterpret_cast<const uint8_t*>(constantHashes), sizeof(constantHashes));
+			hash = Fnv(hash, reinterpret_cast<const uint8_t*>(&command[i].value0), 2 * sizeof(uint32_t));
+			hash = Fnv(
+				hash,
+				reinterpret_cast<const uint8_t*>(instances + firstInstance),
+				command[i].value1 * static_cast<uint32_t>(sizeof(InstanceData)));
+			m_stats.drawHash += hash;
+			break;
+		}
+		}
+	}
+
+	m_recorded = commands;
+}
+
+//----------------------------------------------------------------------
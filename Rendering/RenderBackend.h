@@ -0,0 +1,80 @@
+#pragma once
+
+// RenderBackend:
+// Executes a CommandList.  The game submits its lists to Direct3D through
+// D3D11Backend; the two backends here run anywhere, so the draw stream can be
+// measured without a GPU:
+//  - NullBackend decodes every command and does nothing with it, which leaves
+//    the cost of recording and walking a frame on its own;
+//  - RecordingBackend counts the draws, state changes and constant uploads of
+//    each frame and keeps a copy of the last list it was given.  It also hashes
+//    every draw together with the state it is drawn with, adding the hashes up
+//    so the total doesn't depend on the order of the draws: a list that draws
+//    the same things in another order, with fewer bindings, has the same hash.
+//    An instanced draw hashes the instances it reads along with its state.
+//
+// A backend starts every list with nothing bound, so the first binding of each
+// state in a frame always counts as a change.
+
+#include "CommandList.h"
+
+#include <cstdint>
+
+namespace Rendering
+{
+	class RenderBackend
+	{
+	public:
+		virtual ~RenderBackend() {}
+
+		virtual void Execute(const CommandList& commands) = 0;
+	};
+
+	class NullBackend : public RenderBackend
+	{
+	public:
+		NullBackend() : m_executed(0) {}
+
+		virtual void Execute(const CommandList& commands) override;
+
+		// Commands decoded since the backend was made.
+		uint64_t Executed() const                   { return m_executed; }
+
+	private:
+		uint64_t m_executed;
+	};
+
+	struct RenderStats
+	{
+		uint32_t commands;
+		uint32_t draws;             // Instanced draws count once.
+		uint32_t instances;         // Instances drawn by instanced draws.
+		uint32_t triangles;
+		uint32_t shaderChanges;
+		uint32_t textureChanges;
+		uint32_t meshChanges;
+		uint32_t redundantChanges;  // Bindings of the shaders, texture or mesh already bound.
+		uint32_t constantUploads;
+		uint32_t constantBytes;
+		uint32_t instanceBytes;
+		uint64_t drawHash;          // The sum of a hash of each draw and everything bound for it.
+
+		uint32_t StateChanges() const               { return shaderChanges + textureChanges + meshChanges; }
+	};
+
+	class RecordingBackend : public RenderBackend
+	{
+	public:
+		RecordingBackend();
+
+		virtual void Execute(const CommandList& commands) override;
+
+		// What the last list executed did, and a copy of it.
+		const RenderStats& Stats() const            { return m_stats; }
+		const CommandList& Recorded() const         { return m_recorded; }
+
+	private:
+		RenderStats m_stats;
+		CommandList m_recorded;
+	};
+}
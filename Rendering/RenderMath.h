@@ -0,0 +1,131 @@
+#pragma once
+
+// RenderMath:
+// The few matrix functions the portable renderer needs, on the simulation's
+// Float3 and Float4x4 types.  Each mirrors the DirectXMath function of the same
+// name, row vectors and left handed coordinates included, so a matrix built here
+// has the same values the game builds with DirectXMath.
+
+#include "../Simulation/SimMath.h"
+
+#include <cmath>
+
+namespace Rendering
+{
+	using Simulation::Float3;
+	using Simulation::Float4x4;
+
+	struct Float2
+	{
+		float x;
+		float y;
+	};
+
+	struct Float4
+	{
+		float x;
+		float y;
+		float z;
+		float w;
+	};
+
+	inline Float2 MakeFloat2(float x, float y)
+	{
+		Float2 result = { x, y };
+		return result;
+	}
+
+	inline Float4 MakeFloat4(float x, float y, float z, float w)
+	{
+		Float4 result = { x, y, z, w };
+		return result;
+	}
+
+	inline Float4x4 MatrixMultiply(const Float4x4& a, const Float4x4& b)
+	{
+		Float4x4 result;
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				result.m[row][column] =
+					a.m[row][0] * b.m[0][column] +
+					a.m[row][1] * b.m[1][column] +
+					a.m[row][2] * b.m[2][column] +
+					a.m[row][3] * b.m[3][column];
+			}
+		}
+		return result;
+	}
+
+	inline Float4x4 MatrixTranspose(const Float4x4& a)
+	{
+		Float4x4 result;
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				result.m[row][column] = a.m[column][row];
+			}
+		}
+		return result;
+	}
+
+	inline Float4x4 MatrixScaling(float x, float y, float z)
+	{
+		Float4x4 result = Simulation::Float4x4Identity();
+		result.m[0][0] = x;
+		result.m[1][1] = y;
+		result.m[2][2] = z;
+		return result;
+	}
+
+	inline Float4x4 MatrixTranslation(float x, float y, float z)
+	{
+		Float4x4 result = Simulation::Float4x4Identity();
+		result.m[3][0] = x;
+		result.m[3][1] = y;
+		result.m[3][2] = z;
+		return result;
+	}
+
+	inline Float4x4 MatrixRotationX(float angle)
+	{
+		float sine = std::sin(angle);
+		float cosine = std::cos(angle);
+		Float4x4 result = Simulation::Float4x4Identity();
+		result.m[1][1] = cosine;
+		result.m[1][2] = sine;
+		result.m[2][1] = -sine;
+		result.m[2][2] = cosine;
+		return result;
+	}
+
+	inline Float4x4 MatrixLookAtLH(Float3 eye, Float3 focus, Float3 up)
+	{
+		Float3 zAxis = Simulation::Normalize(focus - eye);
+		Float3 xAxis = Simulation::Normalize(Simulation::Cross(up, zAxis));
+		Float3 yAxis = Simulation::Cross(zAxis, xAxis);
+		Float4x4 result = { {
+			{ xAxis.x, yAxis.x, zAxis.x, 0.0f },
+			{ xAxis.y, yAxis.y, zAxis.y, 0.0f },
+			{ xAxis.z, yAxis.z, zAxis.z, 0.0f },
+			{ -Simulation::Dot(xAxis, eye), -Simulation::Dot(yAxis, eye), -Simulation::Dot(zAxis, eye), 1.0f },
+		} };
+		return result;
+	}
+
+	inline Float4x4 MatrixPerspectiveFovLH(float fieldOfView, float aspectRatio, float nearPlane, float farPlane)
+	{
+		float height = 1.0f / std::tan(fieldOfView * 0.5f);
+		float width = height / aspectRatio;
+		float range = farPlane / (farPlane - nearPlane);
+		Float4x4 result = { {
+			{ width, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, height, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, range, 1.0f },
+			{ 0.0f, 0.0f, -range * nearPlane, 0.0f },
+		} };
+		return result;
+	}
+}
@@ -0,0 +1,219 @@
+#include "SceneCommands.h"
+
+#include <cmath>
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+namespace
+{
+	// The view space depth of a model's origin.  'view' is stored transposed, as the
+	// shaders read it, so its third row is the view matrix's third column.
+	float ViewDepth(const Float4x4& view, const Float4x4& transform)
+	{
+		return
+			transform.m[3][0] * view.m[2][0] +
+			transform.m[3][1] * view.m[2][1] +
+			transform.m[3][2] * view.m[2][2] +
+			view.m[2][3];
+	}
+}
+
+//----------------------------------------------------------------------
+
+void Rendering::SceneBoundingSpheres(
+	const Simulation::Float4x4* transforms,
+	const Simulation::RenderHandle* handles,
+	uint32_t count,
+	const SceneResources& resources,
+	float* centerX,
+	float* centerY,
+	float* centerZ,
+	float* radius)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const Float4x4& transform = transforms[i];
+		centerX[i] = transform.m[3][0];
+		centerY[i] = transform.m[3][1];
+		centerZ[i] = transform.m[3][2];
+
+		if (handles[i].mesh == Simulation::NoRenderResource)
+		{
+			radius[i] = 0.0f;
+			continue;
+		}
+		float scaleSquared = 0.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float* row = transform.m[axis];
+			float lengthSquared = row[0] * row[0] + row[1] * row[1] + row[2] * row[2];
+			if (lengthSquared > scaleSquared)
+			{
+				scaleSquared = lengthSquared;
+			}
+		}
+		radius[i] = resources.meshes[handles[i].mesh].boundingRadius * sqrtf(scaleSquared);
+	}
+}
+
+//----------------------------------------------------------------------
+
+SceneRecorder::SceneRecorder(const SceneRecorderSettings& settings) :
+	m_settings(settings)
+{
+}
+
+//----------------------------------------------------------------------
+
+void SceneRecorder::Record(
+	const Simulation::Float4x4* transforms,
+	const Simulation::RenderHandle* handles,
+	uint32_t count,
+	const ConstantBufferChangesEveryFrame& frame,
+	const SceneResources& resources,
+	CommandList* commands,
+	const uint32_t* visible)
+{
+	commands->UploadConstants(ConstantSlot::ChangesEveryFrame, frame);
+
+	if (m_settings.instanceDraws)
+	{
+		RecordInstanced(transforms, handles, count, resources, commands, visible);
+		return;
+	}
+
+	m_packets.clear();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t entity = (visible != nullptr) ? visible[i] : i;
+		Simulation::RenderHandle handle = handles[entity];
+		if ((handle.mesh == Simulation::NoRenderResource) || (handle.material == Simulation::NoRenderResource))
+		{
+			continue;
+		}
+
+		DrawPacket packet = { 0, entity };
+		if (m_settings.sortDraws)
+		{
+			const RenderMaterial& material = resources.materials[handle.material];
+			packet.key = MakeSortKey(
+				RenderPass::Opaque,
+				material.vertexShader,
+				material.pixelShader,
+				material.texture,
+				resources.meshes[handle.mesh].mesh,
+				ViewDepth(frame.view, transforms[entity]));
+		}
+		m_packets.push_back(packet);
+	}
+
+	if (m_settings.sortDraws)
+	{
+		SortDrawPackets(m_packets, m_scratch);
+	}
+
+	// What the previous draw left bound; nothing is bound at the start of a list.
+	ResourceId vertexShader = NoResource;
+	ResourceId pixelShader = NoResource;
+	ResourceId texture = NoResource;
+	ResourceId boundMesh = NoResource;
+	bool skip = m_settings.skipRedundantState;
+	for (const DrawPacket& packet : m_packets)
+	{
+		Simulation::RenderHandle handle = handles[packet.entity];
+		const RenderMaterial& material = resources.materials[handle.material];
+		const RenderMesh& mesh = resources.meshes[handle.mesh];
+
+		ConstantBufferChangesEveryPrim constants;
+		constants.worldMatrix = MatrixTranspose(transforms[packet.entity]);
+		RenderSetup(material.parameters, &constants);
+
+		if (!skip || material.vertexShader != vertexShader || material.pixelShader != pixelShader)
+		{
+			commands->SetShaders(material.vertexShader, material.pixelShader);
+			vertexShader = material.vertexShader;
+			pixelShader = material.pixelShader;
+		}
+		if (!skip || material.texture != texture)
+		{
+			commands->SetTexture(material.texture);
+			texture = material.texture;
+		}
+		commands->UploadConstants(ConstantSlot::ChangesEveryPrim, constants);
+		if (!skip || mesh.mesh != boundMesh)
+		{
+			commands->SetMesh(mesh.mesh);
+			boundMesh = mesh.mesh;
+		}
+		commands->DrawIndexed(mesh.indexCount, 0);
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SceneRecorder::RecordInstanced(
+	const Simulation::Float4x4* transforms,
+	const Simulation::RenderHandle* handles,
+	uint32_t count,
+	const SceneResources& resources,
+	CommandList* commands,
+	const uint32_t* visible)
+{
+	m_tints.resize(resources.materialCount);
+	for (uint32_t material = 0; material < resources.materialCount; material++)
+	{
+		m_tints[material] = resources.materials[material].parameters.diffuseColor;
+	}
+
+	m_instances.Count(handles, count, resources.materialCount, resources.meshCount, visible);
+	if (m_instances.InstanceCount() == 0)
+	{
+		return;
+	}
+	m_instances.Build(transforms, handles, count, m_tints.data(), commands->UploadInstances(m_instances.InstanceCount()), visible);
+
+	ResourceId vertexShader = NoResource;
+	ResourceId pixelShader = NoResource;
+	ResourceId texture = NoResource;
+	ResourceId boundMesh = NoResource;
+	uint32_t boundMaterial = Simulation::NoRenderResource;
+	bool skip = m_settings.skipRedundantState;
+	for (const InstanceBatch& batch : m_instances.Batches())
+	{
+		const RenderMaterial& material = resources.materials[batch.material];
+		const RenderMesh& mesh = resources.meshes[batch.mesh];
+
+		if (!skip || material.instancedVertexShader != vertexShader || material.instancedPixelShader != pixelShader)
+		{
+			commands->SetShaders(material.instancedVertexShader, material.instancedPixelShader);
+			vertexShader = material.instancedVertexShader;
+			pixelShader = material.instancedPixelShader;
+		}
+		if (!skip || material.texture != texture)
+		{
+			commands->SetTexture(material.texture);
+			texture = material.texture;
+		}
+		// The instanced shaders take the world matrix from the instance, so the
+		// constants only change with the material.
+		if (!skip || batch.material != boundMaterial)
+		{
+			ConstantBufferChangesEveryPrim constants;
+			constants.worldMatrix = Simulation::Float4x4Identity();
+			RenderSetup(material.parameters, &constants);
+			commands->UploadConstants(ConstantSlot::ChangesEveryPrim, constants);
+			boundMaterial = batch.material;
+		}
+		if (!skip || mesh.mesh != boundMesh)
+		{
+			commands->SetMesh(mesh.mesh);
+			boundMesh = mesh.mesh;
+		}
+		commands->SetInstances(batch.firstInstance);
+		commands->DrawIndexedInstanced(mesh.indexCount, batch.instanceCount);
+	}
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,126 @@
+#pragma once
+
+// SceneCommands:
+// Records the game's scene into a CommandList: the view for the frame, then for
+// every entity with a mesh and a material its shaders, texture, per primitive
+// constants, mesh and draw.  GameRenderer records each frame's SceneSnapshot
+// with a SceneRecorder, and SumoBench records arenas of any size the same way.
+//
+// By default the recorder gives each draw a sort key (see DrawPackets.h) and
+// radix sorts the frame's draws, so draws sharing shaders, texture and mesh are
+// submitted together, front to back.  It then binds each of those only when it
+// differs from what the previous draw bound.  With both turned off it records
+// every binding for every entity, in entity order.
+//
+// With instanceDraws, which is also on by default, it instead builds one
+// instance stream for the frame with an InstanceBuilder and draws each batch of
+// entities sharing a mesh and a material with a single instanced draw, using the
+// material's instanced shaders.  Sorting doesn't apply then: the batches are
+// drawn in material order, and their instances in entity order.
+//
+// Given a list of visible entities, such as FrustumCuller makes from the
+// spheres SceneBoundingSpheres() writes, only those entities are recorded.
+//
+// RenderHandle ids index the material and mesh tables in SceneResources; the
+// resource ids inside those entries are the backend's.
+
+#include "../Simulation/EntityStore.h"
+#include "CommandList.h"
+#include "DrawPackets.h"
+#include "InstanceBuilder.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	struct RenderMaterial
+	{
+		MaterialParameters parameters;
+		ResourceId         vertexShader;
+		ResourceId         pixelShader;
+		ResourceId         texture;
+		ResourceId         instancedVertexShader;  // Used for instanced draws of the material.
+		ResourceId         instancedPixelShader;
+	};
+
+	struct RenderMesh
+	{
+		ResourceId mesh;
+		uint32_t   indexCount;
+		float      boundingRadius;  // Around the mesh's origin, in model space.
+	};
+
+	struct SceneResources
+	{
+		const RenderMaterial* materials;    // Indexed by RenderHandle::material.
+		const RenderMesh*     meshes;       // Indexed by RenderHandle::mesh.
+		uint32_t              materialCount;
+		uint32_t              meshCount;
+	};
+
+	struct SceneRecorderSettings
+	{
+		bool sortDraws;             // Order the draws by their sort keys rather than by entity.
+		bool skipRedundantState;    // Bind shaders, textures and meshes only when they change.
+		bool instanceDraws;         // Draw each mesh and material batch with one instanced draw.
+	};
+
+	inline SceneRecorderSettings DefaultSceneRecorderSettings()
+	{
+		SceneRecorderSettings settings = {
+			true,
+			true,
+			true,
+		};
+		return settings;
+	}
+
+	// Bounding spheres of the entities for culling: the origin of each model matrix
+	// and its mesh's bounding radius, scaled by the matrix's largest axis scale.
+	// Entities without a mesh get a radius of 0.
+	void SceneBoundingSpheres(
+		const Simulation::Float4x4* transforms,
+		const Simulation::RenderHandle* handles,
+		uint32_t count,
+		const SceneResources& resources,
+		float* centerX,
+		float* centerY,
+		float* centerZ,
+		float* radius);
+
+	class SceneRecorder
+	{
+	public:
+		explicit SceneRecorder(const SceneRecorderSettings& settings = DefaultSceneRecorderSettings());
+
+		// Append the frame to 'commands'.  'transforms' are the entities' model matrices,
+		// untransposed, as the EntityStore keeps them.  'visible', when given, lists
+		// the entities to record in increasing order and 'count' is its length.
+		void Record(
+			const Simulation::Float4x4* transforms,
+			const Simulation::RenderHandle* handles,
+			uint32_t count,
+			const ConstantBufferChangesEveryFrame& frame,
+			const SceneResources& resources,
+			CommandList* commands,
+			const uint32_t* visible = nullptr);
+
+		const SceneRecorderSettings& Settings() const   { return m_settings; }
+
+	private:
+		void RecordInstanced(
+			const Simulation::Float4x4* transforms,
+			const Simulation::RenderHandle* handles,
+			uint32_t count,
+			const SceneResources& resources,
+			CommandList* commands,
+			const uint32_t* visible);
+
+		SceneRecorderSettings   m_settings;
+		std::vector<DrawPacket> m_packets;
+		std::vector<DrawPacket> m_scratch;
+		InstanceBuilder         m_instances;
+		std::vector<Float4>     m_tints;
+	};
+}
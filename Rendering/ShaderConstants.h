@@ -0,0 +1,123 @@
+#pragma once
+
+// ShaderConstants:
+// Standard C++ twins of the vertex and constant buffer layouts in
+// ConstantBuffers.h, so the software renderer reads the same meshes and constants
+// the game uploads to the GPU.  ConstantBuffers.h checks the layouts still match.
+//
+// As in the game, the matrices are stored transposed, the way the shaders expect
+// them.
+//
+// The lights and materials the game draws with live here too, so the game and the
+// software renderer can't drift apart.
+
+#include "RenderMath.h"
+
+namespace Rendering
+{
+	struct PNTVertex
+	{
+		Float3 position;
+		Float3 normal;
+		Float2 textureCoordinate;
+	};
+
+	struct ConstantBufferNeverChanges
+	{
+		Float4 lightPosition[4];
+		Float4 lightColor;
+	};
+
+	struct ConstantBufferChangeOnResize
+	{
+		Float4x4 projection;
+	};
+
+	struct ConstantBufferChangesEveryFrame
+	{
+		Float4x4 view;
+	};
+
+	struct ConstantBufferChangesEveryPrim
+	{
+		Float4x4 worldMatrix;
+		Float4   meshColor;
+		Float4   diffuseColor;
+		Float4   specularColor;
+		float    specularPower;
+	};
+
+	// One instance of an instanced draw, read from the second vertex stream.  Unlike
+	// the constant buffers the world matrix isn't transposed: the shader builds it
+	// from its four rows.  The tint takes the place of the material's diffuse color.
+	struct InstanceData
+	{
+		Float4x4 world;
+		Float4   tint;
+	};
+
+	// The parts of a material that go into ConstantBufferChangesEveryPrim.
+	struct MaterialParameters
+	{
+		Float4 meshColor;
+		Float4 diffuseColor;
+		Float4 specularColor;
+		float  specularExponent;
+	};
+
+	// Fill in the material's part of the constants for a draw.
+	inline void RenderSetup(const MaterialParameters& material, ConstantBufferChangesEveryPrim* constantBuffer)
+	{
+		constantBuffer->meshColor = material.meshColor;
+		constantBuffer->specularColor = material.specularColor;
+		constantBuffer->specularPower = material.specularExponent;
+		constantBuffer->diffuseColor = material.diffuseColor;
+	}
+
+	inline ConstantBufferNeverChanges GameLights()
+	{
+		ConstantBufferNeverChanges lights = {
+			{
+				{ 3.5f, 2.5f, 5.5f, 1.0f },
+				{ 3.5f, 2.5f, -5.5f, 1.0f },
+				{ -3.5f, 2.5f, -5.5f, 1.0f },
+				{ 3.5f, 2.5f, 5.5f, 1.0f },
+			},
+			{ 0.25f, 0.25f, 0.25f, 1.0f },
+		};
+		return lights;
+	}
+
+	inline MaterialParameters PlayerMaterial()
+	{
+		MaterialParameters material = {
+			{ 0.8f, 0.8f, 0.8f, 0.5f },
+			{ 1.0f, 1.0f, 1.0f, 0.5f },
+			{ 1.0f, 1.0f, 1.0f, 1.0f },
+			15.0f,
+		};
+		return material;
+	}
+
+	inline MaterialParameters EnemyMaterial()
+	{
+		MaterialParameters material = {
+			{ 0.8f, 0.8f, 0.8f, 0.5f },
+			{ 0.65f, 0.65f, 0.6f, 0.5f },
+			{ 1.0f, 1.0f, 1.0f, 1.0f },
+			15.0f,
+		};
+		return material;
+	}
+
+	inline MaterialParameters CylinderMaterial()
+	{
+		MaterialParameters material = {
+			{ 0.8f, 0.8f, 0.8f, 0.5f },
+			{ 0.8f, 0.8f, 0.8f, 0.5f },
+			{ 1.0f, 1.0f, 1.0f, 1.0f },
+			15.0f,
+		};
+		return material;
+	}
+}
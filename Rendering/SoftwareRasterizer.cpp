@@ -0,0 +1,704 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Rendering;
+
+namespace
+{
+	const float SubpixelSteps = 256.0f;
+	const uint32_t VertexGrain = 1024;
+	const uint32_t ChunksPerThread = 4;
+
+	// The offsets of the varyings the pixel shader reads.
+	const uint32_t TextureUV = 0;
+	const uint32_t VertexToEye = 2;
+	const uint32_t Normal = 5;
+	const uint32_t VertexToLight = 8;
+
+	void Run(Simulation::JobSystem* jobs, uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& body)
+	{
+		if (jobs != nullptr)
+		{
+			jobs->ParallelFor(count, grain, body);
+		}
+		else if (count > 0)
+		{
+			body(0, count);
+		}
+	}
+
+	// mul(v, m) in HLSL.  The matrix is stored transposed, as the shaders read it, so
+	// each row of the stored matrix gives one component.
+	void Transform(const float v[4], const Float4x4& m, float result[4])
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			result[c] = v[0] * m.m[c][0] + v[1] * m.m[c][1] + v[2] * m.m[c][2] + v[3] * m.m[c][3];
+		}
+	}
+
+	// mul(v, (float3x3)m) in HLSL.
+	void TransformNormal(const float v[3], const Float4x4& m, float result[3])
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			result[c] = v[0] * m.m[c][0] + v[1] * m.m[c][1] + v[2] * m.m[c][2];
+		}
+	}
+
+	float Dot3(const float* a, const float* b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	void Normalize3(float* v)
+	{
+		float scale = 1.0f / std::sqrt(Dot3(v, v));
+		v[0] *= scale;
+		v[1] *= scale;
+		v[2] *= scale;
+	}
+
+	uint32_t Wrap(float texel, uint32_t size)
+	{
+		int64_t wrapped = static_cast<int64_t>(texel) % static_cast<int64_t>(size);
+		return static_cast<uint32_t>(wrapped < 0 ? wrapped + size : wrapped);
+	}
+
+	// The game's sampler: bilinear filtering, with the coordinates wrapped.
+	void SampleLinear(const Texture& texture, float u, float v, float result[4])
+	{
+		float x = u * texture.Width() - 0.5f;
+		float y = v * texture.Height() - 0.5f;
+		if (!(std::fabs(x) < 16777216.0f) || !(std::fabs(y) < 16777216.0f))
+		{
+			x = 0.0f;
+			y = 0.0f;
+		}
+		float left = std::floor(x);
+		float top = std::floor(y);
+		float tx = x - left;
+		float ty = y - top;
+		uint32_t x0 = Wrap(left, texture.Width());
+		uint32_t x1 = (x0 + 1 == texture.Width()) ? 0 : x0 + 1;
+		uint32_t y0 = Wrap(top, texture.Height());
+		uint32_t y1 = (y0 + 1 == texture.Height()) ? 0 : y0 + 1;
+
+		const float* texels = texture.Texels();
+		const float* t00 = texels + (static_cast<size_t>(y0) * texture.Width() + x0) * 4;
+		const float* t10 = texels + (static_cast<size_t>(y0) * texture.Width() + x1) * 4;
+		const float* t01 = texels + (static_cast<size_t>(y1) * texture.Width() + x0) * 4;
+		const float* t11 = texels + (static_cast<size_t>(y1) * texture.Width() + x1) * 4;
+		for (int c = 0; c < 4; c++)
+		{
+			float upper = t00[c] + (t10[c] - t00[c]) * tx;
+			float lower = t01[c] + (t11[c] - t01[c]) * tx;
+			result[c] = upper + (lower - upper) * ty;
+		}
+	}
+
+	float Snap(float value)
+	{
+		return std::floor(value * SubpixelSteps + 0.5f) / SubpixelSteps;
+	}
+}
+
+//----------------------------------------------------------------------
+
+SoftwareRasterizer::SoftwareRasterizer(const RasterizerSettings& settings) :
+	m_settings(settings),
+	m_jobs(nullptr),
+	m_neverChanges(),
+	m_changeOnResize(),
+	m_changesEveryFrame(),
+	m_target(nullptr),
+	m_clearColor(0),
+	m_tilesX(0),
+	m_tilesY(0),
+	m_chunkCount(0),
+	m_stats()
+{
+	m_settings.tileSize = std::max(4u, m_settings.tileSize & ~3u);
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::Begin(FrameBuffer* target, Float4 clearColor)
+{
+	m_target = target;
+	m_clearColor = PackColor(clearColor.x, clearColor.y, clearColor.z, clearColor.w);
+	m_draws.clear();
+	m_stats = RasterizerStats();
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::Draw(const MeshData& mesh, const Texture& texture, const ConstantBufferChangesEveryPrim& constants)
+{
+	DrawCall draw = { &mesh, &texture, constants, 0, 0 };
+	m_draws.push_back(draw);
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::End()
+{
+	if (m_target == nullptr)
+	{
+		return;
+	}
+
+	uint32_t vertexCount = 0;
+	uint32_t triangleCount = 0;
+	for (DrawCall& draw : m_draws)
+	{
+		draw.firstVertex = vertexCount;
+		draw.firstTriangle = triangleCount;
+		vertexCount += static_cast<uint32_t>(draw.mesh->vertices.size());
+		triangleCount += draw.mesh->TriangleCount();
+	}
+	m_stats.draws = static_cast<uint32_t>(m_draws.size());
+	m_stats.triangles = triangleCount;
+
+	// The lights are the same for every vertex: mul(lightPosition[i], view).
+	for (int light = 0; light < 4; light++)
+	{
+		const Float4& position = m_neverChanges.lightPosition[light];
+		float world[4] = { position.x, position.y, position.z, position.w };
+		float view[4];
+		Transform(world, m_changesEveryFrame.view, view);
+		std::copy(view, view + 3, m_lightPositions[light]);
+	}
+
+	m_vertices.resize(vertexCount);
+	Run(m_jobs, vertexCount, VertexGrain, [this](uint32_t begin, uint32_t end)
+	{
+		ShadeVertices(begin, end);
+	});
+
+	// Deal the triangles out in runs, a few for each thread.
+	uint32_t tileSize = m_settings.tileSize;
+	m_tilesX = (m_target->Width() + tileSize - 1) / tileSize;
+	m_tilesY = (m_target->Height() + tileSize - 1) / tileSize;
+	uint32_t threads = (m_jobs != nullptr) ? m_jobs->ThreadCount() : 1;
+	m_chunkCount = std::max(1u, std::min(triangleCount, threads * ChunksPerThread));
+	if (m_chunks.size() < m_chunkCount)
+	{
+		m_chunks.resize(m_chunkCount);
+	}
+	for (uint32_t c = 0; c < m_chunkCount; c++)
+	{
+		Chunk& chunk = m_chunks[c];
+		chunk.begin = static_cast<uint32_t>(static_cast<uint64_t>(triangleCount) * c / m_chunkCount);
+		chunk.end = static_cast<uint32_t>(static_cast<uint64_t>(triangleCount) * (c + 1) / m_chunkCount);
+		chunk.bins.resize(m_tilesX * m_tilesY);
+	}
+	Run(m_jobs, m_chunkCount, 1, [this](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t c = begin; c < end; c++)
+		{
+			SetupChunk(m_chunks[c]);
+		}
+	});
+	for (uint32_t c = 0; c < m_chunkCount; c++)
+	{
+		m_stats.culled += m_chunks[c].stats.culled;
+		m_stats.clipped += m_chunks[c].stats.clipped;
+		m_stats.binned += m_chunks[c].stats.binned;
+	}
+
+	Run(m_jobs, m_tilesX * m_tilesY, 1, [this](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t tile = begin; tile < end; tile++)
+		{
+			RasterizeTile(tile);
+		}
+	});
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::ShadeVertices(uint32_t begin, uint32_t end)
+{
+	// Find the draw the first vertex belongs to; draws without vertices are skipped below.
+	auto draw = std::upper_bound(m_draws.begin(), m_draws.end(), begin, [](uint32_t vertex, const DrawCall& call)
+	{
+		return vertex < call.firstVertex;
+	}) - 1;
+
+	for (uint32_t i = begin; i < end; i++)
+	{
+		while (i >= draw->firstVertex + draw->mesh->vertices.size())
+		{
+			++draw;
+		}
+		const PNTVertex& input = draw->mesh->vertices[i - draw->firstVertex];
+		ShadedVertex& output = m_vertices[i];
+
+		// VertexShader.hlsl.
+		float position[4] = { input.position.x, input.position.y, input.position.z, 1.0f };
+		float world[4];
+		float view[4];
+		Transform(position, draw->constants.worldMatrix, world);
+		Transform(world, m_changesEveryFrame.view, view);
+		Transform(view, m_changeOnResize.projection, output.position);
+
+		float* varyings = output.varyings;
+		varyings[TextureUV] = input.textureCoordinate.x;
+		varyings[TextureUV + 1] = input.textureCoordinate.y;
+
+		float normal[3] = { input.normal.x, input.normal.y, input.normal.z };
+		float worldNormal[3];
+		TransformNormal(normal, draw->constants.worldMatrix, worldNormal);
+		TransformNormal(worldNormal, m_changesEveryFrame.view, varyings + Normal);
+		Normalize3(varyings + Normal);
+
+		float* vertexToEye = varyings + VertexToEye;
+		vertexToEye[0] = -view[0];
+		vertexToEye[1] = -view[1];
+		vertexToEye[2] = -view[2];
+
+		for (int light = 0; light < 4; light++)
+		{
+			float* vertexToLight = varyings + VertexToLight + light * 3;
+			vertexToLight[0] = m_lightPositions[light][0] + vertexToEye[0];
+			vertexToLight[1] = m_lightPositions[light][1] + vertexToEye[1];
+			vertexToLight[2] = m_lightPositions[light][2] + vertexToEye[2];
+			Normalize3(vertexToLight);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::SetupChunk(Chunk& chunk)
+{
+	chunk.triangles.clear();
+	chunk.clippedVertices.clear();
+	chunk.stats = RasterizerStats();
+	for (std::vector<uint32_t>& bin : chunk.bins)
+	{
+		bin.clear();
+	}
+	if (chunk.begin == chunk.end)
+	{
+		return;
+	}
+
+	auto draw = std::upper_bound(m_draws.begin(), m_draws.end(), chunk.begin, [](uint32_t triangle, const DrawCall& call)
+	{
+		return triangle < call.firstTriangle;
+	}) - 1;
+
+	for (uint32_t t = chunk.begin; t < chunk.end; t++)
+	{
+		while (t >= draw->firstTriangle + draw->mesh->TriangleCount())
+		{
+			++draw;
+		}
+		const uint16_t* indices = &draw->mesh->indices[(t - draw->firstTriangle) * 3];
+		const ShadedVertex* vertices[3] = {
+			&m_vertices[draw->firstVertex + indices[0]],
+			&m_vertices[draw->firstVertex + indices[1]],
+			&m_vertices[draw->firstVertex + indices[2]],
+		};
+		uint32_t drawIndex = static_cast<uint32_t>(draw - m_draws.begin());
+
+		// Which side of each clip plane the vertices are outside of.  A triangle with
+		// every vertex outside the same plane can't be seen.
+		uint32_t outside[3];
+		for (int k = 0; k < 3; k++)
+		{
+			const float* p = vertices[k]->position;
+			outside[k] =
+				((p[0] < -p[3]) ? 1 : 0) | ((p[0] > p[3]) ? 2 : 0) |
+				((p[1] < -p[3]) ? 4 : 0) | ((p[1] > p[3]) ? 8 : 0) |
+				((p[2] < 0.0f) ? 16 : 0) | ((p[2] > p[3]) ? 32 : 0);
+		}
+		if ((outside[0] & outside[1] & outside[2]) != 0)
+		{
+			chunk.stats.culled++;
+			continue;
+		}
+		if (((outside[0] | outside[1] | outside[2]) & 16) == 0)
+		{
+			SetupTriangle(chunk, drawIndex, vertices[0], vertices[1], vertices[2]);
+			continue;
+		}
+
+		// Clip against the near plane, z = 0, leaving a triangle or a quad.  The other
+		// planes aren't clipped; the tiles' bounds keep the pixels on screen.
+		chunk.stats.clipped++;
+		ShadedVertex polygon[4];
+		uint32_t count = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			const ShadedVertex& a = *vertices[k];
+			const ShadedVertex& b = *vertices[(k + 1) % 3];
+			float da = a.position[2];
+			float db = b.position[2];
+			if (da >= 0.0f)
+			{
+				polygon[count++] = a;
+			}
+			if ((da >= 0.0f) != (db >= 0.0f))
+			{
+				float s = da / (da - db);
+				ShadedVertex& cut = polygon[count++];
+				for (int c = 0; c < 4; c++)
+				{
+					cut.position[c] = a.position[c] + (b.position[c] - a.position[c]) * s;
+				}
+				for (uint32_t c = 0; c < VaryingCount; c++)
+				{
+					cut.varyings[c] = a.varyings[c] + (b.varyings[c] - a.varyings[c]) * s;
+				}
+			}
+		}
+		size_t first = chunk.clippedVertices.size();
+		chunk.clippedVertices.insert(chunk.clippedVertices.end(), polygon, polygon + count);
+		for (uint32_t k = 1; k + 1 < count; k++)
+		{
+			SetupTriangle(chunk, drawIndex, &chunk.clippedVertices[first], &chunk.clippedVertices[first + k], &chunk.clippedVertices[first + k + 1]);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::SetupTriangle(Chunk& chunk, uint32_t draw, const ShadedVertex* a, const ShadedVertex* b, const ShadedVertex* c)
+{
+	Triangle triangle;
+	triangle.vertices[0] = a;
+	triangle.vertices[1] = b;
+	triangle.vertices[2] = c;
+	triangle.draw = draw;
+
+	// To the screen, with y down, snapped to the subpixel grid.
+	float width = static_cast<float>(m_target->Width());
+	float height = static_cast<float>(m_target->Height());
+	float x[3];
+	float y[3];
+	float z[3];
+	for (int k = 0; k < 3; k++)
+	{
+		const float* p = triangle.vertices[k]->position;
+		float inverseW = 1.0f / p[3];
+		x[k] = Snap((p[0] * inverseW * 0.5f + 0.5f) * width);
+		y[k] = Snap((0.5f - p[1] * inverseW * 0.5f) * height);
+		z[k] = p[2] * inverseW;
+		triangle.inverseW[k] = inverseW;
+	}
+
+	// Clockwise triangles face the camera; the game culls the others.
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+	if (!(area > 0.0f))
+	{
+		chunk.stats.culled++;
+		return;
+	}
+
+	// The pixel centers the triangle's bounds can cover, on screen.
+	float left = std::max(std::min(x[0], std::min(x[1], x[2])) - 0.5f, 0.0f);
+	float right = std::min(std::max(x[0], std::max(x[1], x[2])) - 0.5f, width - 1.0f);
+	float top = std::max(std::min(y[0], std::min(y[1], y[2])) - 0.5f, 0.0f);
+	float bottom = std::min(std::max(y[0], std::max(y[1], y[2])) - 0.5f, height - 1.0f);
+	if (!(left <= right) || !(top <= bottom))
+	{
+		chunk.stats.culled++;
+		return;
+	}
+	triangle.minX = static_cast<int32_t>(std::ceil(left));
+	triangle.maxX = static_cast<int32_t>(std::floor(right));
+	triangle.minY = static_cast<int32_t>(std::ceil(top));
+	triangle.maxY = static_cast<int32_t>(std::floor(bottom));
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+	{
+		chunk.stats.culled++;
+		return;
+	}
+
+	// Edge k runs from vertex k + 1 to vertex k + 2.  Each edge is measured from the
+	// same end whichever triangle it belongs to, so two triangles sharing an edge get
+	// exactly opposite values along it and the fill rule leaves no gaps or overlaps.
+	triangle.topLeft = 0;
+	for (int k = 0; k < 3; k++)
+	{
+		int i = (k + 1) % 3;
+		int j = (k + 2) % 3;
+		triangle.edgeA[k] = y[i] - y[j];
+		triangle.edgeB[k] = x[j] - x[i];
+		bool fromI = (x[i] < x[j]) || (x[i] == x[j] && y[i] < y[j]);
+		triangle.baseX[k] = fromI ? x[i] : x[j];
+		triangle.baseY[k] = fromI ? y[i] : y[j];
+		if (triangle.edgeA[k] > 0.0f || (triangle.edgeA[k] == 0.0f && triangle.edgeB[k] > 0.0f))
+		{
+			triangle.topLeft |= 1u << k;
+		}
+	}
+	triangle.depth = z[0];
+	triangle.depthStep1 = z[1] - z[0];
+	triangle.depthStep2 = z[2] - z[0];
+	triangle.inverseArea = 1.0f / area;
+
+	uint32_t index = static_cast<uint32_t>(chunk.triangles.size());
+	chunk.triangles.push_back(triangle);
+	uint32_t tileSize = m_settings.tileSize;
+	for (uint32_t tileY = triangle.minY / tileSize; tileY <= triangle.maxY / tileSize; tileY++)
+	{
+		for (uint32_t tileX = triangle.minX / tileSize; tileX <= triangle.maxX / tileSize; tileX++)
+		{
+			chunk.bins[tileY * m_tilesX + tileX].push_back(index);
+			chunk.stats.binned++;
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::RasterizeTile(uint32_t tile)
+{
+	int32_t tileSize = static_cast<int32_t>(m_settings.tileSize);
+	int32_t x0 = static_cast<int32_t>(tile % m_tilesX) * tileSize;
+	int32_t y0 = static_cast<int32_t>(tile / m_tilesX) * tileSize;
+	int32_t x1 = std::min(x0 + tileSize, static_cast<int32_t>(m_target->Width()));
+	int32_t y1 = std::min(y0 + tileSize, static_cast<int32_t>(m_target->Height()));
+
+	uint32_t stride = m_target->Stride();
+	for (int32_t y = y0; y < y1; y++)
+	{
+		std::fill(m_target->Colors() + y * stride + x0, m_target->Colors() + y * stride + x1, m_clearColor);
+		std::fill(m_target->Depths() + y * stride + x0, m_target->Depths() + y * stride + x1, 1.0f);
+	}
+
+	// First find the triangle each pixel ends up showing, then shade each pixel once.
+	// With no blending, the last triangle to pass the depth test is the one a GPU's
+	// final color comes from, so the image is the same as shading every pass.
+	std::vector<const Triangle*> visible(m_settings.tileSize * m_settings.tileSize, nullptr);
+	for (uint32_t c = 0; c < m_chunkCount; c++)
+	{
+		const Chunk& chunk = m_chunks[c];
+		for (uint32_t index : chunk.bins[tile])
+		{
+			RasterizeTriangle(chunk.triangles[index], x0, y0, x1, y1, visible.data());
+		}
+	}
+
+	for (int32_t y = y0; y < y1; y++)
+	{
+		float py = static_cast<float>(y) + 0.5f;
+		const Triangle* const* row = &visible[(y - y0) * tileSize];
+		uint32_t* colors = m_target->Colors() + y * stride;
+		for (int32_t x = x0; x < x1; x++)
+		{
+			const Triangle* triangle = row[x - x0];
+			if (triangle == nullptr)
+			{
+				continue;
+			}
+			// The same sums the coverage test made, so the same values.
+			float px = static_cast<float>(x) + 0.5f;
+			float edges[3];
+			for (int k = 0; k < 3; k++)
+			{
+				edges[k] = triangle->edgeA[k] * (px - triangle->baseX[k]) + triangle->edgeB[k] * (py - triangle->baseY[k]);
+			}
+			colors[x] = ShadePixel(*triangle, edges[0], edges[1], edges[2]);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SoftwareRasterizer::RasterizeTriangle(const Triangle& triangle, int32_t tileX0, int32_t tileY0, int32_t tileX1, int32_t tileY1, const Triangle** visible)
+{
+	int32_t minX = std::max(triangle.minX, tileX0);
+	int32_t maxX = std::min(triangle.maxX, tileX1 - 1);
+	int32_t minY = std::max(triangle.minY, tileY0);
+	int32_t maxY = std::min(triangle.maxY, tileY1 - 1);
+
+	// Rows are padded to a multiple of four pixels, so a quad never leaves its row.
+	int32_t startX = minX & ~3;
+	uint32_t stride = m_target->Stride();
+	int32_t tileSize = static_cast<int32_t>(m_settings.tileSize);
+	for (int32_t y = minY; y <= maxY; y++)
+	{
+		float py = static_cast<float>(y) + 0.5f;
+		float rowTerms[3];
+		for (int k = 0; k < 3; k++)
+		{
+			rowTerms[k] = triangle.edgeB[k] * (py - triangle.baseY[k]);
+		}
+		float* depths = m_target->Depths() + y * stride;
+		const Triangle** row = visible + (y - tileY0) * tileSize - tileX0;
+
+		for (int32_t x = startX; x <= maxX; x += 4)
+		{
+			uint32_t columns = 0xF;
+			if (x < minX)
+			{
+				columns &= 0xFu << (minX - x);
+			}
+			if (x + 3 > maxX)
+			{
+				columns &= 0xFu >> (x + 3 - maxX);
+			}
+
+			uint32_t covered = m_settings.simd ?
+				CoverQuad(triangle, static_cast<float>(x), rowTerms, columns, depths + x) :
+				CoverQuadScalar(triangle, static_cast<float>(x), rowTerms, columns, depths + x);
+			for (int i = 0; i < 4; i++)
+			{
+				if (covered & (1u << i))
+				{
+					row[x + i] = &triangle;
+				}
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+uint32_t SoftwareRasterizer::ShadePixel(const Triangle& triangle, float edge0, float edge1, float edge2) const
+{
+	// Interpolate the varyings with perspective correction.
+	float p0 = edge0 * triangle.inverseArea * triangle.inverseW[0];
+	float p1 = edge1 * triangle.inverseArea * triangle.inverseW[1];
+	float p2 = edge2 * triangle.inverseArea * triangle.inverseW[2];
+	float scale = 1.0f / (p0 + p1 + p2);
+	p0 *= scale;
+	p1 *= scale;
+	p2 *= scale;
+	const float* a = triangle.vertices[0]->varyings;
+	const float* b = triangle.vertices[1]->varyings;
+	const float* c = triangle.vertices[2]->varyings;
+	float varyings[VaryingCount];
+	for (uint32_t i = 0; i < VaryingCount; i++)
+	{
+		varyings[i] = a[i] * p0 + b[i] * p1 + c[i] * p2;
+	}
+
+	// PixelShader.hlsl.
+	const DrawCall& draw = m_draws[triangle.draw];
+	const float* normal = varyings + Normal;
+	float diffuseLuminance = 0.0f;
+	for (int light = 0; light < 4; light++)
+	{
+		diffuseLuminance += std::max(0.0f, Dot3(normal, varyings + VertexToLight + light * 3));
+	}
+
+	float* vertexToEye = varyings + VertexToEye;
+	Normalize3(vertexToEye);
+
+	float specularLuminance = 0.0f;
+	for (int light = 0; light < 4; light++)
+	{
+		const float* vertexToLight = varyings + VertexToLight + light * 3;
+		float halfway[3] = {
+			vertexToEye[0] + vertexToLight[0],
+			vertexToEye[1] + vertexToLight[1],
+			vertexToEye[2] + vertexToLight[2],
+		};
+		Normalize3(halfway);
+		specularLuminance += std::pow(std::max(0.0f, Dot3(normal, halfway)), draw.constants.specularPower);
+	}
+
+	float texel[4];
+	SampleLinear(*draw.texture, varyings[TextureUV], varyings[TextureUV + 1], texel);
+	const Float4& diffuseColor = draw.constants.diffuseColor;
+	const Float4& specularColor = draw.constants.specularColor;
+	return PackColor(
+		texel[0] * diffuseColor.x * diffuseLuminance * 0.5f + specularColor.x * specularLuminance * 0.5f,
+		texel[1] * diffuseColor.y * diffuseLuminance * 0.5f + specularColor.y * specularLuminance * 0.5f,
+		texel[2] * diffuseColor.z * diffuseLuminance * 0.5f + specularColor.z * specularLuminance * 0.5f,
+		texel[3] * diffuseColor.w * diffuseLuminance * 0.5f + specularColor.w * specularLuminance * 0.5f);
+}
+
+//----------------------------------------------------------------------
+
+uint32_t SoftwareRasterizer::CoverQuadScalar(const Triangle& triangle, float x, const float rowTerms[3], uint32_t columns, float* depths)
+{
+	uint32_t covered = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		float px = x + (static_cast<float>(i) + 0.5f);
+		float edges[3];
+		bool inside = (columns & (1u << i)) != 0;
+		for (int k = 0; k < 3; k++)
+		{
+			float edge = triangle.edgeA[k] * (px - triangle.baseX[k]) + rowTerms[k];
+			edges[k] = edge;
+			bool topLeft = (triangle.topLeft & (1u << k)) != 0;
+			inside = inside && (edge > 0.0f || (edge == 0.0f && topLeft));
+		}
+		if (!inside)
+		{
+			continue;
+		}
+		float depth = triangle.depth +
+			edges[1] * triangle.inverseArea * triangle.depthStep1 +
+			edges[2] * triangle.inverseArea * triangle.depthStep2;
+		if (depth < depths[i])
+		{
+			depths[i] = depth;
+			covered |= 1u << i;
+		}
+	}
+	return covered;
+}
+
+//----------------------------------------------------------------------
+
+#if defined(SUMO_RASTER_SSE2)
+
+uint32_t SoftwareRasterizer::CoverQuad(const Triangle& triangle, float x, const float rowTerms[3], uint32_t columns, float* depths)
+{
+	const __m128 zero = _mm_setzero_ps();
+	__m128 px = _mm_add_ps(_mm_set1_ps(x), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+	__m128 inside = _mm_castsi128_ps(_mm_setr_epi32(
+		-static_cast<int32_t>(columns & 1), -static_cast<int32_t>((columns >> 1) & 1),
+		-static_cast<int32_t>((columns >> 2) & 1), -static_cast<int32_t>((columns >> 3) & 1)));
+
+	__m128 edge[3];
+	for (int k = 0; k < 3; k++)
+	{
+		edge[k] = _mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(triangle.edgeA[k]), _mm_sub_ps(px, _mm_set1_ps(triangle.baseX[k]))),
+			_mm_set1_ps(rowTerms[k]));
+		__m128 onEdge = (triangle.topLeft & (1u << k)) ? _mm_cmpeq_ps(edge[k], zero) : zero;
+		inside = _mm_and_ps(inside, _mm_or_ps(_mm_cmpgt_ps(edge[k], zero), onEdge));
+	}
+	if (_mm_movemask_ps(inside) == 0)
+	{
+		return 0;
+	}
+
+	__m128 inverseArea = _mm_set1_ps(triangle.inverseArea);
+	__m128 depth = _mm_add_ps(
+		_mm_add_ps(_mm_set1_ps(triangle.depth), _mm_mul_ps(_mm_mul_ps(edge[1], inverseArea), _mm_set1_ps(triangle.depthStep1))),
+		_mm_mul_ps(_mm_mul_ps(edge[2], inverseArea), _mm_set1_ps(triangle.depthStep2)));
+	__m128 stored = _mm_loadu_ps(depths);
+	__m128 passed = _mm_and_ps(inside, _mm_cmplt_ps(depth, stored));
+	_mm_storeu_ps(depths, _mm_or_ps(_mm_and_ps(passed, depth), _mm_andnot_ps(passed, stored)));
+	return static_cast<uint32_t>(_mm_movemask_ps(passed));
+}
+
+#else
+
+uint32_t SoftwareRasterizer::CoverQuad(const Triangle& triangle, float x, const float rowTerms[3], uint32_t columns, float* depths)
+{
+	return CoverQuadScalar(triangle, x, rowTerms, columns, depths);
+}
+
+#endif
+
+//----------------------------------------------------------------------
@@ -0,0 +1,186 @@
+#pragma once
+
+// SoftwareRasterizer:
+// Draws the game's meshes on the CPU into a FrameBuffer, reproducing
+// VertexShader.hlsl and PixelShader.hlsl: the four point lights, the diffuse
+// texture through the linear wrapping sampler, and the specular highlights.  It
+// reads the same PNTVertex meshes and constant buffers the game uploads, so a
+// machine with no GPU can render frames of the game for golden image checks and
+// for measuring throughput.
+//
+// Draw() only queues a mesh; End() renders the frame in three passes, each
+// spread over the JobSystem's threads, one per core:
+//     1. Every vertex is run through the vertex shader.
+//     2. The triangles are clipped against the near plane, back faces are culled
+//        as the game's rasterizer state does, and each triangle is binned into
+//        the screen tiles its bounds touch.  Each thread bins its own run of
+//        triangles into its own bins, so no locks are taken.
+//     3. Each tile is cleared and rasterized on its own, reading the bins in
+//        draw order.  The three edge functions and the depth test are evaluated
+//        for four pixels at a time with SSE2 where available, and each pixel
+//        remembers the last triangle to pass.  Once the tile's triangles are
+//        all drawn the pixel shader runs once per pixel, for the triangle it
+//        kept, so pixels covered again later aren't shaded for nothing.
+// Threads never share a tile, and every tile draws its triangles in the order
+// they were submitted, so the image is the same on any number of threads.
+//
+// The rasterizer follows Direct3D's rules: pixel centers at half pixels, the top
+// left fill rule, vertex positions snapped to 1/256 of a pixel, attributes
+// interpolated with perspective correction, and a LESS depth test.  The texture
+// is sampled bilinearly from its top level; the game's textures have no other.
+
+#include "../GameObjects/GameConstants.h"
+#include "../Simulation/JobSystem.h"
+#include "FrameBuffer.h"
+#include "MeshData.h"
+#include "ShaderConstants.h"
+#include "Texture.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace Rendering
+{
+	struct RasterizerSettings
+	{
+		uint32_t tileSize;      // Width and height of the screen tiles, in pixels; a multiple of 4.
+		bool     simd;          // Use the SSE2 edge functions where available, rather than the scalar ones.
+	};
+
+	inline RasterizerSettings DefaultRasterizerSettings()
+	{
+		RasterizerSettings settings = {
+			GameConstants::Raster::TileSize,
+			true,
+		};
+		return settings;
+	}
+
+	struct RasterizerStats
+	{
+		uint32_t draws;
+		uint32_t triangles;     // Submitted.
+		uint32_t culled;        // Back facing, outside the view or too small to cover a pixel center.
+		uint32_t clipped;       // Cut by the near plane.
+		uint32_t binned;        // Triangles added to tiles, counting a triangle once per tile.
+	};
+
+	class SoftwareRasterizer
+	{
+	public:
+		explicit SoftwareRasterizer(const RasterizerSettings& settings = DefaultRasterizerSettings());
+
+		// The threads to render with; without a JobSystem everything runs on the calling thread.
+		void Jobs(Simulation::JobSystem* jobs)      { m_jobs = jobs; }
+
+		// The constant buffers, as the game fills them.  They are kept until changed.
+		void SetConstants(const ConstantBufferNeverChanges& constants) { m_neverChanges = constants; }
+		void SetProjection(const ConstantBufferChangeOnResize& constants) { m_changeOnResize = constants; }
+		void SetView(const ConstantBufferChangesEveryFrame& constants) { m_changesEveryFrame = constants; }
+
+		// Start a frame into 'target', which will be cleared to 'clearColor' and a depth of 1.
+		void Begin(FrameBuffer* target, Float4 clearColor);
+
+		// Queue a mesh to draw with its texture and per primitive constants.  The mesh and
+		// texture aren't copied, so they must stay unchanged until End().
+		void Draw(const MeshData& mesh, const Texture& texture, const ConstantBufferChangesEveryPrim& constants);
+
+		// Render everything queued since Begin() into the target.
+		void End();
+
+		const RasterizerSettings& Settings() const  { return m_settings; }
+		const RasterizerStats& Stats() const        { return m_stats; }
+
+	private:
+		SoftwareRasterizer(const SoftwareRasterizer&);
+		SoftwareRasterizer& operator=(const SoftwareRasterizer&);
+
+		// The outputs of the vertex shader: the clip space position, then the texture
+		// coordinate, vertex to eye, normal and the four vertex to light vectors.
+		static const uint32_t VaryingCount = 20;
+		struct ShadedVertex
+		{
+			float position[4];
+			float varyings[VaryingCount];
+		};
+
+		// A triangle ready to rasterize.  Edge k is opposite vertex k, and its function is
+		// edgeA * (x - baseX) + edgeB * (y - baseY), positive inside.
+		struct Triangle
+		{
+			const ShadedVertex* vertices[3];
+			float    edgeA[3];
+			float    edgeB[3];
+			float    baseX[3];
+			float    baseY[3];
+			uint32_t topLeft;       // Bit k set if edge k is a top or left edge.
+			float    depth;         // Depth at vertex 0, and the steps to vertices 1 and 2.
+			float    depthStep1;
+			float    depthStep2;
+			float    inverseW[3];
+			float    inverseArea;
+			int32_t  minX;
+			int32_t  minY;
+			int32_t  maxX;
+			int32_t  maxY;
+			uint32_t draw;
+		};
+
+		struct DrawCall
+		{
+			const MeshData*                 mesh;
+			const Texture*                  texture;
+			ConstantBufferChangesEveryPrim  constants;
+			uint32_t                        firstVertex;
+			uint32_t                        firstTriangle;
+		};
+
+		// A run of the frame's triangles, set up and binned by one thread.
+		struct Chunk
+		{
+			uint32_t                            begin;
+			uint32_t                            end;
+			std::vector<Triangle>               triangles;
+			std::deque<ShadedVertex>            clippedVertices;    // A deque so the triangles' pointers stay put.
+			std::vector<std::vector<uint32_t>>  bins;               // Triangle indices for each tile.
+			RasterizerStats                     stats;
+		};
+
+		void ShadeVertices(uint32_t begin, uint32_t end);
+		void SetupChunk(Chunk& chunk);
+		void SetupTriangle(Chunk& chunk, uint32_t draw, const ShadedVertex* a, const ShadedVertex* b, const ShadedVertex* c);
+		void RasterizeTile(uint32_t tile);
+		// Depth test the triangle's pixels in a tile, marking the ones it wins in 'visible'.
+		void RasterizeTriangle(const Triangle& triangle, int32_t tileX0, int32_t tileY0, int32_t tileX1, int32_t tileY1, const Triangle** visible);
+		uint32_t ShadePixel(const Triangle& triangle, float edge0, float edge1, float edge2) const;
+
+		// Test the four pixels from 'x' on a row against the triangle's edges and the depth
+		// buffer, and write the depths of those that pass.  'rowTerms' holds each edge's
+		// edgeB * (y - baseY) for the row, and 'columns' a bit for each pixel inside the
+		// triangle's bounds.  Returns a bit for each pixel that passed.  Uses SSE2 where
+		// available.
+		static uint32_t CoverQuad(const Triangle& triangle, float x, const float rowTerms[3], uint32_t columns, float* depths);
+		// Always uses the scalar kernel, for comparison.
+		static uint32_t CoverQuadScalar(const Triangle& triangle, float x, const float rowTerms[3], uint32_t columns, float* depths);
+
+		RasterizerSettings              m_settings;
+		Simulation::JobSystem*          m_jobs;
+
+		ConstantBufferNeverChanges      m_neverChanges;
+		ConstantBufferChangeOnResize    m_changeOnResize;
+		ConstantBufferChangesEveryFrame m_changesEveryFrame;
+		float                           m_lightPositions[4][3];     // In view space, for this frame.
+
+		FrameBuffer*                    m_target;
+		uint32_t                        m_clearColor;
+		uint32_t                        m_tilesX;
+		uint32_t                        m_tilesY;
+
+		std::vector<DrawCall>           m_draws;
+		std::vector<ShadedVertex>       m_vertices;
+		std::vector<Chunk>              m_chunks;
+		uint32_t                        m_chunkCount;               // Chunks in use this frame.
+		RasterizerStats                 m_stats;
+	};
+}
@@ -0,0 +1,125 @@
+#include "Texture.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+namespace
+{
+	const uint32_t HeaderSize = 124;
+	const uint32_t PixelFormatRGB = 0x40;
+	const uint32_t PixelFormatAlphaPixels = 0x1;
+
+	uint32_t ReadUInt(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+			(static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	// Where a channel's mask sits in a texel, and what it reads at full intensity.
+	struct Channel
+	{
+		uint32_t mask;
+		uint32_t shift;
+		float    scale;
+	};
+
+	Channel MakeChannel(uint32_t mask)
+	{
+		Channel channel = { mask, 0, 0.0f };
+		if (mask != 0)
+		{
+			while (((mask >> channel.shift) & 1) == 0)
+			{
+				channel.shift++;
+			}
+			channel.scale = 1.0f / static_cast<float>(mask >> channel.shift);
+		}
+		return channel;
+	}
+
+	float ReadChannel(uint32_t texel, const Channel& channel, float missing)
+	{
+		if (channel.mask == 0)
+		{
+			return missing;
+		}
+		return static_cast<float>((texel & channel.mask) >> channel.shift) * channel.scale;
+	}
+}
+
+//----------------------------------------------------------------------
+
+Texture::Texture() :
+	m_width(0),
+	m_height(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+bool Texture::Deserialize(const uint8_t* data, size_t size)
+{
+	if (size < 4 + HeaderSize || memcmp(data, "DDS ", 4) != 0)
+	{
+		return false;
+	}
+
+	const uint8_t* header = data + 4;
+	uint32_t height = ReadUInt(header + 8);
+	uint32_t width = ReadUInt(header + 12);
+	const uint8_t* pixelFormat = header + 72;
+	uint32_t formatFlags = ReadUInt(pixelFormat + 4);
+	uint32_t bitCount = ReadUInt(pixelFormat + 12);
+	if (ReadUInt(header) != HeaderSize || (formatFlags & PixelFormatRGB) == 0 || bitCount != 32 ||
+		width == 0 || height == 0 || (size - 4 - HeaderSize) / 4 / width < height)
+	{
+		return false;
+	}
+
+	Channel red = MakeChannel(ReadUInt(pixelFormat + 16));
+	Channel green = MakeChannel(ReadUInt(pixelFormat + 20));
+	Channel blue = MakeChannel(ReadUInt(pixelFormat + 24));
+	Channel alpha = MakeChannel((formatFlags & PixelFormatAlphaPixels) ? ReadUInt(pixelFormat + 28) : 0);
+
+	const uint8_t* source = data + 4 + HeaderSize;
+	m_texels.resize(static_cast<size_t>(width) * height * 4);
+	for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+	{
+		uint32_t texel = ReadUInt(source + i * 4);
+		m_texels[i * 4] = ReadChannel(texel, red, 0.0f);
+		m_texels[i * 4 + 1] = ReadChannel(texel, green, 0.0f);
+		m_texels[i * 4 + 2] = ReadChannel(texel, blue, 0.0f);
+		m_texels[i * 4 + 3] = ReadChannel(texel, alpha, 1.0f);
+	}
+	m_width = width;
+	m_height = height;
+	return true;
+}
+
+//----------------------------------------------------------------------
+
+bool Texture::Load(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+	uint8_t buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		data.insert(data.end(), buffer, buffer + read);
+	}
+	fclose(file);
+
+	return Deserialize(data.data(), data.size());
+}
+
+//----------------------------------------------------------------------
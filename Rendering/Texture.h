@@ -0,0 +1,38 @@
+#pragma once
+
+// Texture:
+// The top level of a DDS texture, held as float RGBA texels for the software
+// renderer to sample.  Only uncompressed 32 bit textures can be read, with the
+// channels in any order (SumoBlue.dds and SumoRed.dds are BGRA, metal_texture.dds
+// is RGBA), which covers every texture the game draws its meshes with.  Block
+// compressed textures and the lower mip levels are not read; the renderer only
+// samples the top level.
+//
+// Like DDSTextureLoader, the channels are read as linear UNORM values.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	class Texture
+	{
+	public:
+		Texture();
+
+		// Parse a DDS file.  False if it is malformed or in a format that isn't supported.
+		bool Deserialize(const uint8_t* data, size_t size);
+		bool Load(const char* path);
+
+		uint32_t Width() const                      { return m_width; }
+		uint32_t Height() const                     { return m_height; }
+		// Four floats, red, green, blue and alpha, per texel, in rows from the top.
+		const float* Texels() const                 { return m_texels.data(); }
+
+	private:
+		std::vector<float> m_texels;
+		uint32_t           m_width;
+		uint32_t           m_height;
+	};
+}
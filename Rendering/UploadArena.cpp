@@ -0,0 +1,110 @@
+#include "UploadArena.h"
+
+#include <cassert>
+
+using namespace Rendering;
+
+//----------------------------------------------------------------------
+
+UploadArena::UploadArena(const UploadArenaSettings& settings) :
+	m_settings(settings),
+	m_head(0),
+	m_tail(0),
+	m_used(0),
+	m_frame(0),
+	m_frameBytes(0),
+	m_frames(settings.framesInFlight),
+	m_oldestFrame(0),
+	m_frameCount(0)
+{
+	assert((settings.alignment & (settings.alignment - 1)) == 0);
+	assert(settings.capacity % settings.alignment == 0);
+	assert(settings.framesInFlight > 0);
+}
+
+//----------------------------------------------------------------------
+
+void UploadArena::BeginFrame(uint64_t frame)
+{
+	m_frame = frame;
+	m_frameBytes = 0;
+}
+
+//----------------------------------------------------------------------
+
+void UploadArena::EndFrame()
+{
+	// The caller waits while MustWait(), so there is always an entry free here.
+	assert(m_frameCount < m_settings.framesInFlight);
+	FrameMark mark = { m_frame, m_head, m_frameBytes };
+	m_frames[(m_oldestFrame + m_frameCount) % m_settings.framesInFlight] = mark;
+	m_frameCount++;
+	m_frameBytes = 0;
+}
+
+//----------------------------------------------------------------------
+
+uint32_t UploadArena::Allocate(uint32_t size)
+{
+	uint32_t alignment = m_settings.alignment;
+	uint32_t capacity = m_settings.capacity;
+	size = (size + alignment - 1) & ~(alignment - 1);
+	if (size > capacity)
+	{
+		return NoSpace;
+	}
+
+	// With nothing held, start again at the beginning for the most room.
+	if (m_used == 0)
+	{
+		m_head = 0;
+		m_tail = 0;
+	}
+
+	uint32_t offset = m_head;
+	uint32_t padding = 0;
+	if (m_used == 0 || m_head > m_tail)
+	{
+		// Free space runs from the head to the end, then from the beginning to the tail.
+		if (capacity - m_head < size)
+		{
+			if (size > m_tail && m_used != 0)
+			{
+				return NoSpace;
+			}
+			padding = capacity - m_head;
+			offset = 0;
+		}
+	}
+	else if (m_tail - m_head < size)
+	{
+		// The head has wrapped around behind the tail, or the ring is full.
+		return NoSpace;
+	}
+
+	m_head = offset + size;
+	m_used += padding + size;
+	m_frameBytes += padding + size;
+	return offset;
+}
+
+//----------------------------------------------------------------------
+
+void UploadArena::Retire(uint64_t completedFrame)
+{
+	while (m_frameCount > 0 && m_frames[m_oldestFrame].frame <= completedFrame)
+	{
+		// A frame that allocated nothing holds no memory, and its end may be from
+		// before the ring emptied and started again at the beginning.
+		const FrameMark& mark = m_frames[m_oldestFrame];
+		if (mark.bytes != 0)
+		{
+			m_tail = mark.end;
+		}
+		m_used -= mark.bytes;
+		m_oldestFrame = (m_oldestFrame + 1) % m_settings.framesInFlight;
+		m_frameCount--;
+	}
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,90 @@
+#pragma once
+
+// UploadArena:
+// Hands out space in a ring of upload memory a frame at a time, for constants
+// the CPU writes and the GPU reads some frames later.  Every allocation of a
+// frame comes straight after the one before it, rounded up to the alignment
+// (256 bytes, the granularity Direct3D 11.1 binds constant buffer ranges at),
+// so a frame's constants are one contiguous run that can be written through a
+// single mapping and bound by offset.
+//
+// The arena only does the bookkeeping; it never touches the memory, so it runs
+// and can be measured anywhere.  The caller brackets each frame's allocations
+// with BeginFrame() and EndFrame(), signals a fence at the end of the frame,
+// and Retire()s frames as their fences complete, which frees their memory for
+// reuse.  At most 'framesInFlight' frames may hold memory at once, and their
+// marks are kept in a ring of that many entries: when FramesInFlight() reaches
+// it, the caller must wait for the fence of OldestFrame() and retire it before
+// beginning another frame, and likewise when an allocation finds no room.
+//
+// An allocation never wraps around the end of the ring.  When it doesn't fit
+// before the end, the rest of the ring is given to the frame as padding and the
+// allocation starts again at the beginning.
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering
+{
+	struct UploadArenaSettings
+	{
+		uint32_t capacity;          // Bytes; a multiple of the alignment.
+		uint32_t alignment;         // A power of two.
+		uint32_t framesInFlight;    // Frames whose memory the GPU may still be reading.
+	};
+
+	inline UploadArenaSettings DefaultUploadArenaSettings()
+	{
+		UploadArenaSettings settings = {
+			4 * 1024 * 1024,
+			256,
+			3,
+		};
+		return settings;
+	}
+
+	class UploadArena
+	{
+	public:
+		static const uint32_t NoSpace = 0xffffffff;
+
+		explicit UploadArena(const UploadArenaSettings& settings = DefaultUploadArenaSettings());
+
+		// Frames are numbered by the caller and must increase.
+		void BeginFrame(uint64_t frame);
+		void EndFrame();
+
+		// The offset of 'size' bytes for the frame being recorded, or NoSpace if the
+		// frames in flight leave no room for them.
+		uint32_t Allocate(uint32_t size);
+
+		// Free the memory of every ended frame up to and including 'completedFrame'.
+		void Retire(uint64_t completedFrame);
+
+		uint32_t FramesInFlight() const             { return m_frameCount; }
+		uint64_t OldestFrame() const                { return (m_frameCount == 0) ? m_frame : m_frames[m_oldestFrame].frame; }
+		bool MustWait() const                       { return FramesInFlight() >= m_settings.framesInFlight; }
+
+		// Bytes held by the frames in flight and the frame being recorded, padding included.
+		uint32_t Used() const                       { return m_used; }
+		const UploadArenaSettings& Settings() const { return m_settings; }
+
+	private:
+		struct FrameMark
+		{
+			uint64_t frame;
+			uint32_t end;       // Where the frame's last allocation ended.
+			uint32_t bytes;
+		};
+
+		UploadArenaSettings    m_settings;
+		uint32_t               m_head;         // Where the next allocation goes.
+		uint32_t               m_tail;         // The start of the oldest memory still held.
+		uint32_t               m_used;
+		uint64_t               m_frame;
+		uint32_t               m_frameBytes;
+		std::vector<FrameMark> m_frames;       // A ring of 'framesInFlight' marks of ended frames.
+		uint32_t               m_oldestFrame;  // The ring entry of the oldest ended frame.
+		uint32_t               m_frameCount;
+	};
+}
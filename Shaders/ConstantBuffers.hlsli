@@ -58,3 +58,30 @@ struct PixelShaderFlatInput
     float2 textureUV : TEXCOORD0;
     float4 diffuseColor : TEXCOORD1;
 };
+
+// The instanced shaders read the world matrix and diffuse color from the
+// instance stream instead of ConstantBufferChangesEveryPrim.
+struct VertexShaderInstancedInput
+{
+    float4 position : POSITION;
+    float4 normal : NORMAL;
+    float2 textureUV : TEXCOORD0;
+    float4 world0 : INSTANCEWORLD0;
+    float4 world1 : INSTANCEWORLD1;
+    float4 world2 : INSTANCEWORLD2;
+    float4 world3 : INSTANCEWORLD3;
+    float4 tint : INSTANCETINT;
+};
+
+struct PixelShaderInstancedInput
+{
+    float4 position : SV_POSITION;
+    float2 textureUV : TEXCOORD0;
+    float3 vertexToEye : TEXCOORD1;
+    float3 normal : TEXCOORD2;
+    float3 vertexToLight0 : TEXCOORD3;
+    float3 vertexToLight1 : TEXCOORD4;
+    float3 vertexToLight2 : TEXCOORD5;
+    float3 vertexToLight3 : TEXCOORD6;
+    float4 tint : TEXCOORD7;
+};
@@ -0,0 +1,24 @@
+#include "ConstantBuffers.hlsli"
+
+// PixelShader.hlsl for instanced draws: the instance's tint replaces diffuseColor.
+float4 main(PixelShaderInstancedInput input) : SV_Target
+{
+    float diffuseLuminance =
+        max(0.0f, dot(input.normal, input.vertexToLight0)) +
+        max(0.0f, dot(input.normal, input.vertexToLight1)) +
+        max(0.0f, dot(input.normal, input.vertexToLight2)) +
+        max(0.0f, dot(input.normal, input.vertexToLight3));
+
+    // Normalize view space vertex-to-eye
+    input.vertexToEye = normalize(input.vertexToEye);
+
+    float specularLuminance =
+        pow(max(0.0f, dot(input.normal, normalize(input.vertexToEye + input.vertexToLight0))), specularExponent) +
+        pow(max(0.0f, dot(input.normal, normalize(input.vertexToEye + input.vertexToLight1))), specularExponent) +
+        pow(max(0.0f, dot(input.normal, normalize(input.vertexToEye + input.vertexToLight2))), specularExponent) +
+        pow(max(0.0f, dot(input.normal, normalize(input.vertexToEye + input.vertexToLight3))), specularExponent);
+
+    float4 specular = specularColor * specularLuminance * 0.5f;
+
+    return diffuseTexture.Sample(linearSampler, input.textureUV) * input.tint * diffuseLuminance * 0.5f + specular;
+}
@@ -0,0 +1,28 @@
+#include "ConstantBuffers.hlsli"
+
+// VertexShader.hlsl for instanced draws: the world matrix comes from the instance.
+PixelShaderInstancedInput main(VertexShaderInstancedInput input)
+{
+    PixelShaderInstancedInput output = (PixelShaderInstancedInput)0;
+
+    float4x4 instanceWorld = float4x4(input.world0, input.world1, input.world2, input.world3);
+
+    float4 viewPosition = mul(mul(input.position, instanceWorld), view);
+    output.position = mul(viewPosition, projection);
+    output.textureUV = input.textureUV;
+    output.tint = input.tint;
+
+    // compute view space normal
+    output.normal = normalize (mul(mul(input.normal.xyz, (float3x3)instanceWorld), (float3x3)view));
+
+    // Vertex pos in view space (normalize in pixel shader)
+    output.vertexToEye = -viewPosition.xyz;
+
+    // Compute view space vertex to light vectors (normalized)
+    output.vertexToLight0 = normalize(mul(lightPosition[0], view ).xyz + output.vertexToEye);
+    output.vertexToLight1 = normalize(mul(lightPosition[1], view ).xyz + output.vertexToEye);
+    output.vertexToLight2 = normalize(mul(lightPosition[2], view ).xyz + output.vertexToEye);
+    output.vertexToLight3 = normalize(mul(lightPosition[3], view ).xyz + output.vertexToEye);
+
+    return output;
+}
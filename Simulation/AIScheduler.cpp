@@ -0,0 +1,148 @@
+#include "AIScheduler.h"
+
+#include <cassert>
+
+using namespace Simulation;
+
+namespace
+{
+	uint32_t PowerOfTwoAtMost(uint32_t value)
+	{
+		uint32_t power = 1;
+		while (power <= value / 2)
+		{
+			power *= 2;
+		}
+		return power;
+	}
+}
+
+//----------------------------------------------------------------------
+
+AIScheduler::AIScheduler() :
+	m_settings(DefaultAIScheduleSettings()),
+	m_queueHead(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void AIScheduler::Settings(const AIScheduleSettings& settings)
+{
+	// The checks are staggered with a mask of the interval.
+	assert(settings.midInterval > 0 && (settings.midInterval & (settings.midInterval - 1)) == 0);
+	assert(settings.farInterval > 0 && (settings.farInterval & (settings.farInterval - 1)) == 0);
+	m_settings = settings;
+	m_settings.midInterval = PowerOfTwoAtMost(settings.midInterval);
+	m_settings.farInterval = PowerOfTwoAtMost(settings.farInterval);
+}
+
+//----------------------------------------------------------------------
+
+void AIScheduler::Reset(uint32_t count, uint32_t tick)
+{
+	m_countedTo.assign(count, tick);
+	m_interval.assign(count, 1);
+	m_queued.assign(count, 0);
+	m_queue.clear();
+	m_queueHead = 0;
+}
+
+//----------------------------------------------------------------------
+
+void AIScheduler::Remove(uint32_t index)
+{
+	// A queued handle that is no longer valid is skipped when it comes up.
+	m_countedTo[index] = m_countedTo.back();
+	m_countedTo.pop_back();
+	m_interval[index] = m_interval.back();
+	m_interval.pop_back();
+	m_queued[index] = m_queued.back();
+	m_queued.pop_back();
+}
+
+//----------------------------------------------------------------------
+
+uint32_t AIScheduler::CheckInterval(const EntityStore& entities, uint32_t index, EntityHandle target) const
+{
+	float x = entities.PositionX()[index];
+	float z = entities.PositionZ()[index];
+	float focusX = x - m_settings.focus.x;
+	float focusZ = z - m_settings.focus.z;
+	float focusSquared = focusX * focusX + focusZ * focusZ;
+
+	uint32_t interval = 1;
+	if (focusSquared > m_settings.farDistance * m_settings.farDistance)
+	{
+		interval = m_settings.farInterval;
+	}
+	else if (focusSquared > m_settings.nearDistance * m_settings.nearDistance)
+	{
+		interval = m_settings.midInterval;
+	}
+
+	// A sumo that is only walking up to its opponent checks one level less often.
+	if (entities.Valid(target))
+	{
+		uint32_t targetIndex = entities.Index(target);
+		float targetX = entities.PositionX()[targetIndex] - x;
+		float targetZ = entities.PositionZ()[targetIndex] - z;
+		if (targetX * targetX + targetZ * targetZ > m_settings.idleDistance * m_settings.idleDistance)
+		{
+			interval = (interval == 1) ? m_settings.midInterval : m_settings.farInterval;
+		}
+	}
+	return interval;
+}
+
+//----------------------------------------------------------------------
+
+void AIScheduler::Schedule(const EntityStore& entities, std::vector<AIState>& ai,
+	const std::vector<EntityHandle>& targets, uint32_t tick, float deltaTime)
+{
+	uint32_t count = entities.Count();
+	m_checked.clear();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		// Staggered by slot, so a sumo keeps its place in the rotation when others are removed.
+		if (((tick + entities.Handle(i).slot) & (m_interval[i] - 1)) != 0)
+		{
+			continue;
+		}
+
+		// Count down every tick since the last check, this one included.
+		ai[i].delay -= deltaTime * (tick + 1 - m_countedTo[i]);
+		m_countedTo[i] = tick + 1;
+		m_interval[i] = CheckInterval(entities, i, targets[i]);
+		m_checked.push_back(i);
+
+		if (ai[i].delay <= 0 && m_queued[i] == 0)
+		{
+			m_queue.push_back(entities.Handle(i));
+			m_queued[i] = 1;
+		}
+	}
+
+	// The oldest queued sumos decide, up to the budget.
+	m_deciding.clear();
+	size_t budget = (m_settings.decisionBudget > 0) ? m_settings.decisionBudget : m_queue.size();
+	while (m_queueHead < m_queue.size() && m_deciding.size() < budget)
+	{
+		EntityHandle handle = m_queue[m_queueHead++];
+		if (entities.Valid(handle))
+		{
+			uint32_t index = entities.Index(handle);
+			m_queued[index] = 0;
+			m_deciding.push_back(index);
+		}
+	}
+
+	// Drop the consumed part of the queue once it is the larger part.
+	if (m_queueHead > m_queue.size() / 2)
+	{
+		m_queue.erase(m_queue.begin(), m_queue.begin() + m_queueHead);
+		m_queueHead = 0;
+	}
+}
+
+//----------------------------------------------------------------------
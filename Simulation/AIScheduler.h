@@ -0,0 +1,105 @@
+#pragma once
+
+// AIScheduler:
+// Spreads the AI's work in a crowded arena over time.  A sumo only has to
+// choose a maneuver when its delay runs out, and its heading towards its
+// opponent changes slowly, so instead of updating every sumo on every tick:
+//  - each sumo is checked every 1, AIMidInterval or AIFarInterval ticks,
+//    depending on how far it is from the camera, and less often again when it is
+//    far from its opponent and only walking up to it (idle).  A check counts
+//    down the delay and is when the sumo steers.  Checks are staggered by entity
+//    slot with a mask, so the intervals must be powers of two, and each tick
+//    checks a similar share of the crowd;
+//  - sumos whose delay ran out join a queue, and at most the decision budget of
+//    them decide per tick, oldest first.  The rest keep their current maneuver
+//    until their turn, still steering it at each check, so a crowd whose delays
+//    expire together doesn't make every choice on the same tick.
+// Movement isn't scheduled: every sumo still moves every tick, along the
+// velocity it worked out when it last steered.  Near sumos are checked every
+// tick, so only far and idle ones move on a heading a few ticks old.
+//
+// The schedule depends only on the tick, the positions and the settings, so a
+// scheduled arena is as repeatable as an unscheduled one.
+
+#include "../GameObjects/GameConstants.h"
+#include "SumoSimulation.h"
+#include "EntityStore.h"
+#include "Span.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	struct AIScheduleSettings
+	{
+		uint32_t decisionBudget;    // 0 for no limit.
+		Float3   focus;             // Where the camera is looking.
+		float    nearDistance;
+		float    farDistance;
+		float    idleDistance;
+		uint32_t midInterval;       // A power of two.
+		uint32_t farInterval;       // A power of two.
+	};
+
+	inline AIScheduleSettings DefaultAIScheduleSettings()
+	{
+		AIScheduleSettings settings = {
+			GameConstants::Arena::AIDecisionBudget,
+			MakeFloat3(0.0f, 0.0f, 0.0f),
+			GameConstants::Arena::AINearDistance,
+			GameConstants::Arena::AIFarDistance,
+			GameConstants::Arena::AIIdleDistance,
+			GameConstants::Arena::AIMidInterval,
+			GameConstants::Arena::AIFarInterval,
+		};
+		return settings;
+	}
+
+	// What the AI did on one tick, and what it cost.
+	struct AITickStats
+	{
+		uint32_t checked;           // Sumos that counted down their delay.
+		uint32_t decided;           // Maneuvers chosen.
+		uint32_t waiting;           // Sumos still queued for a decision.
+		uint32_t nanoseconds;       // Time spent on the AI, decisions and movement.
+	};
+
+	class AIScheduler
+	{
+	public:
+		AIScheduler();
+
+		// Intervals that aren't powers of two are rounded down to one.
+		void Settings(const AIScheduleSettings& settings);
+		const AIScheduleSettings& Settings() const  { return m_settings; }
+
+		// Start scheduling 'count' sumos from 'tick'.
+		void Reset(uint32_t count, uint32_t tick);
+
+		// Mirror EntityStore::Destroy moving the last entity into 'index'.
+		void Remove(uint32_t index);
+
+		// Count down the delays of the sumos due a check this tick and queue those whose
+		// delay ran out.  Checked() and Deciding() then list the sumos checked and the
+		// ones that choose a maneuver now.
+		void Schedule(const EntityStore& entities, std::vector<AIState>& ai,
+			const std::vector<EntityHandle>& targets, uint32_t tick, float deltaTime);
+
+		Span<const uint32_t> Checked() const        { return Span<const uint32_t>(m_checked.data(), m_checked.size()); }
+		Span<const uint32_t> Deciding() const       { return Span<const uint32_t>(m_deciding.data(), m_deciding.size()); }
+		uint32_t Waiting() const                    { return static_cast<uint32_t>(m_queue.size() - m_queueHead); }
+
+	private:
+		uint32_t CheckInterval(const EntityStore& entities, uint32_t index, EntityHandle target) const;
+
+		AIScheduleSettings        m_settings;
+		std::vector<uint32_t>     m_countedTo;   // Indexed like the entities: the tick the delay has been counted down to.
+		std::vector<uint32_t>     m_interval;    // Indexed like the entities.
+		std::vector<uint8_t>      m_queued;      // Indexed like the entities.
+		std::vector<EntityHandle> m_queue;
+		size_t                    m_queueHead;
+		std::vector<uint32_t>     m_checked;
+		std::vector<uint32_t>     m_deciding;
+	};
+}
@@ -0,0 +1,149 @@
+#include "Broadphase.h"
+
+#include <cmath>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+UniformGrid::UniformGrid(float cellSize) :
+	m_cellSize(cellSize),
+	m_inverseCellSize(1.0f / cellSize),
+	m_count(0),
+	m_bucketMask(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+uint32_t UniformGrid::Bucket(int32_t cellX, int32_t cellZ) const
+{
+	uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellZ) * 19349663u;
+	return hash & m_bucketMask;
+}
+
+//----------------------------------------------------------------------
+
+void UniformGrid::Build(const float* x, const float* z, uint32_t count)
+{
+	m_count = count;
+
+	// Use about two buckets per body to keep unrelated cells from sharing buckets.
+	uint32_t bucketCount = 16;
+	while (bucketCount < count * 2)
+	{
+		bucketCount <<= 1;
+	}
+	m_bucketMask = bucketCount - 1;
+
+	m_cellX.resize(count);
+	m_cellZ.resize(count);
+	m_bodyBucket.resize(count);
+	m_sortedBodies.resize(count);
+	m_bucketStart.assign(bucketCount + 1, 0);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		m_cellX[i] = static_cast<int32_t>(std::floor(x[i] * m_inverseCellSize));
+		m_cellZ[i] = static_cast<int32_t>(std::floor(z[i] * m_inverseCellSize));
+		m_bodyBucket[i] = Bucket(m_cellX[i], m_cellZ[i]);
+		m_bucketStart[m_bodyBucket[i] + 1]++;
+	}
+
+	// Counting sort of the bodies by bucket.
+	for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+	{
+		m_bucketStart[bucket + 1] += m_bucketStart[bucket];
+	}
+	std::vector<uint32_t>& next = m_sortedBodies;
+	uint32_t* fill = m_bucketStart.data();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		next[fill[m_bodyBucket[i]]++] = i;
+	}
+	// The fill pass advanced each start to the next bucket's start; shift back.
+	for (uint32_t bucket = bucketCount; bucket > 0; bucket--)
+	{
+		m_bucketStart[bucket] = m_bucketStart[bucket - 1];
+	}
+	m_bucketStart[0] = 0;
+}
+
+//----------------------------------------------------------------------
+
+void UniformGrid::FindPairs(std::vector<ContactPair>& pairs) const
+{
+	pairs.clear();
+
+	for (uint32_t i = 0; i < m_count; i++)
+	{
+		int32_t cellX = m_cellX[i];
+		int32_t cellZ = m_cellZ[i];
+
+		for (int32_t offsetZ = -1; offsetZ <= 1; offsetZ++)
+		{
+			for (int32_t offsetX = -1; offsetX <= 1; offsetX++)
+			{
+				int32_t neighborX = cellX + offsetX;
+				int32_t neighborZ = cellZ + offsetZ;
+				uint32_t bucket = Bucket(neighborX, neighborZ);
+
+				for (uint32_t entry = m_bucketStart[bucket]; entry < m_bucketStart[bucket + 1]; entry++)
+				{
+					uint32_t j = m_sortedBodies[entry];
+
+					// Buckets can hold several cells; only take bodies that are really in the
+					// neighboring cell, which also keeps a pair from being found twice.
+					if (j > i && m_cellX[j] == neighborX && m_cellZ[j] == neighborZ)
+					{
+						ContactPair pair = { i, j };
+						pairs.push_back(pair);
+					}
+				}
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void UniformGrid::FindPairs(std::vector<ContactPair>& pairs, const uint8_t* awake) const
+{
+	pairs.clear();
+
+	for (uint32_t i = 0; i < m_count; i++)
+	{
+		if (awake[i] == 0)
+		{
+			continue;
+		}
+
+		int32_t cellX = m_cellX[i];
+		int32_t cellZ = m_cellZ[i];
+
+		for (int32_t offsetZ = -1; offsetZ <= 1; offsetZ++)
+		{
+			for (int32_t offsetX = -1; offsetX <= 1; offsetX++)
+			{
+				int32_t neighborX = cellX + offsetX;
+				int32_t neighborZ = cellZ + offsetZ;
+				uint32_t bucket = Bucket(neighborX, neighborZ);
+
+				for (uint32_t entry = m_bucketStart[bucket]; entry < m_bucketStart[bucket + 1]; entry++)
+				{
+					uint32_t j = m_sortedBodies[entry];
+
+					// Two awake bodies are paired from the lower index; a sleeping one is
+					// only ever paired from its awake neighbor.
+					if ((j > i || (awake[j] == 0 && j != i)) && m_cellX[j] == neighborX && m_cellZ[j] == neighborZ)
+					{
+						ContactPair pair = { i, j };
+						pairs.push_back(pair);
+					}
+				}
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,58 @@
+#pragma once
+
+// UniformGrid:
+// Broadphase collision culling for arenas with many sumos.  Bodies are binned
+// on the mat (the x/z plane) into square cells one sumo wide, so two sumos can
+// only touch if they are in the same or adjacent cells.  Cells are hashed into a
+// table sized to the body count and the bodies are counting-sorted by bucket,
+// so building the grid and finding candidate pairs costs O(n) with no per-cell
+// allocations.  The narrowphase (ResolveContact) then decides whether each
+// candidate pair actually overlaps.
+//
+// Pairs are produced in a fixed order for a given set of positions, so the
+// simulation stays deterministic.
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	struct ContactPair
+	{
+		uint32_t a;
+		uint32_t b;
+	};
+
+	class UniformGrid
+	{
+	public:
+		explicit UniformGrid(float cellSize);
+
+		void Build(const float* x, const float* z, uint32_t count);
+
+		// Replace the contents of 'pairs' with every pair of bodies in the same or
+		// adjacent cells.  Each pair is reported once, with a < b.
+		void FindPairs(std::vector<ContactPair>& pairs) const;
+
+		// The same, leaving out pairs of two sleeping bodies ('awake' is zero), so bodies
+		// at rest cost nothing beyond building the grid.  A pair with a sleeping body
+		// lists the awake one as 'a'.
+		void FindPairs(std::vector<ContactPair>& pairs, const uint8_t* awake) const;
+
+		float CellSize() const                      { return m_cellSize; }
+
+	private:
+		uint32_t Bucket(int32_t cellX, int32_t cellZ) const;
+
+		float                 m_cellSize;
+		float                 m_inverseCellSize;
+		uint32_t              m_count;
+		uint32_t              m_bucketMask;
+
+		std::vector<int32_t>  m_cellX;           // Cell of each body.
+		std::vector<int32_t>  m_cellZ;
+		std::vector<uint32_t> m_bodyBucket;      // Hash bucket of each body.
+		std::vector<uint32_t> m_bucketStart;     // First entry of each bucket in m_sortedBodies.
+		std::vector<uint32_t> m_sortedBodies;    // Body indices ordered by bucket.
+	};
+}
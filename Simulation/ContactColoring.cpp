@@ -0,0 +1,79 @@
+#include "ContactColoring.h"
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+ContactColoring::ContactColoring() :
+	m_batchCount(0),
+	m_batchStart(MaxColors + 2, 0)
+{
+}
+
+//----------------------------------------------------------------------
+
+static uint32_t LowestClearBit(uint64_t bits)
+{
+	uint64_t clear = ~bits;
+	if (clear == 0)
+	{
+		return 64;
+	}
+#if defined(_MSC_VER)
+	unsigned long bit;
+	_BitScanForward64(&bit, clear);
+	return bit;
+#else
+	return static_cast<uint32_t>(__builtin_ctzll(clear));
+#endif
+}
+
+//----------------------------------------------------------------------
+
+void ContactColoring::Build(const ContactPair* pairs, uint32_t pairCount, uint32_t bodyCount)
+{
+	m_bodyColors.assign(bodyCount, 0);
+	m_pairColor.resize(pairCount);
+	m_sortedPairs.resize(pairCount);
+	std::fill(m_batchStart.begin(), m_batchStart.end(), 0);
+
+	// Give each pair the lowest color neither of its sumos has used yet.
+	for (uint32_t i = 0; i < pairCount; i++)
+	{
+		uint32_t a = pairs[i].a;
+		uint32_t b = pairs[i].b;
+		uint32_t color = LowestClearBit(m_bodyColors[a] | m_bodyColors[b]);
+		if (color < MaxColors)
+		{
+			m_bodyColors[a] |= 1ULL << color;
+			m_bodyColors[b] |= 1ULL << color;
+		}
+		m_pairColor[i] = static_cast<uint8_t>(color);
+		m_batchStart[color + 1]++;
+	}
+
+	// Counting sort of the pairs by color, keeping pair order within each batch.
+	m_batchCount = 0;
+	for (uint32_t batch = 0; batch <= MaxColors; batch++)
+	{
+		if (m_batchStart[batch + 1] > 0)
+		{
+			m_batchCount = batch + 1;
+		}
+		m_batchStart[batch + 1] += m_batchStart[batch];
+	}
+
+	m_batchFill.assign(m_batchStart.begin(), m_batchStart.end() - 1);
+	for (uint32_t i = 0; i < pairCount; i++)
+	{
+		m_sortedPairs[m_batchFill[m_pairColor[i]]++] = pairs[i];
+	}
+}
+
+//----------------------------------------------------------------------
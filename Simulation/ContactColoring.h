@@ -0,0 +1,48 @@
+#pragma once
+
+// ContactColoring:
+// Splits a list of contact pairs into batches ("colors") in which no two pairs
+// share a sumo.  The pairs in one batch can be resolved at the same time, on any
+// number of threads and in any order, with the same result; the batches
+// themselves are resolved one after another.
+//
+// Colors are assigned greedily in pair order, so the same pairs always produce
+// the same batches.  A sumo can take part in at most MaxColors batches; pairs
+// that don't fit go in a final overflow batch that has to be resolved serially.
+
+#include "Broadphase.h"
+#include "Span.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	class ContactColoring
+	{
+	public:
+		static const uint32_t MaxColors = 64;
+
+		ContactColoring();
+
+		void Build(const ContactPair* pairs, uint32_t pairCount, uint32_t bodyCount);
+
+		// The number of batches, including the overflow batch if it isn't empty.
+		uint32_t BatchCount() const                 { return m_batchCount; }
+		Span<const ContactPair> Batch(uint32_t batch) const
+		{
+			return Span<const ContactPair>(m_sortedPairs.data() + m_batchStart[batch], m_batchStart[batch + 1] - m_batchStart[batch]);
+		}
+
+		// True for the overflow batch, whose pairs may share sumos.
+		bool Serial(uint32_t batch) const           { return batch == MaxColors; }
+
+	private:
+		uint32_t                 m_batchCount;
+		std::vector<uint64_t>    m_bodyColors;   // Colors already used by each sumo, one bit per color.
+		std::vector<uint8_t>     m_pairColor;
+		std::vector<uint32_t>    m_batchStart;   // MaxColors + 1 batches, plus the end.
+		std::vector<uint32_t>    m_batchFill;
+		std::vector<ContactPair> m_sortedPairs;
+	};
+}
@@ -0,0 +1,175 @@
+#include "ContactEvents.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+ContactEventBuffer::ContactEventBuffer(const ContactEventSettings& settings) :
+	m_settings(settings),
+	m_tick(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void ContactEventBuffer::Clear(uint32_t tick)
+{
+	m_events.clear();
+	m_tick = tick;
+}
+
+//----------------------------------------------------------------------
+
+void ContactEventBuffer::Add(EntityHandle a, EntityHandle b, float impulse, float x, float z)
+{
+	if (impulse < m_settings.minImpulse)
+	{
+		return;
+	}
+
+	ContactEvent event = { a, b, impulse, x, z, m_tick };
+	m_events.push_back(event);
+}
+
+//----------------------------------------------------------------------
+
+void ContactEventBuffer::AddOverlaps(const ContactPair* pairs, uint32_t pairCount, const EntityStore& entities, float deltaTime)
+{
+	// The push-apart moves the two sumos apart by the whole overlap in one step, as if
+	// they had been closing at overlap / deltaTime; sumos have no mass of their own
+	// without dynamics, so the impulse is taken for two of SumoMass.
+	const float touchingSquared = GameConstants::Arena::SumoSize * GameConstants::Arena::SumoSize;
+	const float impulseScale = GameConstants::Arena::SumoMass * 0.5f / deltaTime;
+	const float* positionX = entities.PositionX();
+	const float* positionZ = entities.PositionZ();
+	for (uint32_t i = 0; i < pairCount; i++)
+	{
+		uint32_t a = pairs[i].a;
+		uint32_t b = pairs[i].b;
+		float xDelta = positionX[b] - positionX[a];
+		float zDelta = positionZ[b] - positionZ[a];
+		float distanceSquared = xDelta * xDelta + zDelta * zDelta;
+		if (distanceSquared < touchingSquared)
+		{
+			float overlap = GameConstants::Arena::SumoSize - std::sqrt(distanceSquared);
+			Add(entities.Handle(a), entities.Handle(b), overlap * impulseScale,
+				positionX[a] + xDelta * 0.5f, positionZ[a] + zDelta * 0.5f);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void ContactEventBuffer::AddImpacts(const ContactPair* pairs, uint32_t pairCount, const EntityStore& entities, const RigidBodies& bodies)
+{
+	// The same test and impulse as ApplyContactImpulses.
+	const float touchingSquared = GameConstants::Arena::SumoSize * GameConstants::Arena::SumoSize;
+	const float bounce = 1.0f + bodies.Settings().restitution;
+	const float* positionX = entities.PositionX();
+	const float* positionZ = entities.PositionZ();
+	const float* velocityX = bodies.VelocityX();
+	const float* velocityZ = bodies.VelocityZ();
+	const float* inverseMass = bodies.InverseMass();
+	for (uint32_t i = 0; i < pairCount; i++)
+	{
+		uint32_t a = pairs[i].a;
+		uint32_t b = pairs[i].b;
+		float xDelta = positionX[b] - positionX[a];
+		float zDelta = positionZ[b] - positionZ[a];
+		float distanceSquared = xDelta * xDelta + zDelta * zDelta;
+		if (!(distanceSquared < touchingSquared && distanceSquared > 0.0f))
+		{
+			continue;
+		}
+
+		float distance = std::sqrt(distanceSquared);
+		float closing = ((velocityX[b] - velocityX[a]) * xDelta + (velocityZ[b] - velocityZ[a]) * zDelta) / distance;
+		if (closing < 0.0f)
+		{
+			Add(entities.Handle(a), entities.Handle(b), -bounce * closing / (inverseMass[a] + inverseMass[b]),
+				positionX[a] + xDelta * 0.5f, positionZ[a] + zDelta * 0.5f);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+ContactEventQueue::ContactEventQueue(uint32_t capacity) :
+	m_head(0),
+	m_cachedTail(0),
+	m_dropped(0),
+	m_tail(0),
+	m_cachedHead(0)
+{
+	uint32_t size = 1;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+	m_events.resize(size);
+	m_mask = size - 1;
+}
+
+//----------------------------------------------------------------------
+
+uint32_t ContactEventQueue::Push(const ContactEvent* events, uint32_t count)
+{
+	// An empty span may have no storage at all, which memcpy mustn't be given.
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	uint32_t head = m_head.load(std::memory_order_relaxed);
+	uint32_t room = Capacity() - (head - m_cachedTail);
+	if (room < count)
+	{
+		m_cachedTail = m_tail.load(std::memory_order_acquire);
+		room = Capacity() - (head - m_cachedTail);
+	}
+
+	uint32_t pushed = std::min(count, room);
+	uint32_t start = head & m_mask;
+	uint32_t first = std::min(pushed, Capacity() - start);
+	memcpy(&m_events[start], events, first * sizeof(ContactEvent));
+	memcpy(&m_events[0], events + first, (pushed - first) * sizeof(ContactEvent));
+	m_head.store(head + pushed, std::memory_order_release);
+
+	if (pushed < count)
+	{
+		m_dropped.fetch_add(count - pushed, std::memory_order_relaxed);
+	}
+	return pushed;
+}
+
+//----------------------------------------------------------------------
+
+uint32_t ContactEventQueue::Pop(ContactEvent* events, uint32_t maxCount)
+{
+	if (maxCount == 0)
+	{
+		return 0;
+	}
+
+	uint32_t tail = m_tail.load(std::memory_order_relaxed);
+	uint32_t waiting = m_cachedHead - tail;
+	if (waiting < maxCount)
+	{
+		m_cachedHead = m_head.load(std::memory_order_acquire);
+		waiting = m_cachedHead - tail;
+	}
+
+	uint32_t popped = std::min(maxCount, waiting);
+	uint32_t start = tail & m_mask;
+	uint32_t first = std::min(popped, Capacity() - start);
+	memcpy(events, &m_events[start], first * sizeof(ContactEvent));
+	memcpy(events + first, &m_events[0], (popped - first) * sizeof(ContactEvent));
+	m_tail.store(tail + popped, std::memory_order_release);
+	return popped;
+}
+
+//----------------------------------------------------------------------
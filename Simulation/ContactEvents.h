@@ -0,0 +1,134 @@
+#pragma once
+
+// Contact events:
+// What the simulation reports about the contacts of a tick, for sounds and
+// effects, so they can react to collisions without reading the game play state.
+//
+// ContactEventBuffer collects the events of one tick.  Each event names the two
+// sumos, where on the mat they touched and the impulse of the contact: the
+// momentum exchanged along the line between the sumos.  Two sumos of
+// GameConstants::Arena::SumoMass that meet at a closing speed v exchange about
+// v times half that mass, so contacts below GameConstants::Sound::MinVelocity
+// are left out by the same measure, as nobody would hear them.  Filling the
+// buffer never changes the simulation, so runs with and without listeners stay
+// the same.
+//
+// ContactEventQueue hands events from the simulation thread to one listener on
+// another thread.  It is a lock-free ring for a single producer and a single
+// consumer: the producer copies a tick's events in and publishes them with one
+// release store, and the consumer copies out as many as it likes with one
+// acquire load.  The simulation never waits on a listener; when the ring is
+// full, the events that don't fit are dropped and counted.
+
+#include "../GameObjects/GameConstants.h"
+#include "EntityStore.h"
+#include "Broadphase.h"
+#include "RigidBodies.h"
+#include "Span.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	struct ContactEvent
+	{
+		EntityHandle a;
+		EntityHandle b;
+		float        impulse;
+		float        x;         // Where the sumos touched, on the mat.
+		float        z;
+		uint32_t     tick;
+	};
+
+	struct ContactEventSettings
+	{
+		float minImpulse;       // Softer contacts aren't reported.
+	};
+
+	inline ContactEventSettings DefaultContactEventSettings()
+	{
+		ContactEventSettings settings = {
+			GameConstants::Sound::MinVelocity * GameConstants::Arena::SumoMass * 0.5f,
+		};
+		return settings;
+	}
+
+	class ContactEventBuffer
+	{
+	public:
+		explicit ContactEventBuffer(const ContactEventSettings& settings = DefaultContactEventSettings());
+
+		void Settings(const ContactEventSettings& settings) { m_settings = settings; }
+		const ContactEventSettings& Settings() const { return m_settings; }
+
+		// Make room for 'capacity' events, so ticks reporting no more than that never
+		// allocate.
+		void Reserve(uint32_t capacity)             { m_events.reserve(capacity); }
+
+		// Start collecting the events of 'tick'.
+		void Clear(uint32_t tick);
+
+		// Report one contact, if it is hard enough.
+		void Add(EntityHandle a, EntityHandle b, float impulse, float x, float z);
+
+		// Report the pairs that overlap, with the impulse that pushing them apart over
+		// 'deltaTime' gives them.  Called before the contacts are resolved.
+		void AddOverlaps(const ContactPair* pairs, uint32_t pairCount, const EntityStore& entities, float deltaTime);
+
+		// Report the pairs that touch and are closing, with the impulse RigidBodies
+		// gives them.  Called before the contact impulses are solved; each impulse is
+		// measured from the velocities at the start of the step.
+		void AddImpacts(const ContactPair* pairs, uint32_t pairCount, const EntityStore& entities, const RigidBodies& bodies);
+
+		Span<const ContactEvent> Events() const     { return Span<const ContactEvent>(m_events.data(), m_events.size()); }
+		uint32_t Count() const                      { return static_cast<uint32_t>(m_events.size()); }
+
+	private:
+		ContactEventSettings      m_settings;
+		std::vector<ContactEvent> m_events;
+		uint32_t                  m_tick;
+	};
+
+	class ContactEventQueue
+	{
+	public:
+		// Room for at least 'capacity' events; rounded up to a power of two.
+		explicit ContactEventQueue(uint32_t capacity = GameConstants::Sound::EventQueueSize);
+
+		// Producer: copy in as many of the events as there is room for and return how
+		// many that was.  The rest are dropped.
+		uint32_t Push(const ContactEvent* events, uint32_t count);
+		uint32_t Push(Span<const ContactEvent> events) { return Push(events.begin(), static_cast<uint32_t>(events.size())); }
+
+		// Consumer: copy out up to 'maxCount' of the oldest events and return how many.
+		uint32_t Pop(ContactEvent* events, uint32_t maxCount);
+
+		uint32_t Capacity() const                   { return m_mask + 1; }
+		// Events dropped because the consumer had fallen behind.
+		uint32_t Dropped() const                    { return m_dropped.load(std::memory_order_relaxed); }
+
+	private:
+		ContactEventQueue(const ContactEventQueue&);
+		ContactEventQueue& operator=(const ContactEventQueue&);
+
+		static const size_t CacheLine = 64;
+
+		std::vector<ContactEvent> m_events;
+		uint32_t                  m_mask;
+
+		// The producer's and the consumer's counters are kept on cache lines of their
+		// own so the two threads don't keep taking the line from each other.  Each
+		// side keeps its own copy of the other's counter and only reloads it when the
+		// ring looks full (or empty).
+		char                      m_producerPadding[CacheLine];
+		std::atomic<uint32_t>     m_head;        // Events pushed; written by the producer.
+		uint32_t                  m_cachedTail;
+		std::atomic<uint32_t>     m_dropped;
+		char                      m_consumerPadding[CacheLine];
+		std::atomic<uint32_t>     m_tail;        // Events popped; written by the consumer.
+		uint32_t                  m_cachedHead;
+		char                      m_endPadding[CacheLine];
+	};
+}
@@ -0,0 +1,194 @@
+#include "ContactKernel.h"
+#include "../GameObjects/GameConstants.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#define SUMO_CONTACT_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_CONTACT_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+void Simulation::AccumulateContactCorrectionsScalar(const ContactPair* pairs, uint32_t pairCount,
+	const float* positionX, const float* positionZ, float* correctionX, float* correctionZ)
+{
+	for (uint32_t i = 0; i < pairCount; i++)
+	{
+		uint32_t a = pairs[i].a;
+		uint32_t b = pairs[i].b;
+		float xDelta = positionX[b] - positionX[a];
+		float zDelta = positionZ[b] - positionZ[a];
+
+		// Pairs that aren't touching add a zero correction rather than branching,
+		// exactly as the vector kernels do.
+		float overlap = std::sqrt(xDelta * xDelta + zDelta * zDelta) - GameConstants::Arena::SumoSize;
+		float scale = (overlap < 0) ? overlap * 0.5f : 0.0f;
+		float xCorrection = xDelta * scale;
+		float zCorrection = zDelta * scale;
+		correctionX[a] += xCorrection;
+		correctionZ[a] += zCorrection;
+		correctionX[b] -= xCorrection;
+		correctionZ[b] -= zCorrection;
+	}
+}
+
+//----------------------------------------------------------------------
+
+#if defined(SUMO_CONTACT_AVX2) || defined(SUMO_CONTACT_SSE2)
+
+// Scatter one batch of corrections.  There is no vector scatter, and pairs in a
+// batch may share bodies, so this part is scalar and runs in pair order.
+static inline void ScatterCorrections(const ContactPair* pairs, uint32_t count,
+	const float* xCorrections, const float* zCorrections, float* correctionX, float* correctionZ)
+{
+	for (uint32_t lane = 0; lane < count; lane++)
+	{
+		uint32_t a = pairs[lane].a;
+		uint32_t b = pairs[lane].b;
+		correctionX[a] += xCorrections[lane];
+		correctionZ[a] += zCorrections[lane];
+		correctionX[b] -= xCorrections[lane];
+		correctionZ[b] -= zCorrections[lane];
+	}
+}
+
+#endif
+
+//----------------------------------------------------------------------
+
+#if defined(SUMO_CONTACT_AVX2)
+
+void Simulation::AccumulateContactCorrections(const ContactPair* pairs, uint32_t pairCount,
+	const float* positionX, const float* positionZ, float* correctionX, float* correctionZ)
+{
+	static_assert(sizeof(ContactPair) == 2 * sizeof(uint32_t), "pairs are loaded as packed index pairs");
+
+	const __m256 sumoSize = _mm256_set1_ps(GameConstants::Arena::SumoSize);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256i evenLanes = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+	float xCorrections[8];
+	float zCorrections[8];
+
+	uint32_t i = 0;
+	for (; i + 8 <= pairCount; i += 8)
+	{
+		// Load eight {a, b} pairs and split them into the a and b indices.
+		__m256i pairs0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pairs + i));
+		__m256i pairs1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pairs + i + 4));
+		pairs0 = _mm256_permutevar8x32_epi32(pairs0, evenLanes);
+		pairs1 = _mm256_permutevar8x32_epi32(pairs1, evenLanes);
+		__m256i indexA = _mm256_permute2x128_si256(pairs0, pairs1, 0x20);
+		__m256i indexB = _mm256_permute2x128_si256(pairs0, pairs1, 0x31);
+
+		__m256 xDelta = _mm256_sub_ps(_mm256_i32gather_ps(positionX, indexB, 4), _mm256_i32gather_ps(positionX, indexA, 4));
+		__m256 zDelta = _mm256_sub_ps(_mm256_i32gather_ps(positionZ, indexB, 4), _mm256_i32gather_ps(positionZ, indexA, 4));
+
+		__m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(xDelta, xDelta), _mm256_mul_ps(zDelta, zDelta)));
+		__m256 overlap = _mm256_sub_ps(distance, sumoSize);
+		__m256 touching = _mm256_cmp_ps(overlap, zero, _CMP_LT_OQ);
+
+		// Most pairs from the broadphase aren't touching; skip the scatter when none are.
+		if (_mm256_movemask_ps(touching) == 0)
+		{
+			continue;
+		}
+
+		__m256 scale = _mm256_and_ps(_mm256_mul_ps(overlap, half), touching);
+		_mm256_storeu_ps(xCorrections, _mm256_mul_ps(xDelta, scale));
+		_mm256_storeu_ps(zCorrections, _mm256_mul_ps(zDelta, scale));
+		ScatterCorrections(pairs + i, 8, xCorrections, zCorrections, correctionX, correctionZ);
+	}
+
+	AccumulateContactCorrectionsScalar(pairs + i, pairCount - i, positionX, positionZ, correctionX, correctionZ);
+}
+
+const char* Simulation::ContactKernelInstructionSet()
+{
+	return "AVX2";
+}
+
+#elif defined(SUMO_CONTACT_SSE2)
+
+void Simulation::AccumulateContactCorrections(const ContactPair* pairs, uint32_t pairCount,
+	const float* positionX, const float* positionZ, float* correctionX, float* correctionZ)
+{
+	const __m128 sumoSize = _mm_set1_ps(GameConstants::Arena::SumoSize);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 zero = _mm_setzero_ps();
+
+	float xCorrections[4];
+	float zCorrections[4];
+
+	uint32_t i = 0;
+	for (; i + 4 <= pairCount; i += 4)
+	{
+		// SSE2 has no gather.
+		const ContactPair* batch = pairs + i;
+		__m128 ax = _mm_setr_ps(positionX[batch[0].a], positionX[batch[1].a], positionX[batch[2].a], positionX[batch[3].a]);
+		__m128 az = _mm_setr_ps(positionZ[batch[0].a], positionZ[batch[1].a], positionZ[batch[2].a], positionZ[batch[3].a]);
+		__m128 bx = _mm_setr_ps(positionX[batch[0].b], positionX[batch[1].b], positionX[batch[2].b], positionX[batch[3].b]);
+		__m128 bz = _mm_setr_ps(positionZ[batch[0].b], positionZ[batch[1].b], positionZ[batch[2].b], positionZ[batch[3].b]);
+
+		__m128 xDelta = _mm_sub_ps(bx, ax);
+		__m128 zDelta = _mm_sub_ps(bz, az);
+
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(xDelta, xDelta), _mm_mul_ps(zDelta, zDelta)));
+		__m128 overlap = _mm_sub_ps(distance, sumoSize);
+		__m128 touching = _mm_cmplt_ps(overlap, zero);
+
+		// Most pairs from the broadphase aren't touching; skip the scatter when none are.
+		if (_mm_movemask_ps(touching) == 0)
+		{
+			continue;
+		}
+
+		__m128 scale = _mm_and_ps(_mm_mul_ps(overlap, half), touching);
+		_mm_storeu_ps(xCorrections, _mm_mul_ps(xDelta, scale));
+		_mm_storeu_ps(zCorrections, _mm_mul_ps(zDelta, scale));
+		ScatterCorrections(batch, 4, xCorrections, zCorrections, correctionX, correctionZ);
+	}
+
+	AccumulateContactCorrectionsScalar(pairs + i, pairCount - i, positionX, positionZ, correctionX, correctionZ);
+}
+
+const char* Simulation::ContactKernelInstructionSet()
+{
+	return "SSE2";
+}
+
+#else
+
+void Simulation::AccumulateContactCorrections(const ContactPair* pairs, uint32_t pairCount,
+	const float* positionX, const float* positionZ, float* correctionX, float* correctionZ)
+{
+	AccumulateContactCorrectionsScalar(pairs, pairCount, positionX, positionZ, correctionX, correctionZ);
+}
+
+const char* Simulation::ContactKernelInstructionSet()
+{
+	return "scalar";
+}
+
+#endif
+
+//----------------------------------------------------------------------
+
+void Simulation::ApplyContactCorrections(uint32_t count, float* positionX, float* positionZ,
+	const float* correctionX, const float* correctionZ)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		positionX[i] += correctionX[i];
+		positionZ[i] += correctionZ[i];
+	}
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,44 @@
+#pragma once
+
+// Contact kernel:
+// Resolves sumo overlaps for a whole list of contact pairs at once, working
+// directly on the EntityStore's per-axis position arrays.  The pairs are
+// processed eight at a time with AVX2 (four at a time with SSE2) and any that
+// are left over go through the scalar version of the same kernel.
+//
+// The rule is the same push-apart as ResolveContact, but every pair is measured
+// from the positions at the start of the pass and the corrections are summed per
+// body, then applied in one pass afterwards.  That lets the pairs be evaluated
+// independently of each other; a sumo touching two others is pushed by both
+// contacts instead of by the second one seeing the result of the first.
+// Corrections are summed in pair order on every path, so the vector and scalar
+// kernels produce the same positions.
+//
+// Sumos stand on the mat, so only x and z are corrected.
+
+#include "Broadphase.h"
+
+#include <cstdint>
+
+namespace Simulation
+{
+	// Add the correction for each overlapping pair into correctionX/Z, which must be
+	// zeroed by the caller and be as long as the position arrays.  When no two pairs
+	// share a sumo (a ContactColoring batch), the position arrays can be passed as
+	// the corrections to resolve the pairs in place.
+	void AccumulateContactCorrections(const ContactPair* pairs, uint32_t pairCount,
+		const float* positionX, const float* positionZ, float* correctionX, float* correctionZ);
+
+	// Always uses the scalar kernel, for platforms without SIMD and for comparison.
+	// Passing the position arrays as the corrections resolves the pairs one after
+	// another, even if they share sumos.
+	void AccumulateContactCorrectionsScalar(const ContactPair* pairs, uint32_t pairCount,
+		const float* positionX, const float* positionZ, float* correctionX, float* correctionZ);
+
+	// Add the corrections to the positions.
+	void ApplyContactCorrections(uint32_t count, float* positionX, float* positionZ,
+		const float* correctionX, const float* correctionZ);
+
+	// "AVX2", "SSE2" or "scalar": the kernel AccumulateContactCorrections was built with.
+	const char* ContactKernelInstructionSet();
+}
@@ -0,0 +1,166 @@
+#include "CounterRandom.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_RANDOM_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Simulation;
+
+namespace
+{
+	// Philox4x32 multipliers and Weyl key increments.
+	const uint32_t Multiplier0 = 0xD2511F53;
+	const uint32_t Multiplier1 = 0xCD9E8D57;
+	const uint32_t KeyStep0    = 0x9E3779B9;
+	const uint32_t KeyStep1    = 0xBB67AE85;
+	const int      Rounds      = 10;
+
+	// The counter of a block: { block, tick low, tick high, stream }.
+	RandomBlock Philox(uint32_t block, uint64_t tick, uint32_t stream, uint64_t seed)
+	{
+		uint32_t x0 = block;
+		uint32_t x1 = static_cast<uint32_t>(tick);
+		uint32_t x2 = static_cast<uint32_t>(tick >> 32);
+		uint32_t x3 = stream;
+		uint32_t key0 = static_cast<uint32_t>(seed);
+		uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+
+		for (int round = 0; round < Rounds; round++)
+		{
+			uint64_t product0 = static_cast<uint64_t>(Multiplier0) * x0;
+			uint64_t product1 = static_cast<uint64_t>(Multiplier1) * x2;
+			uint32_t y0 = static_cast<uint32_t>(product1 >> 32) ^ x1 ^ key0;
+			uint32_t y1 = static_cast<uint32_t>(product1);
+			uint32_t y2 = static_cast<uint32_t>(product0 >> 32) ^ x3 ^ key1;
+			uint32_t y3 = static_cast<uint32_t>(product0);
+			x0 = y0;
+			x1 = y1;
+			x2 = y2;
+			x3 = y3;
+			key0 += KeyStep0;
+			key1 += KeyStep1;
+		}
+
+		RandomBlock result = { { x0, x1, x2, x3 } };
+		return result;
+	}
+
+#if defined(SUMO_RANDOM_SSE2)
+
+	// The high and low 32 bits of the four products multiplier * x.
+	inline void MultiplyHighLow(__m128i multiplier, __m128i x, __m128i& high, __m128i& low)
+	{
+		__m128i even = _mm_mul_epu32(x, multiplier);                                  // Lanes 0 and 2.
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), multiplier);               // Lanes 1 and 3.
+		low = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		high = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+	}
+
+	// Four blocks at once, one per lane, in structure-of-arrays form.
+	void Philox4(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3, uint64_t seed)
+	{
+		const __m128i multiplier0 = _mm_set1_epi32(static_cast<int>(Multiplier0));
+		const __m128i multiplier1 = _mm_set1_epi32(static_cast<int>(Multiplier1));
+		uint32_t key0 = static_cast<uint32_t>(seed);
+		uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+
+		for (int round = 0; round < Rounds; round++)
+		{
+			__m128i high0, low0, high1, low1;
+			MultiplyHighLow(multiplier0, x0, high0, low0);
+			MultiplyHighLow(multiplier1, x2, high1, low1);
+			__m128i y0 = _mm_xor_si128(_mm_xor_si128(high1, x1), _mm_set1_epi32(static_cast<int>(key0)));
+			__m128i y2 = _mm_xor_si128(_mm_xor_si128(high0, x3), _mm_set1_epi32(static_cast<int>(key1)));
+			x0 = y0;
+			x1 = low1;
+			x2 = y2;
+			x3 = low0;
+			key0 += KeyStep0;
+			key1 += KeyStep1;
+		}
+	}
+
+	// Transpose four structure-of-arrays blocks into four RandomBlocks.
+	inline void StoreBlocks(__m128i x0, __m128i x1, __m128i x2, __m128i x3, RandomBlock* blocks)
+	{
+		__m128i t0 = _mm_unpacklo_epi32(x0, x1);
+		__m128i t1 = _mm_unpacklo_epi32(x2, x3);
+		__m128i t2 = _mm_unpackhi_epi32(x0, x1);
+		__m128i t3 = _mm_unpackhi_epi32(x2, x3);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&blocks[0]), _mm_unpacklo_epi64(t0, t1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&blocks[1]), _mm_unpackhi_epi64(t0, t1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&blocks[2]), _mm_unpacklo_epi64(t2, t3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&blocks[3]), _mm_unpackhi_epi64(t2, t3));
+	}
+
+#endif
+}
+
+//----------------------------------------------------------------------
+
+RandomBlock CounterRandom::Block(uint32_t stream, uint64_t tick, uint32_t block) const
+{
+	return Philox(block, tick, stream, m_seed);
+}
+
+//----------------------------------------------------------------------
+
+void CounterRandom::Fill(uint32_t stream, uint64_t tick, uint32_t* values, uint32_t count) const
+{
+	uint32_t block = 0;
+	uint32_t filled = 0;
+
+#if defined(SUMO_RANDOM_SSE2)
+	__m128i tickLow = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(tick)));
+	__m128i tickHigh = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(tick >> 32)));
+	__m128i streams = _mm_set1_epi32(static_cast<int>(stream));
+	for (; filled + 16 <= count; filled += 16, block += 4)
+	{
+		__m128i x0 = _mm_setr_epi32(static_cast<int>(block), static_cast<int>(block + 1), static_cast<int>(block + 2), static_cast<int>(block + 3));
+		__m128i x1 = tickLow;
+		__m128i x2 = tickHigh;
+		__m128i x3 = streams;
+		Philox4(x0, x1, x2, x3, m_seed);
+		StoreBlocks(x0, x1, x2, x3, reinterpret_cast<RandomBlock*>(values + filled));
+	}
+#endif
+
+	for (; filled < count; block++)
+	{
+		RandomBlock values4 = Philox(block, tick, stream, m_seed);
+		for (int word = 0; word < 4 && filled < count; word++)
+		{
+			values[filled++] = values4.value[word];
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void CounterRandom::FillStreams(uint32_t firstStream, uint32_t count, uint64_t tick, RandomBlock* blocks) const
+{
+	uint32_t filled = 0;
+
+#if defined(SUMO_RANDOM_SSE2)
+	__m128i tickLow = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(tick)));
+	__m128i tickHigh = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(tick >> 32)));
+	for (; filled + 4 <= count; filled += 4)
+	{
+		uint32_t stream = firstStream + filled;
+		__m128i x0 = _mm_setzero_si128();
+		__m128i x1 = tickLow;
+		__m128i x2 = tickHigh;
+		__m128i x3 = _mm_setr_epi32(static_cast<int>(stream), static_cast<int>(stream + 1), static_cast<int>(stream + 2), static_cast<int>(stream + 3));
+		Philox4(x0, x1, x2, x3, m_seed);
+		StoreBlocks(x0, x1, x2, x3, blocks + filled);
+	}
+#endif
+
+	for (; filled < count; filled++)
+	{
+		blocks[filled] = Philox(0, tick, firstStream + filled, m_seed);
+	}
+}
+
+//----------------------------------------------------------------------
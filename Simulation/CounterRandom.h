@@ -0,0 +1,88 @@
+#pragma once
+
+// CounterRandom:
+// A stateless, counter-based random number generator (Philox4x32-10).  Every
+// random value is a pure function of the generator's key (the match seed) and a
+// counter made from a stream id (usually the entity), the simulation tick and a
+// block number.  Nothing is shared or updated between draws, so any number of
+// simulations, entities or threads can draw at the same time without contention,
+// and a draw can be reproduced from its seed, entity and tick alone.
+//
+// Each counter gives a block of four 32-bit values.  Fill() and FillStreams()
+// generate many blocks at once with SSE2 where it is available.
+//
+// RandomStream wraps one (stream, tick) pair in the small sequential interface
+// the game play rules use; it only generates a block when a value is drawn.
+
+#include <cstdint>
+
+namespace Simulation
+{
+	struct RandomBlock
+	{
+		uint32_t value[4];
+	};
+
+	class CounterRandom
+	{
+	public:
+		explicit CounterRandom(uint64_t seed = 0)   { Seed(seed); }
+
+		void Seed(uint64_t seed)                    { m_seed = seed; }
+		uint64_t Seed() const                       { return m_seed; }
+
+		RandomBlock Block(uint32_t stream, uint64_t tick, uint32_t block) const;
+
+		// 'count' consecutive values of one stream for one tick, starting at block 0.
+		void Fill(uint32_t stream, uint64_t tick, uint32_t* values, uint32_t count) const;
+
+		// Block 0 of 'count' consecutive streams for one tick, for example one
+		// block for every entity in a scene.
+		void FillStreams(uint32_t firstStream, uint32_t count, uint64_t tick, RandomBlock* blocks) const;
+
+	private:
+		uint64_t m_seed;
+	};
+
+	class RandomStream
+	{
+	public:
+		// Draws start from 'block', so two streams for the same stream id and tick
+		// can be kept apart by starting them at different blocks.
+		RandomStream(const CounterRandom& generator, uint32_t stream, uint64_t tick, uint32_t block = 0) :
+			m_generator(&generator),
+			m_stream(stream),
+			m_tick(tick),
+			m_block(block),
+			m_used(4)
+		{
+		}
+
+		uint32_t Next()
+		{
+			if (m_used == 4)
+			{
+				m_values = m_generator->Block(m_stream, m_tick, m_block++);
+				m_used = 0;
+			}
+			return m_values.value[m_used++];
+		}
+
+		// Returns a value in [0, range).  The modulo bias is negligible for the small
+		// ranges used by the game play rules.
+		int NextInt(int range)                      { return static_cast<int>(Next() % static_cast<uint32_t>(range)); }
+
+		// Returns a value in [0, 1) with 24 bits of precision.
+		float NextFloat()                           { return ToFloat(Next()); }
+
+		static float ToFloat(uint32_t value)        { return (value >> 8) * (1.0f / 16777216.0f); }
+
+	private:
+		const CounterRandom* m_generator;
+		uint32_t             m_stream;
+		uint64_t             m_tick;
+		uint32_t             m_block;
+		uint32_t             m_used;
+		RandomBlock          m_values;
+	};
+}
@@ -0,0 +1,188 @@
+#include "EntityStore.h"
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+EntityStore::EntityStore()
+{
+}
+
+//----------------------------------------------------------------------
+
+EntityHandle EntityStore::Create(Float3 position)
+{
+	EntityHandle entity;
+	if (!m_freeSlots.empty())
+	{
+		entity.slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		entity.slot = static_cast<uint32_t>(m_slotIndex.size());
+		m_slotIndex.push_back(0);
+		m_slotGeneration.push_back(0);
+	}
+	entity.generation = m_slotGeneration[entity.slot];
+	m_slotIndex[entity.slot] = Count();
+
+	RenderHandle noRender = { NoRenderResource, NoRenderResource };
+
+	m_positionX.push_back(position.x);
+	m_positionY.push_back(position.y);
+	m_positionZ.push_back(position.z);
+	m_velocityX.push_back(0.0f);
+	m_velocityY.push_back(0.0f);
+	m_velocityZ.push_back(0.0f);
+	Float4x4 transform = Float4x4Identity();
+	transform.m[3][0] = position.x;
+	transform.m[3][1] = position.y;
+	transform.m[3][2] = position.z;
+	m_transforms.push_back(transform);
+	m_renderHandles.push_back(noRender);
+	m_bases.push_back(Float4x4Identity());
+	m_facingTargets.push_back(InvalidEntity);
+	m_transformDirty.push_back(1);
+	m_handles.push_back(entity);
+	return entity;
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::Destroy(EntityHandle entity)
+{
+	if (!Valid(entity))
+	{
+		return;
+	}
+
+	// Keep the arrays dense by moving the last entity into the freed index.
+	uint32_t index = m_slotIndex[entity.slot];
+	uint32_t last = Count() - 1;
+	if (index != last)
+	{
+		m_positionX[index] = m_positionX[last];
+		m_positionY[index] = m_positionY[last];
+		m_positionZ[index] = m_positionZ[last];
+		m_velocityX[index] = m_velocityX[last];
+		m_velocityY[index] = m_velocityY[last];
+		m_velocityZ[index] = m_velocityZ[last];
+		m_transforms[index] = m_transforms[last];
+		m_renderHandles[index] = m_renderHandles[last];
+		m_bases[index] = m_bases[last];
+		m_facingTargets[index] = m_facingTargets[last];
+		m_transformDirty[index] = m_transformDirty[last];
+		m_handles[index] = m_handles[last];
+		m_slotIndex[m_handles[index].slot] = index;
+	}
+
+	m_positionX.pop_back();
+	m_positionY.pop_back();
+	m_positionZ.pop_back();
+	m_velocityX.pop_back();
+	m_velocityY.pop_back();
+	m_velocityZ.pop_back();
+	m_transforms.pop_back();
+	m_renderHandles.pop_back();
+	m_bases.pop_back();
+	m_facingTargets.pop_back();
+	m_transformDirty.pop_back();
+	m_handles.pop_back();
+
+	m_slotGeneration[entity.slot]++;
+	m_freeSlots.push_back(entity.slot);
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::Clear()
+{
+	while (Count() > 0)
+	{
+		Destroy(m_handles.back());
+	}
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::Reserve(uint32_t count)
+{
+	m_positionX.reserve(count);
+	m_positionY.reserve(count);
+	m_positionZ.reserve(count);
+	m_velocityX.reserve(count);
+	m_velocityY.reserve(count);
+	m_velocityZ.reserve(count);
+	m_transforms.reserve(count);
+	m_renderHandles.reserve(count);
+	m_bases.reserve(count);
+	m_facingTargets.reserve(count);
+	m_transformDirty.reserve(count);
+	m_handles.reserve(count);
+	m_slotIndex.reserve(count);
+	m_slotGeneration.reserve(count);
+}
+
+//----------------------------------------------------------------------
+
+bool EntityStore::Valid(EntityHandle entity) const
+{
+	return entity.slot < m_slotIndex.size() && m_slotGeneration[entity.slot] == entity.generation;
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::Position(uint32_t index, Float3 position)
+{
+	m_positionX[index] = position.x;
+	m_positionY[index] = position.y;
+	m_positionZ[index] = position.z;
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::Velocity(uint32_t index, Float3 velocity)
+{
+	m_velocityX[index] = velocity.x;
+	m_velocityY[index] = velocity.y;
+	m_velocityZ[index] = velocity.z;
+}
+
+//----------------------------------------------------------------------
+
+Float3 EntityStore::RenderPosition(uint32_t index) const
+{
+	const Float4x4& transform = m_transforms[index];
+	return MakeFloat3(transform.m[3][0], transform.m[3][1], transform.m[3][2]);
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::RenderPosition(uint32_t index, Float3 position)
+{
+	// The translation row is already final; only the rotation part waits for UpdateTransforms.
+	Float4x4& transform = m_transforms[index];
+	transform.m[3][0] = position.x;
+	transform.m[3][1] = position.y;
+	transform.m[3][2] = position.z;
+	m_transformDirty[index] = 1;
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::Basis(uint32_t index, const Float4x4& basis)
+{
+	m_bases[index] = basis;
+	m_transformDirty[index] = 1;
+}
+
+//----------------------------------------------------------------------
+
+void EntityStore::FacingTarget(uint32_t index, EntityHandle target)
+{
+	m_facingTargets[index] = target;
+	m_transformDirty[index] = 1;
+}
+
+//----------------------------------------------------------------------
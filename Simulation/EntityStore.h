@@ -0,0 +1,120 @@
+#pragma once
+
+// EntityStore:
+// Holds the per-entity data of every object in the scene as a structure of
+// arrays.  Positions and velocities are split into one contiguous array per
+// axis, model matrices and render handles have arrays of their own, and all of
+// them are indexed by the same dense index.  Systems that only need positions
+// walk the position arrays linearly without touching anything else.
+//
+// Entities are referred to by an EntityHandle, which stays valid until the
+// entity is destroyed even though destroying other entities moves data around
+// to keep the arrays dense.  Index() turns a handle into the current dense index.
+//
+// The model matrix in Transforms() is rebuilt lazily.  Moving where an entity is
+// drawn (RenderPosition), changing its basis or what it faces only writes the
+// new value and marks the entity dirty; UpdateTransforms() (TransformSystem.h)
+// then rebuilds the matrices of every dirty entity in one pass per frame.
+
+#include "SimMath.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	struct EntityHandle
+	{
+		uint32_t slot;
+		uint32_t generation;
+	};
+
+	inline bool operator==(EntityHandle a, EntityHandle b)  { return a.slot == b.slot && a.generation == b.generation; }
+	inline bool operator!=(EntityHandle a, EntityHandle b)  { return !(a == b); }
+
+	static const EntityHandle InvalidEntity = { 0xffffffff, 0 };
+
+	// Identifies the mesh and material an entity is drawn with.  The ids are
+	// assigned by the renderer; NoRenderResource means the entity isn't drawn.
+	struct RenderHandle
+	{
+		uint16_t mesh;
+		uint16_t material;
+	};
+
+	static const uint16_t NoRenderResource = 0xffff;
+
+	class EntityStore
+	{
+	public:
+		EntityStore();
+
+		EntityHandle Create(Float3 position);
+		void Destroy(EntityHandle entity);
+		void Clear();
+		void Reserve(uint32_t count);
+
+		bool Valid(EntityHandle entity) const;
+		uint32_t Index(EntityHandle entity) const   { return m_slotIndex[entity.slot]; }
+		EntityHandle Handle(uint32_t index) const   { return m_handles[index]; }
+		uint32_t Count() const                      { return static_cast<uint32_t>(m_handles.size()); }
+
+		Float3 Position(uint32_t index) const       { return MakeFloat3(m_positionX[index], m_positionY[index], m_positionZ[index]); }
+		void Position(uint32_t index, Float3 position);
+		Float3 Velocity(uint32_t index) const       { return MakeFloat3(m_velocityX[index], m_velocityY[index], m_velocityZ[index]); }
+		void Velocity(uint32_t index, Float3 velocity);
+
+		// Where the entity is drawn, which may differ from its simulated position.
+		Float3 RenderPosition(uint32_t index) const;
+		void RenderPosition(uint32_t index, Float3 position);
+		// Scale and rotation applied before the entity is turned to face its target.
+		void Basis(uint32_t index, const Float4x4& basis);
+		// Turn the entity about y to face another entity; InvalidEntity to stop facing.
+		void FacingTarget(uint32_t index, EntityHandle target);
+		void MarkTransformDirty(uint32_t index)     { m_transformDirty[index] = 1; }
+
+		float* PositionX()                          { return m_positionX.data(); }
+		float* PositionY()                          { return m_positionY.data(); }
+		float* PositionZ()                          { return m_positionZ.data(); }
+		float* VelocityX()                          { return m_velocityX.data(); }
+		float* VelocityY()                          { return m_velocityY.data(); }
+		float* VelocityZ()                          { return m_velocityZ.data(); }
+		Float4x4* Transforms()                      { return m_transforms.data(); }
+		RenderHandle* RenderHandles()               { return m_renderHandles.data(); }
+		Float4x4* Bases()                           { return m_bases.data(); }
+		EntityHandle* FacingTargets()               { return m_facingTargets.data(); }
+		uint8_t* TransformDirty()                   { return m_transformDirty.data(); }
+
+		const float* PositionX() const              { return m_positionX.data(); }
+		const float* PositionY() const              { return m_positionY.data(); }
+		const float* PositionZ() const              { return m_positionZ.data(); }
+		const float* VelocityX() const              { return m_velocityX.data(); }
+		const float* VelocityY() const              { return m_velocityY.data(); }
+		const float* VelocityZ() const              { return m_velocityZ.data(); }
+		const Float4x4* Transforms() const          { return m_transforms.data(); }
+		const RenderHandle* RenderHandles() const   { return m_renderHandles.data(); }
+		const Float4x4* Bases() const               { return m_bases.data(); }
+		const EntityHandle* FacingTargets() const   { return m_facingTargets.data(); }
+		const uint8_t* TransformDirty() const       { return m_transformDirty.data(); }
+
+	private:
+		// Dense component arrays.
+		std::vector<float>          m_positionX;
+		std::vector<float>          m_positionY;
+		std::vector<float>          m_positionZ;
+		std::vector<float>          m_velocityX;
+		std::vector<float>          m_velocityY;
+		std::vector<float>          m_velocityZ;
+		std::vector<Float4x4>       m_transforms;
+		std::vector<RenderHandle>   m_renderHandles;
+		std::vector<Float4x4>       m_bases;
+		std::vector<EntityHandle>   m_facingTargets;
+		std::vector<uint8_t>        m_transformDirty;
+		std::vector<EntityHandle>   m_handles;          // Handle of the entity stored at each dense index.
+
+		// Sparse slot table that keeps handles stable.
+		std::vector<uint32_t>       m_slotIndex;        // Dense index of the entity in each slot.
+		std::vector<uint32_t>       m_slotGeneration;   // Bumped every time the slot is freed.
+		std::vector<uint32_t>       m_freeSlots;
+	};
+}
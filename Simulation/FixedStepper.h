@@ -0,0 +1,66 @@
+#pragma once
+
+// FixedStepper:
+// Converts variable length rendered frames into a number of fixed length
+// simulation steps.  Frame time is accumulated and whole steps are taken out
+// of the accumulator; the fraction of a step left over is reported by Alpha()
+// so the renderer can interpolate between the last two simulated states.
+// At most maxStepsPerFrame steps are run for one frame.  After a long stall
+// (suspend, debugger, paging) the time beyond that budget is dropped, so the
+// game slows down for a frame instead of spiraling into ever longer frames.
+
+#include <algorithm>
+
+namespace Simulation
+{
+	class FixedStepper
+	{
+	public:
+		FixedStepper(float stepLength, int maxStepsPerFrame) :
+			m_stepLength(stepLength),
+			m_maxStepsPerFrame(maxStepsPerFrame),
+			m_accumulator(0.0f),
+			m_droppedTime(0.0f)
+		{
+		}
+
+		void Reset()
+		{
+			m_accumulator = 0.0f;
+			m_droppedTime = 0.0f;
+		}
+
+		// Add a rendered frame and return the number of steps to simulate for it.
+		int Accumulate(float frameTime)
+		{
+			m_accumulator += std::max(frameTime, 0.0f);
+
+			int steps = static_cast<int>(m_accumulator / m_stepLength);
+			if (steps > m_maxStepsPerFrame)
+			{
+				steps = m_maxStepsPerFrame;
+				float keep = m_stepLength * m_maxStepsPerFrame;
+				m_droppedTime += m_accumulator - keep;
+				m_accumulator = keep;
+			}
+			m_accumulator -= steps * m_stepLength;
+			m_accumulator = std::max(m_accumulator, 0.0f);
+			return steps;
+		}
+
+		// How far the rendered frame is between the previous and the current step, in [0, 1).
+		float Alpha() const                         { return std::min(m_accumulator / m_stepLength, 1.0f); }
+
+		// Total frame time discarded because a frame exceeded the step budget.
+		float DroppedTime() const                   { return m_droppedTime; }
+
+		float StepLength() const                    { return m_stepLength; }
+		int MaxStepsPerFrame() const                { return m_maxStepsPerFrame; }
+
+	private:
+		float m_stepLength;
+		int   m_maxStepsPerFrame;
+		float m_accumulator;
+		float m_droppedTime;
+	};
+}
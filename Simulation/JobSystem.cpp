@@ -0,0 +1,153 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+JobSystem::JobSystem(uint32_t threadCount) :
+	m_threadCount(threadCount > 0 ? threadCount : 1),
+	m_generation(0),
+	m_quit(false),
+	m_body(nullptr),
+	m_remaining(0)
+{
+	m_queues.reset(new WorkQueue[m_threadCount]);
+	for (uint32_t thread = 1; thread < m_threadCount; thread++)
+	{
+		m_workers.push_back(std::thread(&JobSystem::WorkerLoop, this, thread));
+	}
+}
+
+//----------------------------------------------------------------------
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+//----------------------------------------------------------------------
+
+bool JobSystem::RunChunk(uint32_t thread)
+{
+	Chunk chunk;
+	bool found = false;
+
+	// Newest chunk from our own queue first, then the oldest from everyone else's.
+	for (uint32_t offset = 0; offset < m_threadCount && !found; offset++)
+	{
+		WorkQueue& queue = m_queues[(thread + offset) % m_threadCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.chunks.empty())
+		{
+			if (offset == 0)
+			{
+				chunk = queue.chunks.back();
+				queue.chunks.pop_back();
+			}
+			else
+			{
+				chunk = queue.chunks.front();
+				queue.chunks.pop_front();
+			}
+			found = true;
+		}
+	}
+
+	if (found)
+	{
+		(*m_body)(chunk.begin, chunk.end);
+		m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+	}
+	return found;
+}
+
+//----------------------------------------------------------------------
+
+void JobSystem::WorkerLoop(uint32_t thread)
+{
+	uint64_t generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&]() { return m_quit || m_generation != generation; });
+			if (m_quit)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		while (RunChunk(thread))
+		{
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	if (grain == 0)
+	{
+		grain = 1;
+	}
+
+	uint32_t chunkCount = (count + grain - 1) / grain;
+	if (m_threadCount == 1 || chunkCount == 1)
+	{
+		body(0, count);
+		return;
+	}
+
+	m_body = &body;
+	m_remaining.store(chunkCount, std::memory_order_relaxed);
+
+	// Deal the chunks out in contiguous runs so each thread starts on neighboring data.
+	for (uint32_t thread = 0; thread < m_threadCount; thread++)
+	{
+		uint32_t firstChunk = chunkCount * thread / m_threadCount;
+		uint32_t lastChunk = chunkCount * (thread + 1) / m_threadCount;
+
+		WorkQueue& queue = m_queues[thread];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		for (uint32_t chunk = lastChunk; chunk > firstChunk; chunk--)
+		{
+			// Pushed in reverse so the owner, which takes from the back, runs them in order.
+			Chunk range = { (chunk - 1) * grain, std::min(chunk * grain, count) };
+			queue.chunks.push_back(range);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	while (m_remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (!RunChunk(0))
+		{
+			std::this_thread::yield();
+		}
+	}
+	m_body = nullptr;
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,69 @@
+#pragma once
+
+// JobSystem:
+// A fixed pool of worker threads for data-parallel simulation work.
+// ParallelFor() cuts a range into chunks and deals them out to a queue per
+// thread.  Each thread works through its own queue from the back and, when it
+// runs dry, steals from the front of the others', so a thread that drew cheap
+// chunks helps out the rest.  The calling thread takes part as thread 0 and
+// ParallelFor() returns once every chunk has run.
+//
+// Which thread runs which chunk isn't fixed, so work given to ParallelFor()
+// must produce the same result whatever the order its chunks run in.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Simulation
+{
+	class JobSystem
+	{
+	public:
+		// threadCount includes the calling thread; a count of 1 runs everything inline.
+		explicit JobSystem(uint32_t threadCount);
+		~JobSystem();
+
+		uint32_t ThreadCount() const                { return m_threadCount; }
+
+		// Call body(begin, end) for chunks of at most 'grain' items covering [0, count).
+		void ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& body);
+
+	private:
+		JobSystem(const JobSystem&);
+		JobSystem& operator=(const JobSystem&);
+
+		struct Chunk
+		{
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex        mutex;
+			std::deque<Chunk> chunks;
+		};
+
+		void WorkerLoop(uint32_t thread);
+		bool RunChunk(uint32_t thread);
+
+		uint32_t                                        m_threadCount;
+		std::unique_ptr<WorkQueue[]>                    m_queues;
+		std::vector<std::thread>                        m_workers;
+
+		std::mutex                                      m_mutex;
+		std::condition_variable                         m_wake;
+		uint64_t                                        m_generation;    // Bumped for each ParallelFor.
+		bool                                            m_quit;
+
+		const std::function<void(uint32_t, uint32_t)>*  m_body;
+		std::atomic<uint32_t>                           m_remaining;     // Chunks not yet finished.
+	};
+}
@@ -0,0 +1,357 @@
+#include "Replay.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+namespace
+{
+	const char    ReplayMagic[4] = { 'S', 'U', 'M', 'R' };
+	const size_t  HeaderSize = 4 + 2 + 1 + 1 + 8 + 4 + 4 + 8 + 16 + 16;
+	const uint8_t SmartPlanningFlag = 1;
+
+	// The last version without the AI timings and planner settings.
+	const uint16_t SettingsFreeVersion = 2;
+
+	class ReplayWriter
+	{
+	public:
+		explicit ReplayWriter(std::vector<uint8_t>& data) : m_data(data) {}
+
+		void Bytes(const void* bytes, size_t size)
+		{
+			const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+			m_data.insert(m_data.end(), begin, begin + size);
+		}
+
+		void UInt(uint64_t value, int size)
+		{
+			for (int i = 0; i < size; i++)
+			{
+				m_data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+			}
+		}
+
+		void VarUInt(uint32_t value)
+		{
+			while (value >= 0x80)
+			{
+				m_data.push_back(static_cast<uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+			m_data.push_back(static_cast<uint8_t>(value));
+		}
+
+		void Float(float value)
+		{
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			UInt(bits, 4);
+		}
+
+	private:
+		std::vector<uint8_t>& m_data;
+	};
+
+	class ReplayReader
+	{
+	public:
+		ReplayReader(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_offset(0), m_failed(false) {}
+
+		bool Failed() const         { return m_failed; }
+		bool AtEnd() const          { return m_offset == m_size; }
+
+		bool Bytes(void* bytes, size_t size)
+		{
+			if (!Require(size))
+			{
+				return false;
+			}
+			memcpy(bytes, m_data + m_offset, size);
+			m_offset += size;
+			return true;
+		}
+
+		uint64_t UInt(int size)
+		{
+			uint64_t value = 0;
+			if (Require(size))
+			{
+				for (int i = 0; i < size; i++)
+				{
+					value |= static_cast<uint64_t>(m_data[m_offset++]) << (8 * i);
+				}
+			}
+			return value;
+		}
+
+		uint32_t VarUInt()
+		{
+			uint32_t value = 0;
+			for (int shift = 0; shift < 35; shift += 7)
+			{
+				if (!Require(1))
+				{
+					return 0;
+				}
+				uint8_t byte = m_data[m_offset++];
+				value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return value;
+				}
+			}
+			m_failed = true;
+			return 0;
+		}
+
+		float Float()
+		{
+			uint32_t bits = static_cast<uint32_t>(UInt(4));
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+	private:
+		bool Require(size_t size)
+		{
+			if (m_failed || m_size - m_offset < size)
+			{
+				m_failed = true;
+				return false;
+			}
+			return true;
+		}
+
+		const uint8_t* m_data;
+		size_t         m_size;
+		size_t         m_offset;
+		bool           m_failed;
+	};
+
+	bool SameInput(const TickInput& a, const TickInput& b)
+	{
+		// Compare the bits so that -0.0f and 0.0f are kept distinct.
+		return memcmp(&a.playerVelocity, &b.playerVelocity, sizeof(Float3)) == 0;
+	}
+}
+
+//----------------------------------------------------------------------
+
+Replay::Replay() :
+	m_enemyBehavior(GameConstants::Easy),
+	m_seed(0),
+	m_enemyTimings(DefaultAITimings()),
+	m_planning(false),
+	m_plannerSettings(DefaultPlannerSettings()),
+	m_finalChecksum(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void Replay::Begin(const SumoSimulation& simulation, GameConstants::Behavior enemyBehavior, uint64_t seed)
+{
+	m_enemyBehavior = enemyBehavior;
+	m_seed = seed;
+	m_enemyTimings = simulation.EnemyTimings();
+	m_planning = simulation.SmartPlanning();
+	m_plannerSettings = simulation.SmartPlanningSettings();
+	m_finalChecksum = 0;
+	m_inputs.clear();
+}
+
+//----------------------------------------------------------------------
+
+void Replay::Record(const TickInput& input)
+{
+	m_inputs.push_back(input);
+}
+
+//----------------------------------------------------------------------
+
+void Replay::Finish(uint64_t finalChecksum)
+{
+	m_finalChecksum = finalChecksum;
+}
+
+//----------------------------------------------------------------------
+
+void Replay::Start(SumoSimulation& simulation) const
+{
+	// The timings take effect from the Reset().
+	simulation.EnemyTimings(m_enemyTimings);
+	simulation.SmartPlanning(m_planning, m_plannerSettings);
+	simulation.Reset(m_enemyBehavior, m_seed);
+}
+
+//----------------------------------------------------------------------
+
+bool Replay::Play(SumoSimulation& simulation) const
+{
+	Start(simulation);
+	for (auto input = m_inputs.begin(); input != m_inputs.end(); input++)
+	{
+		simulation.Tick(*input);
+	}
+	return simulation.Checksum() == m_finalChecksum;
+}
+
+//----------------------------------------------------------------------
+
+std::vector<uint8_t> Replay::Serialize() const
+{
+	std::vector<uint8_t> data;
+	data.reserve(HeaderSize + 16);
+
+	ReplayWriter writer(data);
+	writer.Bytes(ReplayMagic, sizeof(ReplayMagic));
+	writer.UInt(Version, 2);
+	writer.UInt(static_cast<uint8_t>(m_enemyBehavior), 1);
+	writer.UInt(m_planning ? SmartPlanningFlag : 0, 1);
+	writer.UInt(m_seed, 8);
+	writer.Float(GameConstants::Physics::FrameLength);
+	writer.UInt(TickCount(), 4);
+	writer.UInt(m_finalChecksum, 8);
+	writer.Float(m_enemyTimings.initialDelay);
+	writer.Float(m_enemyTimings.minimumDelay);
+	writer.Float(m_enemyTimings.delayStep);
+	writer.UInt(static_cast<uint32_t>(m_enemyTimings.delayChoices), 4);
+	writer.UInt(m_plannerSettings.budgetMicroseconds, 4);
+	writer.UInt(m_plannerSettings.iterationLimit, 4);
+	writer.Float(m_plannerSettings.horizon);
+	writer.Float(m_plannerSettings.rolloutStep);
+
+	size_t tick = 0;
+	while (tick < m_inputs.size())
+	{
+		uint32_t count = 1;
+		while (tick + count < m_inputs.size() && SameInput(m_inputs[tick + count], m_inputs[tick]))
+		{
+			count++;
+		}
+
+		writer.VarUInt(count);
+		writer.Float(m_inputs[tick].playerVelocity.x);
+		writer.Float(m_inputs[tick].playerVelocity.y);
+		writer.Float(m_inputs[tick].playerVelocity.z);
+		tick += count;
+	}
+	return data;
+}
+
+//----------------------------------------------------------------------
+
+bool Replay::Deserialize(const uint8_t* data, size_t size)
+{
+	ReplayReader reader(data, size);
+
+	char magic[4];
+	if (!reader.Bytes(magic, sizeof(magic)) || memcmp(magic, ReplayMagic, sizeof(magic)) != 0)
+	{
+		return false;
+	}
+
+	uint16_t version = static_cast<uint16_t>(reader.UInt(2));
+	uint8_t behavior = static_cast<uint8_t>(reader.UInt(1));
+	uint8_t flags = static_cast<uint8_t>(reader.UInt(1));
+	uint64_t seed = reader.UInt(8);
+	float tickLength = reader.Float();
+	uint32_t tickCount = static_cast<uint32_t>(reader.UInt(4));
+	uint64_t finalChecksum = reader.UInt(8);
+
+	AITimings timings = DefaultAITimings();
+	bool planning = false;
+	PlannerSettings plannerSettings = DefaultPlannerSettings();
+	if (version == Version)
+	{
+		timings.initialDelay = reader.Float();
+		timings.minimumDelay = reader.Float();
+		timings.delayStep = reader.Float();
+		timings.delayChoices = static_cast<int>(reader.UInt(4));
+		planning = (flags & SmartPlanningFlag) != 0;
+		plannerSettings.budgetMicroseconds = static_cast<uint32_t>(reader.UInt(4));
+		plannerSettings.iterationLimit = static_cast<uint32_t>(reader.UInt(4));
+		plannerSettings.horizon = reader.Float();
+		plannerSettings.rolloutStep = reader.Float();
+	}
+
+	// A replay only reproduces the match if it was recorded with the same tick length.
+	if (reader.Failed() || (version != Version && version != SettingsFreeVersion) ||
+		behavior > GameConstants::Smart || tickLength != GameConstants::Physics::FrameLength ||
+		timings.delayChoices <= 0)
+	{
+		return false;
+	}
+
+	std::vector<TickInput> inputs;
+	while (!reader.AtEnd())
+	{
+		uint32_t count = reader.VarUInt();
+		TickInput input;
+		input.playerVelocity.x = reader.Float();
+		input.playerVelocity.y = reader.Float();
+		input.playerVelocity.z = reader.Float();
+		if (reader.Failed() || count == 0 || count > tickCount - inputs.size())
+		{
+			return false;
+		}
+		inputs.insert(inputs.end(), count, input);
+	}
+	if (inputs.size() != tickCount)
+	{
+		return false;
+	}
+
+	m_enemyBehavior = static_cast<GameConstants::Behavior>(behavior);
+	m_seed = seed;
+	m_enemyTimings = timings;
+	m_planning = planning;
+	m_plannerSettings = plannerSettings;
+	m_finalChecksum = finalChecksum;
+	m_inputs.swap(inputs);
+	return true;
+}
+
+//----------------------------------------------------------------------
+
+bool Replay::Save(const char* path) const
+{
+	std::vector<uint8_t> data = Serialize();
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+	return (fclose(file) == 0) && written;
+}
+
+//----------------------------------------------------------------------
+
+bool Replay::Load(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+	uint8_t buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		data.insert(data.end(), buffer, buffer + read);
+	}
+	fclose(file);
+
+	return Deserialize(data.data(), data.size());
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,82 @@
+#pragma once
+
+// Replay:
+// This class records everything needed to reproduce a match run through
+// SumoSimulation::Tick(): the seed, the enemy behavior, the AI timings, whether
+// a Smart enemy plans and with what settings, and the input of every tick, plus
+// a checksum of the final state.  Playing a replay back on the same build
+// reproduces the recorded positions bit for bit, which makes replays suitable
+// as fixed workloads for regression benchmarks.  A planned match only plays back
+// if it was planned with an iteration limit and no time budget.
+//
+// The binary format is little-endian:
+//     char[4]  "SUMR"
+//     uint16   version
+//     uint8    enemy behavior
+//     uint8    flags (bit 0: smart planning)
+//     uint64   seed
+//     float32  tick length in seconds
+//     uint32   tick count
+//     uint64   final state checksum
+//     float32  AI initial delay, minimum delay and delay step
+//     uint32   AI delay choices
+//     uint32   planner budget in microseconds, planner iteration limit
+//     float32  planner horizon, planner rollout step
+//     runs of  { varint repeat count, float32 x, float32 y, float32 z }
+// Consecutive ticks with identical input are stored as a single run, so a held
+// key costs a handful of bytes regardless of how long it is held.  Version 2
+// replays, which have no AI or planner fields and a reserved byte for the flags,
+// still load and play with the default timings and no planning.
+
+#include "SumoSimulation.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	class Replay
+	{
+	public:
+		static const uint16_t Version = 3;
+
+		Replay();
+
+		// Recording.  Begin() takes the AI timings and planner settings from the
+		// simulation the match will be played on.
+		void Begin(const SumoSimulation& simulation, GameConstants::Behavior enemyBehavior, uint64_t seed);
+		void Record(const TickInput& input);
+		void Finish(uint64_t finalChecksum);
+
+		// Playback.  Start() applies the recorded settings and resets the simulation
+		// to the recorded initial state;
+		// Play() then runs every recorded tick and reports whether the final state
+		// matches the recorded checksum.
+		void Start(SumoSimulation& simulation) const;
+		bool Play(SumoSimulation& simulation) const;
+
+		std::vector<uint8_t> Serialize() const;
+		bool Deserialize(const uint8_t* data, size_t size);
+
+		bool Save(const char* path) const;
+		bool Load(const char* path);
+
+		uint32_t TickCount() const                          { return static_cast<uint32_t>(m_inputs.size()); }
+		const TickInput& Input(uint32_t tick) const         { return m_inputs[tick]; }
+		uint64_t Seed() const                               { return m_seed; }
+		GameConstants::Behavior EnemyBehavior() const       { return m_enemyBehavior; }
+		const AITimings& EnemyTimings() const               { return m_enemyTimings; }
+		bool SmartPlanning() const                          { return m_planning; }
+		const PlannerSettings& SmartPlanningSettings() const { return m_plannerSettings; }
+		uint64_t FinalChecksum() const                      { return m_finalChecksum; }
+
+	private:
+		GameConstants::Behavior m_enemyBehavior;
+		uint64_t                m_seed;
+		AITimings               m_enemyTimings;
+		bool                    m_planning;
+		PlannerSettings         m_plannerSettings;
+		uint64_t                m_finalChecksum;
+		std::vector<TickInput>  m_inputs;
+	};
+}
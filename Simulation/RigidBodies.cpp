@@ -0,0 +1,329 @@
+#include "RigidBodies.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_IMPULSE_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Simulation;
+
+namespace
+{
+	// Contacts handed to a thread at a time.
+	const uint32_t ImpulseGrain = 1024;
+}
+
+//----------------------------------------------------------------------
+
+RigidBodies::RigidBodies() :
+	m_settings(DefaultBodySettings()),
+	m_awakeCount(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void RigidBodies::Reset(uint32_t count)
+{
+	m_driveX.assign(count, 0.0f);
+	m_driveZ.assign(count, 0.0f);
+	m_velocityX.assign(count, 0.0f);
+	m_velocityZ.assign(count, 0.0f);
+	m_inverseMass.assign(count, 1.0f / m_settings.mass);
+	m_awake.assign(count, 1);
+	m_stillTicks.assign(count, 0);
+	m_anchorX.assign(count, 0.0f);
+	m_anchorZ.assign(count, 0.0f);
+	m_restDriveX.assign(count, 0.0f);
+	m_restDriveZ.assign(count, 0.0f);
+	m_awakeCount = count;
+}
+
+//----------------------------------------------------------------------
+
+void RigidBodies::Remove(uint32_t index)
+{
+	m_awakeCount -= m_awake[index];
+	m_driveX[index] = m_driveX.back();
+	m_driveX.pop_back();
+	m_driveZ[index] = m_driveZ.back();
+	m_driveZ.pop_back();
+	m_velocityX[index] = m_velocityX.back();
+	m_velocityX.pop_back();
+	m_velocityZ[index] = m_velocityZ.back();
+	m_velocityZ.pop_back();
+	m_inverseMass[index] = m_inverseMass.back();
+	m_inverseMass.pop_back();
+	m_awake[index] = m_awake.back();
+	m_awake.pop_back();
+	m_stillTicks[index] = m_stillTicks.back();
+	m_stillTicks.pop_back();
+	m_anchorX[index] = m_anchorX.back();
+	m_anchorX.pop_back();
+	m_anchorZ[index] = m_anchorZ.back();
+	m_anchorZ.pop_back();
+	m_restDriveX[index] = m_restDriveX.back();
+	m_restDriveX.pop_back();
+	m_restDriveZ[index] = m_restDriveZ.back();
+	m_restDriveZ.pop_back();
+}
+
+//----------------------------------------------------------------------
+
+void RigidBodies::ApplyDrive()
+{
+	uint32_t count = Count();
+	float friction = m_settings.friction;
+	float threshold = m_settings.restThreshold * 2.0f;
+	m_awakeCount = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (m_awake[i] == 0)
+		{
+			float turnX = m_driveX[i] - m_restDriveX[i];
+			float turnZ = m_driveZ[i] - m_restDriveZ[i];
+			if (turnX * turnX + turnZ * turnZ >= threshold)
+			{
+				m_awake[i] = 1;
+				m_stillTicks[i] = 0;
+			}
+		}
+		if (m_awake[i] != 0)
+		{
+			m_velocityX[i] = m_driveX[i] + (m_velocityX[i] - m_driveX[i]) * friction;
+			m_velocityZ[i] = m_driveZ[i] + (m_velocityZ[i] - m_driveZ[i]) * friction;
+		}
+		m_awakeCount += m_awake[i];
+	}
+}
+
+//----------------------------------------------------------------------
+
+void RigidBodies::SolveContacts(const EntityStore& entities, const ContactColoring& batches, JobSystem* jobs)
+{
+	const float* positionX = entities.PositionX();
+	const float* positionZ = entities.PositionZ();
+	float* velocityX = m_velocityX.data();
+	float* velocityZ = m_velocityZ.data();
+	const float* inverseMass = m_inverseMass.data();
+	uint8_t* awake = m_awake.data();
+	float restitution = m_settings.restitution;
+
+	// No two contacts in a batch share a body, so each one is solved in place.
+	for (uint32_t batch = 0; batch < batches.BatchCount(); batch++)
+	{
+		Span<const ContactPair> pairs = batches.Batch(batch);
+		uint32_t pairCount = static_cast<uint32_t>(pairs.size());
+		if (batches.Serial(batch))
+		{
+			ApplyContactImpulsesScalar(pairs.begin(), pairCount, positionX, positionZ, inverseMass, restitution,
+				velocityX, velocityZ, awake);
+		}
+		else if (jobs != nullptr)
+		{
+			jobs->ParallelFor(pairCount, ImpulseGrain, [&](uint32_t begin, uint32_t end)
+			{
+				ApplyContactImpulses(pairs.begin() + begin, end - begin, positionX, positionZ, inverseMass, restitution,
+					velocityX, velocityZ, awake);
+			});
+		}
+		else
+		{
+			ApplyContactImpulses(pairs.begin(), pairCount, positionX, positionZ, inverseMass, restitution,
+				velocityX, velocityZ, awake);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void RigidBodies::Integrate(EntityStore& entities, float deltaTime)
+{
+	uint32_t count = Count();
+	float* positionX = entities.PositionX();
+	float* positionZ = entities.PositionZ();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (m_awake[i] != 0)
+		{
+			positionX[i] += m_velocityX[i] * deltaTime;
+			positionZ[i] += m_velocityZ[i] * deltaTime;
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void RigidBodies::Sleep(const EntityStore& entities, float deltaTime)
+{
+	uint32_t count = Count();
+	uint8_t restTicks = static_cast<uint8_t>(std::min(std::max(m_settings.restTicks, 1), 255));
+	// How far a body may drift over restTicks ticks at the rest speed, squared.  The
+	// rest speed is where the kinetic energy per unit mass is the threshold.
+	float drift = deltaTime * restTicks;
+	float driftSquared = m_settings.restThreshold * 2.0f * drift * drift;
+	const float* positionX = entities.PositionX();
+	const float* positionZ = entities.PositionZ();
+	m_awakeCount = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (m_awake[i] == 0)
+		{
+			continue;
+		}
+
+		// Where the body really is, contacts and push-apart included, measured from
+		// where it started keeping still, so jostling in place counts as still.
+		float driftX = positionX[i] - m_anchorX[i];
+		float driftZ = positionZ[i] - m_anchorZ[i];
+		if (m_stillTicks[i] == 0 || driftX * driftX + driftZ * driftZ >= driftSquared)
+		{
+			m_anchorX[i] = positionX[i];
+			m_anchorZ[i] = positionZ[i];
+			m_stillTicks[i] = 0;
+		}
+		m_stillTicks[i]++;
+		if (m_stillTicks[i] > restTicks)
+		{
+			m_awake[i] = 0;
+			m_stillTicks[i] = 0;
+			m_velocityX[i] = 0.0f;
+			m_velocityZ[i] = 0.0f;
+			m_restDriveX[i] = m_driveX[i];
+			m_restDriveZ[i] = m_driveZ[i];
+		}
+		m_awakeCount += m_awake[i];
+	}
+}
+
+//----------------------------------------------------------------------
+
+// Apply one pair's impulse 'impulse' along the normal (normalX, normalZ).
+static inline void ApplyImpulse(uint32_t a, uint32_t b, float normalX, float normalZ, float impulse,
+	const float* inverseMass, float* velocityX, float* velocityZ, uint8_t* awake)
+{
+	float impulseA = impulse * inverseMass[a];
+	float impulseB = impulse * inverseMass[b];
+	velocityX[a] -= normalX * impulseA;
+	velocityZ[a] -= normalZ * impulseA;
+	velocityX[b] += normalX * impulseB;
+	velocityZ[b] += normalZ * impulseB;
+	awake[a] = 1;
+	awake[b] = 1;
+}
+
+void Simulation::ApplyContactImpulsesScalar(const ContactPair* pairs, uint32_t pairCount, const float* positionX, const float* positionZ,
+	const float* inverseMass, float restitution, float* velocityX, float* velocityZ, uint8_t* awake)
+{
+	const float touchingSquared = GameConstants::Arena::SumoSize * GameConstants::Arena::SumoSize;
+	for (uint32_t i = 0; i < pairCount; i++)
+	{
+		uint32_t a = pairs[i].a;
+		uint32_t b = pairs[i].b;
+		float xDelta = positionX[b] - positionX[a];
+		float zDelta = positionZ[b] - positionZ[a];
+		float distanceSquared = xDelta * xDelta + zDelta * zDelta;
+		if (!(distanceSquared < touchingSquared && distanceSquared > 0.0f))
+		{
+			continue;
+		}
+
+		float distance = std::sqrt(distanceSquared);
+		float normalX = xDelta / distance;
+		float normalZ = zDelta / distance;
+		float closing = (velocityX[b] - velocityX[a]) * normalX + (velocityZ[b] - velocityZ[a]) * normalZ;
+		if (closing < 0.0f)
+		{
+			float impulse = -(1.0f + restitution) * closing / (inverseMass[a] + inverseMass[b]);
+			ApplyImpulse(a, b, normalX, normalZ, impulse, inverseMass, velocityX, velocityZ, awake);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+#if defined(SUMO_IMPULSE_SSE2)
+
+void Simulation::ApplyContactImpulses(const ContactPair* pairs, uint32_t pairCount, const float* positionX, const float* positionZ,
+	const float* inverseMass, float restitution, float* velocityX, float* velocityZ, uint8_t* awake)
+{
+	const __m128 touchingSquared = _mm_set1_ps(GameConstants::Arena::SumoSize * GameConstants::Arena::SumoSize);
+	const __m128 bounce = _mm_set1_ps(-(1.0f + restitution));
+	const __m128 zero = _mm_setzero_ps();
+
+	float normalXs[4];
+	float normalZs[4];
+	float impulses[4];
+
+	uint32_t i = 0;
+	for (; i + 4 <= pairCount; i += 4)
+	{
+		// SSE2 has no gather.
+		const ContactPair* batch = pairs + i;
+		__m128 ax = _mm_setr_ps(positionX[batch[0].a], positionX[batch[1].a], positionX[batch[2].a], positionX[batch[3].a]);
+		__m128 az = _mm_setr_ps(positionZ[batch[0].a], positionZ[batch[1].a], positionZ[batch[2].a], positionZ[batch[3].a]);
+		__m128 bx = _mm_setr_ps(positionX[batch[0].b], positionX[batch[1].b], positionX[batch[2].b], positionX[batch[3].b]);
+		__m128 bz = _mm_setr_ps(positionZ[batch[0].b], positionZ[batch[1].b], positionZ[batch[2].b], positionZ[batch[3].b]);
+
+		__m128 xDelta = _mm_sub_ps(bx, ax);
+		__m128 zDelta = _mm_sub_ps(bz, az);
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(xDelta, xDelta), _mm_mul_ps(zDelta, zDelta));
+		__m128 touching = _mm_and_ps(_mm_cmplt_ps(distanceSquared, touchingSquared), _mm_cmpgt_ps(distanceSquared, zero));
+
+		// Most pairs from the broadphase aren't touching; skip the velocities when none are.
+		if (_mm_movemask_ps(touching) == 0)
+		{
+			continue;
+		}
+
+		__m128 distance = _mm_sqrt_ps(distanceSquared);
+		__m128 normalX = _mm_div_ps(xDelta, distance);
+		__m128 normalZ = _mm_div_ps(zDelta, distance);
+
+		__m128 vax = _mm_setr_ps(velocityX[batch[0].a], velocityX[batch[1].a], velocityX[batch[2].a], velocityX[batch[3].a]);
+		__m128 vaz = _mm_setr_ps(velocityZ[batch[0].a], velocityZ[batch[1].a], velocityZ[batch[2].a], velocityZ[batch[3].a]);
+		__m128 vbx = _mm_setr_ps(velocityX[batch[0].b], velocityX[batch[1].b], velocityX[batch[2].b], velocityX[batch[3].b]);
+		__m128 vbz = _mm_setr_ps(velocityZ[batch[0].b], velocityZ[batch[1].b], velocityZ[batch[2].b], velocityZ[batch[3].b]);
+		__m128 closing = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(vbx, vax), normalX), _mm_mul_ps(_mm_sub_ps(vbz, vaz), normalZ));
+		__m128 hit = _mm_and_ps(touching, _mm_cmplt_ps(closing, zero));
+		int hits = _mm_movemask_ps(hit);
+		if (hits == 0)
+		{
+			continue;
+		}
+
+		__m128 ima = _mm_setr_ps(inverseMass[batch[0].a], inverseMass[batch[1].a], inverseMass[batch[2].a], inverseMass[batch[3].a]);
+		__m128 imb = _mm_setr_ps(inverseMass[batch[0].b], inverseMass[batch[1].b], inverseMass[batch[2].b], inverseMass[batch[3].b]);
+		__m128 impulse = _mm_div_ps(_mm_mul_ps(bounce, closing), _mm_add_ps(ima, imb));
+		_mm_storeu_ps(normalXs, normalX);
+		_mm_storeu_ps(normalZs, normalZ);
+		_mm_storeu_ps(impulses, impulse);
+
+		// No vector scatter; the pairs in a batch don't share bodies, so lane order doesn't matter.
+		for (uint32_t lane = 0; lane < 4; lane++)
+		{
+			if (hits & (1 << lane))
+			{
+				ApplyImpulse(batch[lane].a, batch[lane].b, normalXs[lane], normalZs[lane], impulses[lane],
+					inverseMass, velocityX, velocityZ, awake);
+			}
+		}
+	}
+
+	ApplyContactImpulsesScalar(pairs + i, pairCount - i, positionX, positionZ, inverseMass, restitution, velocityX, velocityZ, awake);
+}
+
+#else
+
+void Simulation::ApplyContactImpulses(const ContactPair* pairs, uint32_t pairCount, const float* positionX, const float* positionZ,
+	const float* inverseMass, float restitution, float* velocityX, float* velocityZ, uint8_t* awake)
+{
+	ApplyContactImpulsesScalar(pairs, pairCount, positionX, positionZ, inverseMass, restitution, velocityX, velocityZ, awake);
+}
+
+#endif
+
+//----------------------------------------------------------------------
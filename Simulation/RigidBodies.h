@@ -0,0 +1,128 @@
+#pragma once
+
+// RigidBodies:
+// Velocity-level dynamics for the sumos of an EntityStore, in place of moving
+// them straight to where their maneuver takes them.  Each body has a mass and a
+// velocity of its own, and the velocity its AI wants it to walk at (its drive).
+// A step of a body:
+//  - friction with the mat pulls the velocity towards the drive, keeping
+//    GameConstants::Physics::Friction of the difference each tick, so a sumo
+//    that is knocked back recovers its footing in a few ticks;
+//  - bodies that touch and are moving together exchange an impulse along the
+//    line between their centers, scaled by their masses, with a restitution of
+//    BounceTransfer * (1 - BounceLost);
+//  - the velocity moves the body, and any overlap left is pushed apart by the
+//    contact kernel as before;
+//  - a body that stays within the distance RestThreshold's speed covers in
+//    restTicks ticks of where it was for that long goes to sleep.  That is
+//    measured from where the body ends up, so a sumo walking into a jam it
+//    can't get through sleeps as well as one with no drive.  Sleeping bodies aren't moved and pairs of sleeping bodies aren't
+//    even looked at, so a resting or jammed crowd costs next to nothing.  A
+//    sleeping body wakes when its drive turns away from the one it fell asleep
+//    with by more than that speed, or when an awake body hits it.
+//
+// The contact impulses are solved a ContactColoring batch at a time, like the
+// positional contacts, so a step gives the same result on any number of threads.
+// Sumos stand on the mat and only move in x and z; GroundRestitution and
+// Gravity govern falling and bouncing, which sumos don't do.
+
+#include "../GameObjects/GameConstants.h"
+#include "EntityStore.h"
+#include "Broadphase.h"
+#include "ContactColoring.h"
+#include "JobSystem.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	struct BodySettings
+	{
+		float mass;
+		float restitution;
+		float friction;         // Share of the velocity off the drive kept each tick.
+		float restThreshold;    // Kinetic energy per unit mass below which a body is still.
+		int   restTicks;        // Ticks a body has to stay still before it sleeps.
+	};
+
+	inline BodySettings DefaultBodySettings()
+	{
+		BodySettings settings = {
+			GameConstants::Arena::SumoMass,
+			GameConstants::Physics::BounceTransfer * (1.0f - GameConstants::Physics::BounceLost),
+			GameConstants::Physics::Friction,
+			GameConstants::Physics::RestThreshold,
+			GameConstants::Arena::SumoRestTicks,
+		};
+		return settings;
+	}
+
+	class RigidBodies
+	{
+	public:
+		RigidBodies();
+
+		void Settings(const BodySettings& settings) { m_settings = settings; }
+		const BodySettings& Settings() const        { return m_settings; }
+
+		// Start 'count' awake bodies at rest, all of the settings' mass.
+		void Reset(uint32_t count);
+
+		// Mirror EntityStore::Destroy moving the last entity into 'index'.
+		void Remove(uint32_t index);
+
+		// Apply friction towards the drives and wake the bodies whose drive has turned.
+		// Until the next Sleep(), AwakeCount() then counts the bodies that can move
+		// this tick.
+		void ApplyDrive();
+
+		// Exchange impulses between the touching pairs, a batch at a time.
+		void SolveContacts(const EntityStore& entities, const ContactColoring& batches, JobSystem* jobs);
+
+		// Move the awake bodies along their velocities.
+		void Integrate(EntityStore& entities, float deltaTime);
+
+		// Put the bodies that have stayed still long enough to sleep.
+		void Sleep(const EntityStore& entities, float deltaTime);
+
+		uint32_t Count() const                      { return static_cast<uint32_t>(m_awake.size()); }
+		uint32_t AwakeCount() const                 { return m_awakeCount; }
+
+		// Indexed like the entities.
+		float* DriveX()                             { return m_driveX.data(); }
+		float* DriveZ()                             { return m_driveZ.data(); }
+		float* VelocityX()                          { return m_velocityX.data(); }
+		float* VelocityZ()                          { return m_velocityZ.data(); }
+		float* InverseMass()                        { return m_inverseMass.data(); }
+		const uint8_t* Awake() const                { return m_awake.data(); }
+		const float* VelocityX() const              { return m_velocityX.data(); }
+		const float* VelocityZ() const              { return m_velocityZ.data(); }
+		const float* InverseMass() const            { return m_inverseMass.data(); }
+
+	private:
+		BodySettings         m_settings;
+		std::vector<float>   m_driveX;
+		std::vector<float>   m_driveZ;
+		std::vector<float>   m_velocityX;
+		std::vector<float>   m_velocityZ;
+		std::vector<float>   m_inverseMass;
+		std::vector<uint8_t> m_awake;
+		std::vector<uint8_t> m_stillTicks;
+		std::vector<float>   m_anchorX;         // Where each body started keeping still.
+		std::vector<float>   m_anchorZ;
+		std::vector<float>   m_restDriveX;      // The drives the sleeping bodies fell asleep with.
+		std::vector<float>   m_restDriveZ;
+		uint32_t             m_awakeCount;
+	};
+
+	// Apply the impulses for the pairs of one ContactColoring batch in place.  Pairs
+	// that touch and are closing wake both bodies.  Uses SSE2 where available, with a
+	// scalar version of the same kernel for the rest.
+	void ApplyContactImpulses(const ContactPair* pairs, uint32_t pairCount, const float* positionX, const float* positionZ,
+		const float* inverseMass, float restitution, float* velocityX, float* velocityZ, uint8_t* awake);
+
+	// Always uses the scalar kernel, for comparison.
+	void ApplyContactImpulsesScalar(const ContactPair* pairs, uint32_t pairCount, const float* positionX, const float* positionZ,
+		const float* inverseMass, float restitution, float* velocityX, float* velocityZ, uint8_t* awake);
+}
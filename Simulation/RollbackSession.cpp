@@ -0,0 +1,348 @@
+#include "RollbackSession.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+namespace
+{
+	const uint32_t NoRollback = 0xFFFFFFFF;
+	const uint32_t MaxInputsPerPacket = 255;
+
+	class PacketWriter
+	{
+	public:
+		explicit PacketWriter(std::vector<uint8_t>& data) : m_data(data) {}
+
+		void UInt(uint32_t value, int size)
+		{
+			for (int i = 0; i < size; i++)
+			{
+				m_data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+			}
+		}
+
+		void Float(float value)
+		{
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			UInt(bits, 4);
+		}
+
+	private:
+		std::vector<uint8_t>& m_data;
+	};
+
+	class PacketReader
+	{
+	public:
+		explicit PacketReader(const std::vector<uint8_t>& data) : m_data(data), m_offset(0), m_failed(false) {}
+
+		bool Failed() const         { return m_failed; }
+		bool AtEnd() const          { return m_offset == m_data.size(); }
+
+		uint32_t UInt(int size)
+		{
+			uint32_t value = 0;
+			if (m_failed || m_data.size() - m_offset < static_cast<size_t>(size))
+			{
+				m_failed = true;
+				return 0;
+			}
+			for (int i = 0; i < size; i++)
+			{
+				value |= static_cast<uint32_t>(m_data[m_offset++]) << (8 * i);
+			}
+			return value;
+		}
+
+		float Float()
+		{
+			uint32_t bits = UInt(4);
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+	private:
+		const std::vector<uint8_t>& m_data;
+		size_t                      m_offset;
+		bool                        m_failed;
+	};
+
+	bool SameInput(const TickInput& a, const TickInput& b)
+	{
+		// Compare the bits, as the simulation would see them.
+		return memcmp(&a.playerVelocity, &b.playerVelocity, sizeof(Float3)) == 0;
+	}
+}
+
+//----------------------------------------------------------------------
+
+RollbackSession::RollbackSession(uint32_t localPlayer, Transport& transport, const RollbackSettings& settings) :
+	m_transport(transport),
+	m_settings(settings),
+	m_localPlayer(localPlayer)
+{
+	Start(0);
+}
+
+//----------------------------------------------------------------------
+
+void RollbackSession::Start(uint64_t seed)
+{
+	// The enemy's behavior doesn't matter, as no AI runs in a versus match.
+	m_simulation.Reset(GameConstants::Easy, seed);
+	m_frame = 0;
+	m_localInputs.clear();
+	m_remoteInputs.clear();
+	m_usedRemoteInputs.clear();
+	m_rollbackFrom = NoRollback;
+	m_remoteAck = 0;
+	m_remoteFrame = 0;
+	m_remoteAdvantage = 0;
+	m_lastWait = 0;
+
+	// A rollback goes back at most MaxPredictionFrames, and the current frame's state
+	// is saved before it runs.
+	m_states.resize(m_settings.maxPredictionFrames + 2);
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+//----------------------------------------------------------------------
+
+uint32_t RollbackSession::ConfirmedFrame() const
+{
+	return std::min(m_frame, static_cast<uint32_t>(m_remoteInputs.size()));
+}
+
+//----------------------------------------------------------------------
+
+FrameResult RollbackSession::AdvanceFrame(const TickInput& localInput)
+{
+	Receive();
+	Rollback();
+
+	FrameResult result = FrameResult::Advanced;
+	if (m_frame >= m_remoteInputs.size() + m_settings.maxPredictionFrames)
+	{
+		result = FrameResult::Stalled;
+		m_stats.stalls++;
+	}
+	else
+	{
+		// Each side's advantage includes the other's packets being in flight, so half
+		// the difference between them is how far this side is really ahead.
+		int32_t ahead = (FrameAdvantage() - m_remoteAdvantage) / 2;
+		if (ahead >= 1 && m_frame >= m_lastWait + m_settings.framesBetweenWaits)
+		{
+			m_lastWait = m_frame;
+			result = FrameResult::Waiting;
+			m_stats.waits++;
+		}
+	}
+
+	if (result == FrameResult::Advanced)
+	{
+		m_localInputs.push_back(localInput);
+		RunFrame(m_frame);
+		m_frame++;
+		m_stats.frames++;
+	}
+
+	// Send even when not advancing, so acknowledgements keep flowing and a lost
+	// packet is made good.
+	SendInputs();
+	return result;
+}
+
+//----------------------------------------------------------------------
+
+void RollbackSession::Poll()
+{
+	Receive();
+	Rollback();
+	SendInputs();
+}
+
+//----------------------------------------------------------------------
+
+void RollbackSession::Receive()
+{
+	while (m_transport.Receive(m_packet))
+	{
+		m_stats.packetsReceived++;
+		ReadPacket(m_packet);
+	}
+}
+
+//----------------------------------------------------------------------
+
+void RollbackSession::ReadPacket(const std::vector<uint8_t>& packet)
+{
+	PacketReader reader(packet);
+	uint32_t frame = reader.UInt(4);
+	int32_t advantage = static_cast<int16_t>(reader.UInt(2));
+	uint32_t ack = reader.UInt(4);
+	uint32_t first = reader.UInt(4);
+	uint32_t count = reader.UInt(1);
+	if (reader.Failed())
+	{
+		return;
+	}
+
+	// Packets can arrive out of order; only the newest says where the other peer is.
+	if (frame > m_remoteFrame)
+	{
+		m_remoteFrame = frame;
+		m_remoteAdvantage = advantage;
+	}
+	m_remoteAck = std::max(m_remoteAck, std::min(ack, m_frame));
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		TickInput input;
+		input.playerVelocity.x = reader.Float();
+		input.playerVelocity.y = reader.Float();
+		input.playerVelocity.z = reader.Float();
+		if (reader.Failed())
+		{
+			return;
+		}
+
+		// Take the inputs that continue the ones already received.  Anything past a gap
+		// will be sent again.
+		uint32_t inputFrame = first + i;
+		if (inputFrame < m_remoteInputs.size())
+		{
+			continue;
+		}
+		if (inputFrame > m_remoteInputs.size())
+		{
+			break;
+		}
+		m_remoteInputs.push_back(input);
+
+		if (inputFrame < m_frame && !SameInput(input, m_usedRemoteInputs[inputFrame]))
+		{
+			m_rollbackFrom = std::min(m_rollbackFrom, inputFrame);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void RollbackSession::Rollback()
+{
+	if (m_rollbackFrom >= m_frame)
+	{
+		m_rollbackFrom = NoRollback;
+		return;
+	}
+
+	// Go back to the start of the first mispredicted frame and run every frame since
+	// with the inputs there are now.
+	uint32_t from = m_rollbackFrom;
+	m_simulation.Restore(m_states[from % m_states.size()]);
+	for (uint32_t frame = from; frame < m_frame; frame++)
+	{
+		RunFrame(frame);
+	}
+
+	m_stats.rollbacks++;
+	m_stats.resimulatedFrames += m_frame - from;
+	m_stats.longestRollback = std::max(m_stats.longestRollback, m_frame - from);
+	m_rollbackFrom = NoRollback;
+}
+
+//----------------------------------------------------------------------
+
+void RollbackSession::RunFrame(uint32_t frame)
+{
+	m_simulation.Save(m_states[frame % m_states.size()]);
+
+	// Predict that the remote player carries on with their last known input.
+	TickInput remote;
+	if (frame < m_remoteInputs.size())
+	{
+		remote = m_remoteInputs[frame];
+	}
+	else if (!m_remoteInputs.empty())
+	{
+		remote = m_remoteInputs.back();
+	}
+	else
+	{
+		remote.playerVelocity = MakeFloat3(0.0f, 0.0f, 0.0f);
+	}
+	if (frame < m_usedRemoteInputs.size())
+	{
+		m_usedRemoteInputs[frame] = remote;
+	}
+	else
+	{
+		m_usedRemoteInputs.push_back(remote);
+	}
+
+	const TickInput& local = m_localInputs[frame];
+	const TickInput& player = (m_localPlayer == 0) ? local : remote;
+	const TickInput& enemy = (m_localPlayer == 0) ? remote : local;
+	for (uint32_t tick = 0; tick < m_settings.ticksPerFrame; tick++)
+	{
+		m_simulation.VersusTick(player, enemy);
+	}
+}
+
+//----------------------------------------------------------------------
+
+void RollbackSession::SendInputs()
+{
+	uint32_t count = std::min(m_frame - m_remoteAck, MaxInputsPerPacket);
+	int32_t advantage = std::max(-32768, std::min(32767, FrameAdvantage()));
+
+	m_packet.clear();
+	PacketWriter writer(m_packet);
+	writer.UInt(m_frame, 4);
+	writer.UInt(static_cast<uint16_t>(advantage), 2);
+	writer.UInt(static_cast<uint32_t>(m_remoteInputs.size()), 4);
+	writer.UInt(m_remoteAck, 4);
+	writer.UInt(count, 1);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const Float3& velocity = m_localInputs[m_remoteAck + i].playerVelocity;
+		writer.Float(velocity.x);
+		writer.Float(velocity.y);
+		writer.Float(velocity.z);
+	}
+
+	m_transport.Send(m_packet.data(), m_packet.size());
+	m_stats.packetsSent++;
+}
+
+//----------------------------------------------------------------------
+
+bool RollbackSession::StateAt(uint32_t frame, WorldState& state) const
+{
+	if (frame > m_frame)
+	{
+		return false;
+	}
+	if (frame == m_frame)
+	{
+		m_simulation.Save(state);
+		return true;
+	}
+
+	const WorldState& saved = m_states[frame % m_states.size()];
+	if (saved.tickCount != frame * m_settings.ticksPerFrame)
+	{
+		return false;
+	}
+	state = saved;
+	return true;
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,134 @@
+#pragma once
+
+// RollbackSession:
+// One peer of a two player netplay match, GGPO style.  Each machine drives one
+// sumo; the match advances in frames of GameConstants::Network::TicksPerFrame
+// SumoSimulation::VersusTick() ticks, which depend only on the two inputs, so
+// both peers compute the same match from the same inputs.
+//
+// Each frame the local input is sent to the other peer and the frame is run at
+// once, predicting that the remote player is still doing whatever their last
+// received input said.  When the real remote input for a frame turns out
+// different from the prediction, the session restores the WorldState saved at
+// the start of that frame and runs every frame since again with the inputs it
+// now has (a rollback).
+//
+// Keeping the peers in step:
+//  - a peer never runs more than MaxPredictionFrames ahead of the remote inputs
+//    it has; past that it stalls until they arrive;
+//  - each packet carries the sender's frame and how far it thinks it is ahead.
+//    A peer that finds itself further ahead than the other skips a frame now and
+//    then (at most one in FramesBetweenWaits) to let the other catch up, so
+//    neither side ends up doing all the predicting.
+//
+// Packets are unreliable.  Every packet repeats all the local inputs the other
+// peer hasn't acknowledged, so a lost packet is made good by the next one.  The
+// packet format is little-endian:
+//     uint32   sender's frame
+//     int16    sender's frame advantage
+//     uint32   frames of the receiver's input the sender has
+//     uint32   frame of the first input
+//     uint8    input count
+//     inputs   { float32 x, float32 y, float32 z } each
+
+#include "../GameObjects/GameConstants.h"
+#include "SumoSimulation.h"
+#include "Transport.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	struct RollbackSettings
+	{
+		uint32_t ticksPerFrame;
+		uint32_t maxPredictionFrames;
+		uint32_t framesBetweenWaits;
+	};
+
+	inline RollbackSettings DefaultRollbackSettings()
+	{
+		RollbackSettings settings = {
+			GameConstants::Network::TicksPerFrame,
+			GameConstants::Network::MaxPredictionFrames,
+			GameConstants::Network::FramesBetweenWaits,
+		};
+		return settings;
+	}
+
+	enum class FrameResult
+	{
+		Advanced,
+		Waiting,            // Skipped to let the other peer catch up.
+		Stalled,            // Too far ahead of the remote inputs.
+	};
+
+	struct RollbackStats
+	{
+		uint32_t frames;
+		uint32_t rollbacks;
+		uint32_t resimulatedFrames;
+		uint32_t longestRollback;
+		uint32_t waits;
+		uint32_t stalls;
+		uint32_t packetsSent;
+		uint32_t packetsReceived;
+	};
+
+	class RollbackSession
+	{
+	public:
+		// 'localPlayer' 0 drives the simulation's player sumo and 1 its enemy.
+		RollbackSession(uint32_t localPlayer, Transport& transport, const RollbackSettings& settings = DefaultRollbackSettings());
+
+		// Both peers must start with the same seed.
+		void Start(uint64_t seed);
+
+		// Take in the packets that have arrived, roll back if they showed a prediction
+		// was wrong, and run the next frame with this input unless the session has to
+		// wait or stall.  The input is only used when the frame advances.
+		FrameResult AdvanceFrame(const TickInput& localInput);
+
+		// Take in packets, roll back and answer them without running a frame, for when
+		// the game isn't advancing (paused, or the match is over).
+		void Poll();
+
+		const SumoSimulation& Simulation() const    { return m_simulation; }
+		uint32_t Frame() const                      { return m_frame; }
+		// Frames before this one were run with both players' real inputs.
+		uint32_t ConfirmedFrame() const;
+		// Frames this peer is ahead of the other, as of the last packet.
+		int32_t FrameAdvantage() const              { return static_cast<int32_t>(m_frame) - static_cast<int32_t>(m_remoteFrame); }
+		const RollbackStats& Stats() const          { return m_stats; }
+
+		// The state at the start of a recent frame; false once it has been overwritten.
+		bool StateAt(uint32_t frame, WorldState& state) const;
+
+	private:
+		void Receive();
+		void ReadPacket(const std::vector<uint8_t>& packet);
+		void Rollback();
+		void RunFrame(uint32_t frame);
+		void SendInputs();
+
+		SumoSimulation          m_simulation;
+		Transport&              m_transport;
+		RollbackSettings        m_settings;
+		uint32_t                m_localPlayer;
+		uint32_t                m_frame;             // Frames run so far.
+
+		std::vector<TickInput>  m_localInputs;       // Every frame's local input.
+		std::vector<TickInput>  m_remoteInputs;      // Remote inputs received so far, in frame order.
+		std::vector<TickInput>  m_usedRemoteInputs;  // The remote input each frame was last run with.
+		uint32_t                m_rollbackFrom;      // Earliest frame run with a wrong prediction.
+		uint32_t                m_remoteAck;         // Frames of local input the other peer has.
+		uint32_t                m_remoteFrame;
+		int32_t                 m_remoteAdvantage;
+		uint32_t                m_lastWait;
+
+		std::vector<WorldState> m_states;            // The state at the start of each recent frame.
+		std::vector<uint8_t>    m_packet;
+		RollbackStats           m_stats;
+	};
+}
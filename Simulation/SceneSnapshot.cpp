@@ -0,0 +1,61 @@
+#include "SceneSnapshot.h"
+
+#include <cstring>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+SceneSnapshot::SceneSnapshot() :
+	m_count(0),
+	m_frame(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void SceneSnapshot::Reserve(uint32_t count)
+{
+	// The arrays only ever grow, so a snapshot that has seen the largest scene
+	// never needs to allocate again.
+	if (m_transforms.size() < count)
+	{
+		m_transforms.resize(count);
+		m_renderHandles.resize(count);
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SceneSnapshot::Capture(const EntityStore& entities, uint64_t frame)
+{
+	uint32_t count = entities.Count();
+	Reserve(count);
+
+	if (count > 0)
+	{
+		memcpy(m_transforms.data(), entities.Transforms(), count * sizeof(Float4x4));
+		memcpy(m_renderHandles.data(), entities.RenderHandles(), count * sizeof(RenderHandle));
+	}
+	m_count = count;
+	m_frame = frame;
+}
+
+//----------------------------------------------------------------------
+
+SceneSnapshotBuffer::SceneSnapshotBuffer() :
+	m_latest(0),
+	m_frame(0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void SceneSnapshotBuffer::Publish(const EntityStore& entities)
+{
+	uint32_t next = 1 - m_latest.load(std::memory_order_relaxed);
+	m_snapshots[next].Capture(entities, ++m_frame);
+	m_latest.store(next, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------
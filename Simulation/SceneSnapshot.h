@@ -0,0 +1,56 @@
+#pragma once
+
+// SceneSnapshot:
+// An immutable copy of what the renderer needs for one frame: the model matrix
+// and render handle of every entity, in the same dense order as the EntityStore.
+// Capture() copies the two contiguous arrays; once the snapshot has grown to the
+// size of the scene, capturing a frame performs no allocations.
+//
+// SceneSnapshotBuffer keeps two snapshots so the game can write the next frame
+// while the renderer is still reading the one that was last published.
+
+#include "EntityStore.h"
+#include "Span.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	class SceneSnapshot
+	{
+	public:
+		SceneSnapshot();
+
+		void Capture(const EntityStore& entities, uint64_t frame);
+		void Reserve(uint32_t count);
+
+		uint32_t Count() const                          { return m_count; }
+		uint64_t Frame() const                          { return m_frame; }
+		Span<const Float4x4> Transforms() const         { return Span<const Float4x4>(m_transforms.data(), m_count); }
+		Span<const RenderHandle> RenderHandles() const  { return Span<const RenderHandle>(m_renderHandles.data(), m_count); }
+
+	private:
+		std::vector<Float4x4>     m_transforms;
+		std::vector<RenderHandle> m_renderHandles;
+		uint32_t                  m_count;
+		uint64_t                  m_frame;
+	};
+
+	class SceneSnapshotBuffer
+	{
+	public:
+		SceneSnapshotBuffer();
+
+		// Capture the entities into the snapshot that isn't being read and make it the latest.
+		void Publish(const EntityStore& entities);
+
+		const SceneSnapshot& Latest() const             { return m_snapshots[m_latest.load(std::memory_order_acquire)]; }
+
+	private:
+		SceneSnapshot         m_snapshots[2];
+		std::atomic<uint32_t> m_latest;
+		uint64_t              m_frame;
+	};
+}
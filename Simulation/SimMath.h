@@ -0,0 +1,87 @@
+#pragma once
+
+// SimMath:
+// Minimal vector math used by the portable simulation.  The game itself uses
+// DirectXMath, which is not available outside of the Windows SDK, so the
+// simulation carries its own small Float3 and Float4x4 types.  Float4x4 has the
+// same row-major layout as DirectX::XMFLOAT4X4.  The operations mirror the
+// DirectXMath functions the original game play code was written against,
+// including XMVector3Normalize returning a zero vector for zero-length input.
+
+#include <cmath>
+
+namespace Simulation
+{
+	struct Float3
+	{
+		float x;
+		float y;
+		float z;
+	};
+
+	struct Float4x4
+	{
+		float m[4][4];
+	};
+
+	inline Float4x4 Float4x4Identity()
+	{
+		Float4x4 result = { {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f },
+		} };
+		return result;
+	}
+
+	inline Float3 MakeFloat3(float x, float y, float z)
+	{
+		Float3 result = { x, y, z };
+		return result;
+	}
+
+	inline Float3 operator+(Float3 a, Float3 b)
+	{
+		return MakeFloat3(a.x + b.x, a.y + b.y, a.z + b.z);
+	}
+
+	inline Float3 operator-(Float3 a, Float3 b)
+	{
+		return MakeFloat3(a.x - b.x, a.y - b.y, a.z - b.z);
+	}
+
+	inline Float3 operator*(Float3 a, float s)
+	{
+		return MakeFloat3(a.x * s, a.y * s, a.z * s);
+	}
+
+	inline float Dot(Float3 a, Float3 b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	inline float Length(Float3 a)
+	{
+		return std::sqrt(Dot(a, a));
+	}
+
+	inline Float3 Cross(Float3 a, Float3 b)
+	{
+		return MakeFloat3(
+			a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x
+			);
+	}
+
+	inline Float3 Normalize(Float3 a)
+	{
+		float length = Length(a);
+		if (length > 0.0f)
+		{
+			return a * (1.0f / length);
+		}
+		return MakeFloat3(0.0f, 0.0f, 0.0f);
+	}
+}
@@ -0,0 +1,389 @@
+#include "SmartPlanner.h"
+#include "SumoSimulation.h"
+#include "CounterRandom.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_PLANNER_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Simulation;
+
+namespace
+{
+	const int   ManeuverCount = 3;
+	const float Exploration   = 0.7f;     // UCB1 exploration constant for scores between 0 and 1.
+
+	// Key the rollouts apart from the sumos' own draws with the same seed.
+	const uint64_t PlannerKey = 0x9E3779B97F4A7C15ULL;
+
+	// Rollouts are played this many at a time, one per lane, so the long chains of
+	// square roots and divisions in each step overlap.
+	const int Lanes = 8;
+
+	// Each lane's step is pos += unit * forward + perpendicular(unit) * sideways,
+	// where unit points at the opponent.  This is ApplyManeuver with y held level.
+	void ManeuverGains(GameConstants::Behavior behavior, GameConstants::ManeuverState choice, float& forward, float& sideways)
+	{
+		switch (choice)
+		{
+		case GameConstants::Dodge:
+			// Angry sumos don't dodge, they push instead.
+			forward = (behavior == GameConstants::Angry) ? static_cast<float>(behavior) : 0.0f;
+			sideways = static_cast<float>(behavior - 1);
+			break;
+		case GameConstants::Push:
+			forward = static_cast<float>(behavior);
+			sideways = 0.0f;
+			break;
+		default:
+			forward = 1.0f;
+			sideways = 0.0f;
+			break;
+		}
+	}
+
+	// Up to Lanes rollouts from the same DuelState, in structure-of-arrays form.
+	struct RolloutBatch
+	{
+		float selfX[Lanes];
+		float selfZ[Lanes];
+		float opponentX[Lanes];
+		float opponentZ[Lanes];
+		float forward[Lanes];       // Gains of the lane's current maneuver, times the step length.
+		float sideways[Lanes];
+		float maneuverLeft[Lanes];  // Seconds left in the lane's current maneuver.
+	};
+
+	// Advance every lane one rollout step.  Returns a bit per lane that rang the
+	// opponent out in 'opponentOut', and the same for the planning sumo in 'selfOut'.
+	void StepBatch(RolloutBatch& batch, const DuelState& state, float chase, float outSquared, int& opponentOut, int& selfOut)
+	{
+		float selfHeight = state.self.y * state.self.y;
+		float opponentHeight = state.opponent.y * state.opponent.y;
+		float sumoSize = GameConstants::Arena::SumoSize;
+
+#if defined(SUMO_PLANNER_SSE2)
+		opponentOut = 0;
+		selfOut = 0;
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		for (int lane = 0; lane < Lanes; lane += 4)
+		{
+			__m128 selfX = _mm_loadu_ps(batch.selfX + lane);
+			__m128 selfZ = _mm_loadu_ps(batch.selfZ + lane);
+			__m128 opponentX = _mm_loadu_ps(batch.opponentX + lane);
+			__m128 opponentZ = _mm_loadu_ps(batch.opponentZ + lane);
+
+			// The opponent walks straight at us.
+			__m128 toSelfX = _mm_sub_ps(selfX, opponentX);
+			__m128 toSelfZ = _mm_sub_ps(selfZ, opponentZ);
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(toSelfX, toSelfX), _mm_mul_ps(toSelfZ, toSelfZ)));
+			__m128 scale = _mm_and_ps(_mm_cmpgt_ps(length, zero), _mm_mul_ps(_mm_div_ps(one, length), _mm_set1_ps(chase)));
+			opponentX = _mm_add_ps(opponentX, _mm_mul_ps(toSelfX, scale));
+			opponentZ = _mm_add_ps(opponentZ, _mm_mul_ps(toSelfZ, scale));
+
+			// Then we move.
+			__m128 toOpponentX = _mm_sub_ps(opponentX, selfX);
+			__m128 toOpponentZ = _mm_sub_ps(opponentZ, selfZ);
+			length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(toOpponentX, toOpponentX), _mm_mul_ps(toOpponentZ, toOpponentZ)));
+			__m128 inverse = _mm_and_ps(_mm_cmpgt_ps(length, zero), _mm_div_ps(one, length));
+			__m128 unitX = _mm_mul_ps(toOpponentX, inverse);
+			__m128 unitZ = _mm_mul_ps(toOpponentZ, inverse);
+			__m128 forward = _mm_loadu_ps(batch.forward + lane);
+			__m128 sideways = _mm_loadu_ps(batch.sideways + lane);
+			selfX = _mm_sub_ps(_mm_add_ps(selfX, _mm_mul_ps(unitX, forward)), _mm_mul_ps(unitZ, sideways));
+			selfZ = _mm_add_ps(_mm_add_ps(selfZ, _mm_mul_ps(unitZ, forward)), _mm_mul_ps(unitX, sideways));
+
+			// Push apart.
+			__m128 deltaX = _mm_sub_ps(selfX, opponentX);
+			__m128 deltaZ = _mm_sub_ps(selfZ, opponentZ);
+			__m128 overlap = _mm_sub_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaZ, deltaZ))), _mm_set1_ps(sumoSize));
+			__m128 push = _mm_and_ps(_mm_cmplt_ps(overlap, zero), _mm_mul_ps(overlap, half));
+			opponentX = _mm_add_ps(opponentX, _mm_mul_ps(deltaX, push));
+			opponentZ = _mm_add_ps(opponentZ, _mm_mul_ps(deltaZ, push));
+			selfX = _mm_sub_ps(selfX, _mm_mul_ps(deltaX, push));
+			selfZ = _mm_sub_ps(selfZ, _mm_mul_ps(deltaZ, push));
+
+			// Ring-outs, on squared distances.
+			__m128 limit = _mm_set1_ps(outSquared);
+			__m128 opponentDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(opponentX, opponentX), _mm_set1_ps(opponentHeight)), _mm_mul_ps(opponentZ, opponentZ));
+			__m128 selfDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(selfX, selfX), _mm_set1_ps(selfHeight)), _mm_mul_ps(selfZ, selfZ));
+			opponentOut |= _mm_movemask_ps(_mm_cmpgt_ps(opponentDistance, limit)) << lane;
+			selfOut |= _mm_movemask_ps(_mm_cmpgt_ps(selfDistance, limit)) << lane;
+
+			_mm_storeu_ps(batch.selfX + lane, selfX);
+			_mm_storeu_ps(batch.selfZ + lane, selfZ);
+			_mm_storeu_ps(batch.opponentX + lane, opponentX);
+			_mm_storeu_ps(batch.opponentZ + lane, opponentZ);
+		}
+#else
+		opponentOut = 0;
+		selfOut = 0;
+		for (int lane = 0; lane < Lanes; lane++)
+		{
+			float selfX = batch.selfX[lane];
+			float selfZ = batch.selfZ[lane];
+			float opponentX = batch.opponentX[lane];
+			float opponentZ = batch.opponentZ[lane];
+
+			float toSelfX = selfX - opponentX;
+			float toSelfZ = selfZ - opponentZ;
+			float length = std::sqrt(toSelfX * toSelfX + toSelfZ * toSelfZ);
+			float scale = (length > 0.0f) ? (1.0f / length) * chase : 0.0f;
+			opponentX = opponentX + toSelfX * scale;
+			opponentZ = opponentZ + toSelfZ * scale;
+
+			float toOpponentX = opponentX - selfX;
+			float toOpponentZ = opponentZ - selfZ;
+			length = std::sqrt(toOpponentX * toOpponentX + toOpponentZ * toOpponentZ);
+			float inverse = (length > 0.0f) ? 1.0f / length : 0.0f;
+			float unitX = toOpponentX * inverse;
+			float unitZ = toOpponentZ * inverse;
+			selfX = (selfX + unitX * batch.forward[lane]) - unitZ * batch.sideways[lane];
+			selfZ = (selfZ + unitZ * batch.forward[lane]) + unitX * batch.sideways[lane];
+
+			float deltaX = selfX - opponentX;
+			float deltaZ = selfZ - opponentZ;
+			float overlap = std::sqrt(deltaX * deltaX + deltaZ * deltaZ) - sumoSize;
+			float push = (overlap < 0.0f) ? overlap * 0.5f : 0.0f;
+			opponentX = opponentX + deltaX * push;
+			opponentZ = opponentZ + deltaZ * push;
+			selfX = selfX - deltaX * push;
+			selfZ = selfZ - deltaZ * push;
+
+			if ((opponentX * opponentX + opponentHeight) + opponentZ * opponentZ > outSquared)
+			{
+				opponentOut |= 1 << lane;
+			}
+			if ((selfX * selfX + selfHeight) + selfZ * selfZ > outSquared)
+			{
+				selfOut |= 1 << lane;
+			}
+
+			batch.selfX[lane] = selfX;
+			batch.selfZ[lane] = selfZ;
+			batch.opponentX[lane] = opponentX;
+			batch.opponentZ[lane] = opponentZ;
+		}
+#endif
+	}
+
+	// The UCB1 choice among 'count' maneuvers; unvisited ones are tried first, in order.
+	int Select(const uint32_t* visits, const float* scores, int count, uint32_t parentVisits)
+	{
+		float logVisits = std::log(static_cast<float>(std::max(parentVisits, 1u)));
+		int best = 0;
+		float bestBound = -1.0f;
+		for (int action = 0; action < count; action++)
+		{
+			if (visits[action] == 0)
+			{
+				return action;
+			}
+			float bound = scores[action] / visits[action] + Exploration * std::sqrt(logVisits / visits[action]);
+			if (bound > bestBound)
+			{
+				bestBound = bound;
+				best = action;
+			}
+		}
+		return best;
+	}
+}
+
+//----------------------------------------------------------------------
+
+PlannerDecision SmartPlanner::Plan(const DuelState& state, const AITimings& timings, uint64_t seed, uint64_t tick,
+	const PlannerSettings& settings)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// Maneuvers are numbered choice * durations + duration.
+	int durations = std::max(timings.delayChoices, 1);
+	int actions = ManeuverCount * durations;
+	m_visits.assign(actions * (actions + 1), 0);
+	m_scores.assign(actions * (actions + 1), 0.0f);
+	uint32_t* rootVisits = m_visits.data();
+	float* rootScores = m_scores.data();
+
+	float step = settings.rolloutStep;
+	float chase = state.opponentSpeed * step;
+	float outSquared = state.ringRadius * state.ringRadius;
+	int horizonSteps = std::max(static_cast<int>(std::ceil(settings.horizon / step)), 1);
+
+	CounterRandom generator(seed ^ PlannerKey);
+	uint32_t iterations = 0;
+	for (;;)
+	{
+		int lanes = Lanes;
+		if (settings.iterationLimit > 0)
+		{
+			lanes = std::min(lanes, static_cast<int>(std::max(settings.iterationLimit, static_cast<uint32_t>(actions)) - iterations));
+		}
+
+		// Pick each lane's first two maneuvers up front.  The visits are counted as the
+		// picks are made, so the lanes of a batch spread over different maneuvers.
+		RolloutBatch batch;
+		int first[Lanes];
+		int second[Lanes];
+		int phase[Lanes];
+		for (int lane = 0; lane < Lanes; lane++)
+		{
+			batch.selfX[lane] = state.self.x;
+			batch.selfZ[lane] = state.self.z;
+			batch.opponentX[lane] = state.opponent.x;
+			batch.opponentZ[lane] = state.opponent.z;
+			batch.forward[lane] = 0.0f;
+			batch.sideways[lane] = 0.0f;
+			batch.maneuverLeft[lane] = 0.0f;
+			phase[lane] = 0;
+			first[lane] = 0;
+			second[lane] = 0;
+			if (lane < lanes)
+			{
+				first[lane] = Select(rootVisits, rootScores, actions, iterations + lane);
+				rootVisits[first[lane]]++;
+				uint32_t* childVisits = rootVisits + actions * (first[lane] + 1);
+				second[lane] = Select(childVisits, rootScores + actions * (first[lane] + 1), actions, rootVisits[first[lane]]);
+				childVisits[second[lane]]++;
+			}
+		}
+
+		RandomStream random[Lanes] = {
+			RandomStream(generator, iterations + 0, tick), RandomStream(generator, iterations + 1, tick),
+			RandomStream(generator, iterations + 2, tick), RandomStream(generator, iterations + 3, tick),
+			RandomStream(generator, iterations + 4, tick), RandomStream(generator, iterations + 5, tick),
+			RandomStream(generator, iterations + 6, tick), RandomStream(generator, iterations + 7, tick),
+		};
+
+		float scores[Lanes];
+		int active = (1 << lanes) - 1;
+		for (int stepIndex = 0; active != 0; stepIndex++)
+		{
+			if (stepIndex == horizonSteps)
+			{
+				// Nobody is out yet: whoever is nearer the edge is losing.
+				for (int lane = 0; lane < lanes; lane++)
+				{
+					if (active & (1 << lane))
+					{
+						float selfDistance = std::sqrt(batch.selfX[lane] * batch.selfX[lane] + batch.selfZ[lane] * batch.selfZ[lane]);
+						float opponentDistance = std::sqrt(batch.opponentX[lane] * batch.opponentX[lane] + batch.opponentZ[lane] * batch.opponentZ[lane]);
+						float lead = (opponentDistance - selfDistance) / state.ringRadius;
+						scores[lane] = std::min(std::max(0.5f + 0.5f * lead, 0.0f), 1.0f);
+					}
+				}
+				break;
+			}
+
+			// Start the next maneuver in lanes that finished one: the two planned ones,
+			// then random ones, as the old Smart AI would have chosen.
+			for (int lane = 0; lane < lanes; lane++)
+			{
+				if (batch.maneuverLeft[lane] > 0.0f || (active & (1 << lane)) == 0)
+				{
+					continue;
+				}
+				int choice;
+				int duration;
+				if (phase[lane] < 2)
+				{
+					int action = (phase[lane] == 0) ? first[lane] : second[lane];
+					choice = action / durations;
+					duration = action % durations;
+				}
+				else
+				{
+					choice = random[lane].NextInt(ManeuverCount);
+					duration = random[lane].NextInt(durations);
+				}
+				phase[lane]++;
+
+				float forward, sideways;
+				ManeuverGains(state.behavior, static_cast<GameConstants::ManeuverState>(choice), forward, sideways);
+				batch.forward[lane] = forward * step;
+				batch.sideways[lane] = sideways * step;
+				batch.maneuverLeft[lane] += timings.minimumDelay + duration * timings.delayStep;
+			}
+			for (int lane = 0; lane < Lanes; lane++)
+			{
+				batch.maneuverLeft[lane] -= step;
+			}
+
+			int opponentOut, selfOut;
+			StepBatch(batch, state, chase, outSquared, opponentOut, selfOut);
+
+			// The opponent is checked first, like the player in SumoSimulation::CheckRingOut.
+			int finished = (opponentOut | selfOut) & active;
+			for (int lane = 0; finished != 0; lane++, finished >>= 1)
+			{
+				if (finished & 1)
+				{
+					scores[lane] = (opponentOut & (1 << lane)) ? 1.0f : 0.0f;
+					active &= ~(1 << lane);
+				}
+			}
+		}
+
+		// A second maneuver that never started, because the rollout was over first by
+		// ring-out or the horizon, gets neither the score nor the visit.
+		for (int lane = 0; lane < lanes; lane++)
+		{
+			rootScores[first[lane]] += scores[lane];
+			if (phase[lane] >= 2)
+			{
+				rootScores[actions * (first[lane] + 1) + second[lane]] += scores[lane];
+			}
+			else
+			{
+				rootVisits[actions * (first[lane] + 1) + second[lane]]--;
+			}
+		}
+		iterations += lanes;
+
+		if (settings.iterationLimit > 0 && iterations >= settings.iterationLimit && iterations >= static_cast<uint32_t>(actions))
+		{
+			break;
+		}
+		if (iterations < static_cast<uint32_t>(actions))
+		{
+			continue;
+		}
+		if (settings.budgetMicroseconds == 0 && settings.iterationLimit == 0)
+		{
+			break;
+		}
+		if (settings.budgetMicroseconds > 0 &&
+			std::chrono::steady_clock::now() - start >= std::chrono::microseconds(settings.budgetMicroseconds))
+		{
+			break;
+		}
+	}
+
+	// The most visited maneuver is the one the search is most sure of.
+	int best = 0;
+	for (int action = 1; action < actions; action++)
+	{
+		if (rootVisits[action] > rootVisits[best])
+		{
+			best = action;
+		}
+	}
+
+	PlannerDecision decision;
+	decision.choice = static_cast<GameConstants::ManeuverState>(best / durations);
+	decision.delay = timings.minimumDelay + (best % durations) * timings.delayStep;
+	decision.value = rootScores[best] / rootVisits[best];
+	decision.iterations = iterations;
+	decision.microseconds = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start).count());
+	return decision;
+}
+
+//----------------------------------------------------------------------
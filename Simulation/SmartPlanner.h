@@ -0,0 +1,84 @@
+#pragma once
+
+// SmartPlanner:
+// Chooses the Smart AI's next maneuver with a Monte Carlo tree search instead of
+// at random.  Each search iteration copies the DuelState, plays two planned
+// maneuvers and then random ones until the horizon, and scores how the match
+// stands at the end: a ring-out of the opponent is a win, a ring-out of the
+// planning sumo a loss, and otherwise whoever is nearer the edge is losing.  The
+// first two maneuvers of each iteration are picked with UCB1 so the search
+// spends its rollouts on the most promising choices.  A maneuver is both a move
+// (Walk, Dodge or Push) and one of the AITimings durations.
+//
+// Rollouts use the same movement and contact rules as SumoSimulation, with
+// rollout steps of several physics ticks, and the opponent is assumed to walk
+// straight at the planning sumo at its current speed.
+//
+// The search stops at the time budget or the iteration limit, whichever comes
+// first.  The rollouts are drawn from a CounterRandom keyed by the seed, the
+// tick and the iteration, so a search stopped by the iteration limit alone gives
+// the same decision every time; one stopped by the clock does not.
+
+#include "../GameObjects/GameConstants.h"
+#include "SimMath.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	struct AITimings;
+
+	// Everything a rollout needs, from the point of view of the sumo that is
+	// planning.  It holds no pointers, so each rollout starts from a plain copy.
+	struct DuelState
+	{
+		Float3                  self;
+		Float3                  opponent;
+		float                   opponentSpeed;
+		GameConstants::Behavior behavior;
+		float                   ringRadius;
+	};
+
+	struct PlannerSettings
+	{
+		uint32_t budgetMicroseconds;    // 0 for no time limit.
+		uint32_t iterationLimit;        // 0 for no limit.
+		float    horizon;               // Seconds of play simulated by each rollout.
+		float    rolloutStep;           // Seconds per rollout step.
+	};
+
+	inline PlannerSettings DefaultPlannerSettings()
+	{
+		PlannerSettings settings = {
+			GameConstants::Arena::SmartPlanBudget,
+			0,
+			GameConstants::Arena::SmartPlanHorizon,
+			GameConstants::Arena::SmartPlanStep,
+		};
+		return settings;
+	}
+
+	struct PlannerDecision
+	{
+		GameConstants::ManeuverState choice;
+		float                        delay;
+		float                        value;          // Mean score of the chosen maneuver, from 0 (lost) to 1 (won).
+		uint32_t                     iterations;
+		uint32_t                     microseconds;
+	};
+
+	class SmartPlanner
+	{
+	public:
+		// Searches for at least one iteration per maneuver, however small the budget.
+		PlannerDecision Plan(const DuelState& state, const AITimings& timings, uint64_t seed, uint64_t tick,
+			const PlannerSettings& settings);
+
+	private:
+		// Visits and summed scores of the first maneuvers, followed by those of the
+		// second maneuvers under each first one.
+		std::vector<uint32_t> m_visits;
+		std::vector<float>    m_scores;
+	};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// Span:
+// A non-owning view of a contiguous range of elements.  Returning a Span instead
+// of a container lets callers walk data in place without copying it and, for
+// containers of ref-counted handles, without touching the reference counts.
+
+#include <cstddef>
+
+namespace Simulation
+{
+	template <typename T>
+	class Span
+	{
+	public:
+		Span() : m_begin(nullptr), m_end(nullptr) {}
+		Span(T* begin, size_t count) : m_begin(begin), m_end(begin + count) {}
+
+		T* begin() const                            { return m_begin; }
+		T* end() const                              { return m_end; }
+		size_t size() const                         { return static_cast<size_t>(m_end - m_begin); }
+		bool empty() const                          { return m_begin == m_end; }
+		T& operator[](size_t index) const           { return m_begin[index]; }
+
+	private:
+		T* m_begin;
+		T* m_end;
+	};
+}
@@ -0,0 +1,419 @@
+#include "SumoArena.h"
+#include "TransformSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace Simulation;
+
+namespace
+{
+	// Fraction of the mat covered by sumos at the start of a crowded battle.
+	const float StartingDensity = 0.35f;
+
+	// Sumos start inside this fraction of the mat radius so nobody begins at the edge.
+	const float SpawnFraction = 0.8f;
+
+	const float Pi = 3.14159265f;
+
+	// The random stream the starting positions are drawn from.  Sumos draw from the
+	// stream of their entity slot, which never reaches this.
+	const uint32_t SpawnStream = 0xFFFFFFFF;
+
+	// Contacts handed to a thread at a time.
+	const uint32_t ContactGrain = 1024;
+}
+
+//----------------------------------------------------------------------
+
+SumoArena::SumoArena() :
+	m_grid(GameConstants::Arena::SumoSize),
+	m_jobs(nullptr),
+	m_scheduling(false),
+	m_dynamics(false),
+	m_reporting(false),
+	m_ringRadius(GameConstants::Arena::RingRadius),
+	m_tickCount(0)
+{
+	memset(&m_aiCost, 0, sizeof(m_aiCost));
+}
+
+//----------------------------------------------------------------------
+
+float SumoArena::RingRadiusFor(uint32_t wrestlerCount)
+{
+	float sumoArea = GameConstants::Arena::SumoSize * GameConstants::Arena::SumoSize;
+	float radius = std::sqrt(wrestlerCount * sumoArea / (Pi * StartingDensity)) / SpawnFraction;
+	return std::max(radius, GameConstants::Arena::RingRadius);
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::Reset(uint32_t wrestlerCount, GameConstants::Behavior behavior, uint64_t seed, float ringRadius)
+{
+	m_ringRadius = ringRadius > 0.0f ? ringRadius : RingRadiusFor(wrestlerCount);
+	m_random.Seed(seed);
+	m_tickCount = 0;
+	m_contactEvents.Clear(0);
+
+	m_entities.Clear();
+	m_entities.Reserve(wrestlerCount);
+	m_ai.clear();
+	m_targets.clear();
+
+	AIState ai;
+	ai.behavior = behavior;
+	ai.choice = GameConstants::Walk;
+	ai.delay = GameConstants::Arena::InitialAIDelay;
+
+	// Two draws per sumo from the spawn stream, generated in one bulk call.
+	std::vector<uint32_t> draws(wrestlerCount * 2);
+	if (wrestlerCount > 0)
+	{
+		m_random.Fill(SpawnStream, 0, draws.data(), wrestlerCount * 2);
+	}
+
+	float spawnRadius = m_ringRadius * SpawnFraction;
+	for (uint32_t i = 0; i < wrestlerCount; i++)
+	{
+		// Uniform over the disc.
+		float radius = spawnRadius * std::sqrt(RandomStream::ToFloat(draws[i * 2]));
+		float angle = 2.0f * Pi * RandomStream::ToFloat(draws[i * 2 + 1]);
+		m_entities.Create(MakeFloat3(radius * std::cos(angle), GameConstants::Arena::StartHeight, radius * std::sin(angle)));
+		m_ai.push_back(ai);
+		m_targets.push_back(InvalidEntity);
+	}
+	m_scheduler.Reset(wrestlerCount, m_tickCount);
+	m_bodies.Reset(wrestlerCount);
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::AIScheduling(bool enabled, const AIScheduleSettings& settings)
+{
+	m_scheduling = enabled;
+	m_scheduler.Settings(settings);
+	m_scheduler.Reset(m_entities.Count(), m_tickCount);
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::Dynamics(bool enabled, const BodySettings& settings)
+{
+	m_dynamics = enabled;
+	m_bodies.Settings(settings);
+	m_bodies.Reset(m_entities.Count());
+}
+
+//----------------------------------------------------------------------
+
+EntityHandle SumoArena::ChooseTarget(uint32_t index, RandomStream& random)
+{
+	uint32_t count = m_entities.Count();
+	uint32_t target = random.Next() % count;
+	if (target == index)
+	{
+		target = (target + 1) % count;
+	}
+	return m_entities.Handle(target);
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::ReportContacts(bool enabled, const ContactEventSettings& settings)
+{
+	m_reporting = enabled;
+	m_contactEvents.Settings(settings);
+	m_contactEvents.Clear(m_tickCount);
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::UpdateAI(float deltaTime)
+{
+	auto start = std::chrono::steady_clock::now();
+	uint32_t count = m_entities.Count();
+	memset(&m_aiCost, 0, sizeof(m_aiCost));
+	if (count < 2)
+	{
+		return;
+	}
+
+	if (m_scheduling)
+	{
+		UpdateScheduledAI(deltaTime);
+		m_aiCost.nanoseconds = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count());
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		// Each sumo draws from its own stream for this tick, so the choices don't
+		// depend on the order the sumos are updated in.
+		RandomStream random(m_random, m_entities.Handle(i).slot, m_tickCount);
+
+		// Pick a new opponent once the old one has been rung out.
+		if (!m_entities.Valid(m_targets[i]))
+		{
+			m_targets[i] = ChooseTarget(i, random);
+			m_entities.FacingTarget(i, m_targets[i]);
+		}
+
+		Float3 position = m_entities.Position(i);
+		float delay = m_ai[i].delay;
+		DetermineAIAction(position, m_entities.Position(m_entities.Index(m_targets[i])), m_ai[i], random, deltaTime);
+		m_entities.Position(i, position);
+		m_aiCost.decided += (m_ai[i].delay > delay) ? 1 : 0;
+	}
+
+	m_aiCost.checked = count;
+	m_aiCost.nanoseconds = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count());
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::UpdateScheduledAI(float deltaTime)
+{
+	m_scheduler.Schedule(m_entities, m_ai, m_targets, m_tickCount, deltaTime);
+
+	// Only the sumos the scheduler picks choose a new maneuver this tick.
+	for (uint32_t index : m_scheduler.Deciding())
+	{
+		RandomStream random(m_random, m_entities.Handle(index).slot, m_tickCount);
+		ChooseManeuver(m_ai[index], random);
+		Steer(index);
+	}
+
+	for (uint32_t index : m_scheduler.Checked())
+	{
+		Steer(index);
+	}
+
+	// Everyone moves along the velocity they last steered to.
+	uint32_t count = m_entities.Count();
+	float* x = m_entities.PositionX();
+	float* z = m_entities.PositionZ();
+	const float* velocityX = m_entities.VelocityX();
+	const float* velocityZ = m_entities.VelocityZ();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		x[i] += velocityX[i] * deltaTime;
+		z[i] += velocityZ[i] * deltaTime;
+	}
+
+	m_aiCost.checked = static_cast<uint32_t>(m_scheduler.Checked().size());
+	m_aiCost.decided = static_cast<uint32_t>(m_scheduler.Deciding().size());
+	m_aiCost.waiting = m_scheduler.Waiting();
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::Steer(uint32_t index)
+{
+	if (!m_entities.Valid(m_targets[index]))
+	{
+		// A block of its own, apart from the draws for the sumo's maneuver.
+		RandomStream random(m_random, m_entities.Handle(index).slot, m_tickCount, 1);
+		m_targets[index] = ChooseTarget(index, random);
+		m_entities.FacingTarget(index, m_targets[index]);
+	}
+
+	// The maneuver's move over one second is its velocity.
+	Float3 position = m_entities.Position(index);
+	Float3 moved = position;
+	ApplyManeuver(moved, m_entities.Position(m_entities.Index(m_targets[index])), m_ai[index].behavior, m_ai[index].choice, 1.0f);
+	m_entities.Velocity(index, moved - position);
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::FindContacts()
+{
+	m_grid.Build(m_entities.PositionX(), m_entities.PositionZ(), m_entities.Count());
+	if (m_dynamics)
+	{
+		m_grid.FindPairs(m_pairs, m_bodies.Awake());
+	}
+	else
+	{
+		m_grid.FindPairs(m_pairs);
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::ColorContacts()
+{
+	m_coloring.Build(m_pairs.data(), static_cast<uint32_t>(m_pairs.size()), m_entities.Count());
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::ResolveContacts()
+{
+	float* positionX = m_entities.PositionX();
+	float* positionZ = m_entities.PositionZ();
+
+	// No two contacts in a batch share a sumo, so each one is corrected in place.
+	for (uint32_t batch = 0; batch < m_coloring.BatchCount(); batch++)
+	{
+		Span<const ContactPair> pairs = m_coloring.Batch(batch);
+		uint32_t pairCount = static_cast<uint32_t>(pairs.size());
+		if (m_coloring.Serial(batch))
+		{
+			AccumulateContactCorrectionsScalar(pairs.begin(), pairCount, positionX, positionZ, positionX, positionZ);
+		}
+		else if (m_jobs != nullptr)
+		{
+			m_jobs->ParallelFor(pairCount, ContactGrain, [&](uint32_t begin, uint32_t end)
+			{
+				AccumulateContactCorrections(pairs.begin() + begin, end - begin, positionX, positionZ, positionX, positionZ);
+			});
+		}
+		else
+		{
+			AccumulateContactCorrections(pairs.begin(), pairCount, positionX, positionZ, positionX, positionZ);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::RemoveRingOuts()
+{
+	// Walk backwards so the entity the store moves into a freed index has already been checked.
+	for (uint32_t i = m_entities.Count(); i > 0; i--)
+	{
+		uint32_t index = i - 1;
+		if (IsRingOut(m_entities.Position(index), m_ringRadius))
+		{
+			m_entities.Destroy(m_entities.Handle(index));
+
+			// Mirror the store's swap with the last entity.
+			m_ai[index] = m_ai.back();
+			m_ai.pop_back();
+			m_targets[index] = m_targets.back();
+			m_targets.pop_back();
+			m_scheduler.Remove(index);
+			m_bodies.Remove(index);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::UpdateDrives(float deltaTime)
+{
+	uint32_t count = m_entities.Count();
+	float* x = m_entities.PositionX();
+	float* z = m_entities.PositionZ();
+	m_driveStartX.assign(x, x + count);
+	m_driveStartZ.assign(z, z + count);
+
+	UpdateAI(deltaTime);
+
+	// Where the AI moved each sumo becomes the velocity it walks at, and the sumo
+	// goes back to where it was for the dynamics to move.
+	float* driveX = m_bodies.DriveX();
+	float* driveZ = m_bodies.DriveZ();
+	float inverseDeltaTime = 1.0f / deltaTime;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		driveX[i] = (x[i] - m_driveStartX[i]) * inverseDeltaTime;
+		driveZ[i] = (z[i] - m_driveStartZ[i]) * inverseDeltaTime;
+		x[i] = m_driveStartX[i];
+		z[i] = m_driveStartZ[i];
+	}
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::StepBodies(float deltaTime)
+{
+	m_bodies.ApplyDrive();
+	if (m_bodies.AwakeCount() == 0)
+	{
+		// Nothing can move or be hit, so there is nothing to look for.
+		m_pairs.clear();
+		return;
+	}
+	FindContacts();
+	ColorContacts();
+	if (m_reporting)
+	{
+		m_contactEvents.AddImpacts(m_pairs.data(), static_cast<uint32_t>(m_pairs.size()), m_entities, m_bodies);
+	}
+	m_bodies.SolveContacts(m_entities, m_coloring, m_jobs);
+	m_bodies.Integrate(m_entities, deltaTime);
+	ResolveContacts();
+	m_bodies.Sleep(m_entities, deltaTime);
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::Tick()
+{
+	m_contactEvents.Clear(m_tickCount);
+	if (m_dynamics)
+	{
+		UpdateDrives(GameConstants::Physics::FrameLength);
+		StepBodies(GameConstants::Physics::FrameLength);
+	}
+	else
+	{
+		UpdateAI(GameConstants::Physics::FrameLength);
+		FindContacts();
+		ColorContacts();
+		if (m_reporting)
+		{
+			m_contactEvents.AddOverlaps(m_pairs.data(), static_cast<uint32_t>(m_pairs.size()), m_entities, GameConstants::Physics::FrameLength);
+		}
+		ResolveContacts();
+	}
+	RemoveRingOuts();
+	m_tickCount++;
+}
+
+//----------------------------------------------------------------------
+
+void SumoArena::UpdateTransforms()
+{
+	uint32_t count = m_entities.Count();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		m_entities.RenderPosition(i, m_entities.Position(i));
+	}
+	Simulation::UpdateTransforms(m_entities);
+}
+
+//----------------------------------------------------------------------
+
+uint64_t SumoArena::Checksum() const
+{
+	// FNV-1a over the positions of the remaining sumos, the generator and the tick.
+	uint64_t hash = 14695981039346656037ULL;
+	auto hashBytes = [&hash](const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+	};
+
+	uint32_t count = m_entities.Count();
+	hashBytes(m_entities.PositionX(), count * sizeof(float));
+	hashBytes(m_entities.PositionY(), count * sizeof(float));
+	hashBytes(m_entities.PositionZ(), count * sizeof(float));
+	uint64_t seed = m_random.Seed();
+	hashBytes(&seed, sizeof(seed));
+	hashBytes(&m_tickCount, sizeof(m_tickCount));
+	return hash;
+}
+
+//----------------------------------------------------------------------
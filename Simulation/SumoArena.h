@@ -0,0 +1,124 @@
+#pragma once
+
+// SumoArena:
+// A battle royale on one mat: any number of AI sumos, each chasing an opponent
+// with the same maneuver rules as the game's enemy.  Contacts are found by a
+// UniformGrid broadphase, split into batches of independent contacts by a
+// ContactColoring and resolved a batch at a time by the contact kernel, which
+// uses the same push-apart rule as the two-sumo match.  Given a JobSystem, each
+// batch is spread across its threads.  A sumo that is rung out is removed from
+// the arena.
+// With dynamics on, the AI's maneuvers only set the velocity each sumo is trying
+// to walk at, and RigidBodies moves them with mass, impulses and friction; the
+// push-apart then only takes out what overlap the impulses leave.
+// With contact reporting on, each tick also fills a ContactEventBuffer with the
+// contacts found, for sounds and effects.
+// The mat grows with the number of sumos so a crowd starts out packed but not
+// piled on top of itself.
+//
+// Like SumoSimulation, every random choice comes from a CounterRandom keyed by
+// the arena's seed, the sumo and the tick, and the contact batches don't depend on how they are scheduled, so
+// the same seed reproduces the same battle on any number of threads.
+
+#include "../GameObjects/GameConstants.h"
+#include "SumoSimulation.h"
+#include "Broadphase.h"
+#include "ContactKernel.h"
+#include "ContactColoring.h"
+#include "JobSystem.h"
+#include "AIScheduler.h"
+#include "RigidBodies.h"
+#include "ContactEvents.h"
+
+#include <vector>
+
+namespace Simulation
+{
+	class SumoArena
+	{
+	public:
+		SumoArena();
+
+		// Place 'wrestlerCount' sumos at random on a mat of the given radius.  A radius
+		// of zero picks RingRadiusFor(wrestlerCount).
+		void Reset(uint32_t wrestlerCount, GameConstants::Behavior behavior, uint64_t seed, float ringRadius = 0.0f);
+
+		// Advance exactly one GameConstants::Physics::FrameLength step.
+		void Tick();
+
+		static float RingRadiusFor(uint32_t wrestlerCount);
+
+		// Resolve contacts on the job system's threads; null resolves them on the calling thread.
+		void Jobs(JobSystem* jobs)                  { m_jobs = jobs; }
+
+		// Spread the AI's decisions over time with an AIScheduler instead of checking
+		// every sumo on every tick.
+		void AIScheduling(bool enabled, const AIScheduleSettings& settings = DefaultAIScheduleSettings());
+		bool AIScheduling() const                   { return m_scheduling; }
+
+		// Move the sumos with RigidBodies instead of straight to where the AI puts them.
+		void Dynamics(bool enabled, const BodySettings& settings = DefaultBodySettings());
+		bool Dynamics() const                       { return m_dynamics; }
+		RigidBodies& Bodies()                       { return m_bodies; }
+		const RigidBodies& Bodies() const           { return m_bodies; }
+
+		// Report the contacts of each tick in ContactEvents().
+		void ReportContacts(bool enabled, const ContactEventSettings& settings = DefaultContactEventSettings());
+		bool ReportContacts() const                 { return m_reporting; }
+		const ContactEventBuffer& ContactEvents() const { return m_contactEvents; }
+
+		// What the AI did on the last tick and how long it took.
+		const AITickStats& AICost() const           { return m_aiCost; }
+
+		uint64_t Checksum() const;
+
+		EntityStore& Entities()                     { return m_entities; }
+		const EntityStore& Entities() const         { return m_entities; }
+		uint32_t Remaining() const                  { return m_entities.Count(); }
+		float RingRadius() const                    { return m_ringRadius; }
+		uint32_t TickCount() const                  { return m_tickCount; }
+
+		// Candidate pairs found by the broadphase on the last tick.
+		const std::vector<ContactPair>& CandidatePairs() const { return m_pairs; }
+		const ContactColoring& ContactBatches() const { return m_coloring; }
+
+		// The steps of a tick, exposed so they can be timed separately.
+		void UpdateAI(float deltaTime);
+		void FindContacts();
+		void ColorContacts();
+		void ResolveContacts();
+		void RemoveRingOuts();
+		// The dynamics part of a tick: everything from the drives to the sleep test.
+		void StepBodies(float deltaTime);
+
+		// Draw every sumo at its position, facing its opponent, and rebuild the model
+		// matrices that changed.
+		void UpdateTransforms();
+
+	private:
+		EntityHandle ChooseTarget(uint32_t index, RandomStream& random);
+		void UpdateScheduledAI(float deltaTime);
+		void Steer(uint32_t index);
+		void UpdateDrives(float deltaTime);
+
+		EntityStore               m_entities;
+		std::vector<AIState>      m_ai;          // Indexed like the entities.
+		std::vector<EntityHandle> m_targets;     // Indexed like the entities.
+		UniformGrid               m_grid;
+		std::vector<ContactPair>  m_pairs;
+		ContactColoring           m_coloring;
+		JobSystem*                m_jobs;
+		AIScheduler               m_scheduler;
+		bool                      m_scheduling;
+		AITickStats               m_aiCost;
+		RigidBodies               m_bodies;
+		bool                      m_dynamics;
+		ContactEventBuffer        m_contactEvents;
+		bool                      m_reporting;
+		std::vector<float>        m_driveStartX; // Positions before the AI moved, while its moves are turned into drives.
+		std::vector<float>        m_driveStartZ;
+		CounterRandom             m_random;
+		float                     m_ringRadius;
+		uint32_t                  m_tickCount;
+	};
+}
@@ -0,0 +1,391 @@
+#include "SumoSimulation.h"
+#include "SweptCollision.h"
+
+#include <cstring>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+SumoSimulation::SumoSimulation() :
+	m_player(InvalidEntity),
+	m_enemy(InvalidEntity),
+	m_enemyTimings(DefaultAITimings()),
+	m_planning(false),
+	m_plannerSettings(DefaultPlannerSettings())
+{
+	memset(&m_lastPlan, 0, sizeof(m_lastPlan));
+	// A tick reports at most the one contact between the sumos, but the buffer is
+	// sized like the queue the game hands its events to, so frames never allocate.
+	m_contactEvents.Reserve(GameConstants::Sound::EventQueueSize);
+	Reset(GameConstants::Easy, 0);
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::Reset(GameConstants::Behavior enemyBehavior, uint64_t seed)
+{
+	Float3 playerStart = MakeFloat3(GameConstants::Arena::PlayerStartX, GameConstants::Arena::StartHeight, 0.0f);
+	Float3 enemyStart = MakeFloat3(GameConstants::Arena::EnemyStartX, GameConstants::Arena::StartHeight, 0.0f);
+
+	// The sumos are created once and keep their handles across rounds, since the
+	// game's render objects refer to them.
+	if (!m_entities.Valid(m_player))
+	{
+		m_player = m_entities.Create(playerStart);
+	}
+	if (!m_entities.Valid(m_enemy))
+	{
+		m_enemy = m_entities.Create(enemyStart);
+	}
+
+	Float3 zero = MakeFloat3(0.0f, 0.0f, 0.0f);
+	PlayerPosition(playerStart);
+	EnemyPosition(enemyStart);
+	m_entities.Velocity(m_entities.Index(m_player), zero);
+	m_entities.Velocity(m_entities.Index(m_enemy), zero);
+
+	m_enemyAI.behavior = enemyBehavior;
+	m_enemyAI.choice = GameConstants::Walk;
+	m_enemyAI.delay = m_enemyTimings.initialDelay;
+
+	m_random.Seed(seed);
+	m_tickCount = 0;
+	m_playerExitTime = 0.0f;
+	m_enemyExitTime = 0.0f;
+	m_contactEvents.Clear(0);
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::PlayerPosition(Float3 position)
+{
+	m_entities.Position(m_entities.Index(m_player), position);
+	m_previousPlayerPosition = position;
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::EnemyPosition(Float3 position)
+{
+	m_entities.Position(m_entities.Index(m_enemy), position);
+	m_previousEnemyPosition = position;
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::Step(float deltaTime, bool swept, bool versus)
+{
+	uint32_t player = m_entities.Index(m_player);
+	uint32_t enemy = m_entities.Index(m_enemy);
+	Float3 playerStart = m_entities.Position(player);
+	Float3 enemyStart = m_entities.Position(enemy);
+	Float3 playerPosition = playerStart;
+	Float3 enemyPosition = enemyStart;
+
+	// Update the player position.
+	playerPosition = playerPosition + m_entities.Velocity(player) * deltaTime;
+
+	// AI update.  The enemy draws from its own stream for this tick.
+	if (versus)
+	{
+		enemyPosition = enemyPosition + m_entities.Velocity(enemy) * deltaTime;
+	}
+	else if (m_planning && m_enemyAI.behavior == GameConstants::Smart)
+	{
+		PlanEnemyAction(enemyPosition, playerPosition, Length(m_entities.Velocity(player)), deltaTime);
+	}
+	else
+	{
+		RandomStream random(m_random, m_enemy.slot, m_tickCount);
+		DetermineAIAction(enemyPosition, playerPosition, m_enemyAI, random, deltaTime, m_enemyTimings);
+	}
+
+	// Check for player/enemy collision.
+	Float3 playerMoved = playerPosition;
+	Float3 enemyMoved = enemyPosition;
+	if (swept)
+	{
+		ResolveSweptContact(playerStart, playerPosition, enemyStart, enemyPosition);
+		m_playerExitTime = RingExitTime(playerStart, playerPosition - playerStart, GameConstants::Arena::RingRadius);
+		m_enemyExitTime = RingExitTime(enemyStart, enemyPosition - enemyStart, GameConstants::Arena::RingRadius);
+	}
+	else
+	{
+		ResolveContact(playerPosition, enemyPosition);
+		m_playerExitTime = 0.0f;
+		m_enemyExitTime = 0.0f;
+	}
+
+	// Report the contact with the impulse that pushed the sumos apart.
+	m_contactEvents.Clear(m_tickCount);
+	float separation = Length((enemyPosition - enemyMoved) - (playerPosition - playerMoved));
+	if (separation > 0.0f)
+	{
+		Float3 contact = (playerPosition + enemyPosition) * 0.5f;
+		m_contactEvents.Add(m_player, m_enemy, separation * GameConstants::Arena::SumoMass * 0.5f / deltaTime, contact.x, contact.z);
+	}
+
+	m_entities.Position(player, playerPosition);
+	m_entities.Position(enemy, enemyPosition);
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::SmartPlanning(bool enabled, const PlannerSettings& settings)
+{
+	m_planning = enabled;
+	m_plannerSettings = settings;
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::PlanEnemyAction(Float3& enemyPosition, Float3 playerPosition, float playerSpeed, float deltaTime)
+{
+	// The same timing as DetermineAIAction, with the planner making the choice.
+	m_enemyAI.delay -= deltaTime;
+	if (m_enemyAI.delay <= 0)
+	{
+		DuelState duel = { enemyPosition, playerPosition, playerSpeed, m_enemyAI.behavior, GameConstants::Arena::RingRadius };
+		m_lastPlan = m_planner.Plan(duel, m_enemyTimings, m_random.Seed() + m_enemy.slot, m_tickCount, m_plannerSettings);
+		m_enemyAI.choice = m_lastPlan.choice;
+		m_enemyAI.delay = m_lastPlan.delay;
+	}
+
+	ApplyManeuver(enemyPosition, playerPosition, m_enemyAI.behavior, m_enemyAI.choice, deltaTime);
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::Tick(const TickInput& input)
+{
+	m_previousPlayerPosition = PlayerPosition();
+	m_previousEnemyPosition = EnemyPosition();
+
+	m_entities.Velocity(m_entities.Index(m_player), input.playerVelocity);
+	Step(GameConstants::Physics::FrameLength, false, false);
+	m_tickCount++;
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::SweptTick(const TickInput& input, float deltaTime)
+{
+	m_previousPlayerPosition = PlayerPosition();
+	m_previousEnemyPosition = EnemyPosition();
+
+	m_entities.Velocity(m_entities.Index(m_player), input.playerVelocity);
+	Step(deltaTime, true, false);
+	m_tickCount++;
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::VersusTick(const TickInput& playerInput, const TickInput& enemyInput)
+{
+	m_previousPlayerPosition = PlayerPosition();
+	m_previousEnemyPosition = EnemyPosition();
+
+	m_entities.Velocity(m_entities.Index(m_player), playerInput.playerVelocity);
+	m_entities.Velocity(m_entities.Index(m_enemy), enemyInput.playerVelocity);
+	Step(GameConstants::Physics::FrameLength, false, true);
+	m_tickCount++;
+}
+
+//----------------------------------------------------------------------
+
+RoundResult SumoSimulation::CheckRingOut() const
+{
+	bool playerOut = IsRingOut(PlayerPosition());
+	bool enemyOut = IsRingOut(EnemyPosition());
+	if (playerOut && (!enemyOut || m_playerExitTime <= m_enemyExitTime))
+	{
+		return RoundResult::PlayerRingOut;
+	}
+	if (enemyOut)
+	{
+		return RoundResult::EnemyRingOut;
+	}
+	return RoundResult::InProgress;
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::Save(WorldState& state) const
+{
+	uint32_t player = m_entities.Index(m_player);
+	uint32_t enemy = m_entities.Index(m_enemy);
+	state.seed = m_random.Seed();
+	state.tickCount = m_tickCount;
+	state.playerExitTime = m_playerExitTime;
+	state.enemyExitTime = m_enemyExitTime;
+	state.playerPosition = m_entities.Position(player);
+	state.playerVelocity = m_entities.Velocity(player);
+	state.enemyPosition = m_entities.Position(enemy);
+	state.enemyVelocity = m_entities.Velocity(enemy);
+	state.previousPlayerPosition = m_previousPlayerPosition;
+	state.previousEnemyPosition = m_previousEnemyPosition;
+	state.enemyAI = m_enemyAI;
+}
+
+//----------------------------------------------------------------------
+
+void SumoSimulation::Restore(const WorldState& state)
+{
+	uint32_t player = m_entities.Index(m_player);
+	uint32_t enemy = m_entities.Index(m_enemy);
+	m_random.Seed(state.seed);
+	m_tickCount = state.tickCount;
+	m_playerExitTime = state.playerExitTime;
+	m_enemyExitTime = state.enemyExitTime;
+	m_entities.Position(player, state.playerPosition);
+	m_entities.Velocity(player, state.playerVelocity);
+	m_entities.Position(enemy, state.enemyPosition);
+	m_entities.Velocity(enemy, state.enemyVelocity);
+	m_previousPlayerPosition = state.previousPlayerPosition;
+	m_previousEnemyPosition = state.previousEnemyPosition;
+	m_enemyAI = state.enemyAI;
+}
+
+//----------------------------------------------------------------------
+
+static Float3 Lerp(Float3 from, Float3 to, float alpha)
+{
+	return from + (to - from) * alpha;
+}
+
+Float3 SumoSimulation::PlayerRenderPosition(float alpha) const
+{
+	return Lerp(m_previousPlayerPosition, PlayerPosition(), alpha);
+}
+
+Float3 SumoSimulation::EnemyRenderPosition(float alpha) const
+{
+	return Lerp(m_previousEnemyPosition, EnemyPosition(), alpha);
+}
+
+//----------------------------------------------------------------------
+
+static void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+	// FNV-1a.
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+}
+
+static void HashFloat3(uint64_t& hash, Float3 value)
+{
+	float components[3] = { value.x, value.y, value.z };
+	uint32_t bits[3];
+	memcpy(bits, components, sizeof(bits));
+	HashBytes(hash, bits, sizeof(bits));
+}
+
+uint64_t SumoSimulation::Checksum() const
+{
+	uint64_t hash = 14695981039346656037ULL;
+	uint32_t player = m_entities.Index(m_player);
+	uint32_t enemy = m_entities.Index(m_enemy);
+	HashFloat3(hash, m_entities.Position(player));
+	HashFloat3(hash, m_entities.Velocity(player));
+	HashFloat3(hash, m_entities.Position(enemy));
+	HashFloat3(hash, m_entities.Velocity(enemy));
+
+	int32_t ai[2] = { m_enemyAI.behavior, m_enemyAI.choice };
+	HashBytes(hash, ai, sizeof(ai));
+	HashBytes(hash, &m_enemyAI.delay, sizeof(m_enemyAI.delay));
+
+	uint64_t seed = m_random.Seed();
+	HashBytes(hash, &seed, sizeof(seed));
+	HashBytes(hash, &m_tickCount, sizeof(m_tickCount));
+	return hash;
+}
+
+//----------------------------------------------------------------------
+
+void Simulation::DetermineAIAction(Float3& position, Float3 targetPosition, AIState& ai, RandomStream& random, float deltaTime,
+	const AITimings& timings)
+{
+	ai.delay -= deltaTime;
+
+	if (ai.delay <= 0)
+	{
+		ChooseManeuver(ai, random, timings);
+	}
+
+	ApplyManeuver(position, targetPosition, ai.behavior, ai.choice, deltaTime);
+}
+
+//----------------------------------------------------------------------
+
+void Simulation::ChooseManeuver(AIState& ai, RandomStream& random, const AITimings& timings)
+{
+	ai.choice = static_cast<GameConstants::ManeuverState>(random.NextInt(3));
+
+	// Delay until next action.
+	ai.delay = timings.minimumDelay + random.NextInt(timings.delayChoices) * timings.delayStep;
+}
+
+//----------------------------------------------------------------------
+
+void Simulation::ApplyManeuver(Float3& position, Float3 targetPosition, GameConstants::Behavior behavior,
+	GameConstants::ManeuverState choice, float deltaTime)
+{
+	Float3 up = MakeFloat3(0.0f, 1.0f, 0.0f);
+	Float3 direction;
+	switch (choice)
+	{
+	case GameConstants::Dodge:
+		// Dodge sideways.  Easy sumos dodge the other way and Angry sumos don't dodge at all.
+		direction = Cross(targetPosition - position, up);
+		position = position + Normalize(direction) * (deltaTime * (behavior - 1));
+		if (behavior != GameConstants::Angry)
+		{
+			break;
+		}
+		// Angry sumos push as well.
+		// fall through
+	case GameConstants::Push:
+		// Push harder.
+		direction = targetPosition - position;
+		position = position + Normalize(direction) * (deltaTime * behavior);
+		break;
+
+	default:
+		// Move forward normally.
+		direction = targetPosition - position;
+		position = position + Normalize(direction) * deltaTime;
+		break;
+	}
+}
+
+//----------------------------------------------------------------------
+
+void Simulation::ResolveContact(Float3& positionA, Float3& positionB)
+{
+	float xDelta = positionB.x - positionA.x;
+	float zDelta = positionB.z - positionA.z;
+
+	// Since each sumo is one unit wide, subtracting the sumo size from the distance between
+	// them gives a negative overlap value when a contact has occurred.
+	float overlap = std::sqrt(xDelta * xDelta + zDelta * zDelta) - GameConstants::Arena::SumoSize;
+	if (overlap < 0)
+	{
+		Float3 aToB = positionB - positionA;
+		positionA = positionA + aToB * (overlap * 0.5f);
+		positionB = positionB - aToB * (overlap * 0.5f);
+	}
+}
+
+//----------------------------------------------------------------------
+
+bool Simulation::IsRingOut(Float3 position, float ringRadius)
+{
+	return Length(position) > ringRadius;
+}
+
+//----------------------------------------------------------------------
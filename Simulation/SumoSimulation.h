@@ -0,0 +1,194 @@
+#pragma once
+
+// SumoSimulation:
+// This class holds the complete game play state of a sumo match and advances it
+// using the same rules as the game: the player moves with the velocity supplied
+// by its controller, the AI chooses a maneuver (Walk, Dodge or Push) based on its
+// behavior, overlapping sumo blocks are pushed apart, and a sumo whose center
+// leaves the mat has been rung out.
+// It is written in standard C++ with no dependency on the Windows Runtime or
+// DirectX so the same rules can be run headless.  The sumos are entities in the
+// simulation's EntityStore; SumoDX adds the rest of the scene to the same store
+// and its game objects are views onto it.
+//
+// Every random choice is drawn from a CounterRandom keyed by the match seed,
+// the entity making the choice and the tick, and each Tick() advances exactly
+// one GameConstants::Physics::FrameLength step with the input for that tick, so
+// the same seed and the same inputs reproduce the same positions bit for bit.
+// SweptTick() instead advances a whole rendered frame in one step, using the
+// swept collision tests so that a long step doesn't let the sumos pass through
+// each other or lose track of who left the ring first.
+// Each step reports the contact between the sumos, if there was one, as a
+// ContactEvent for sounds and effects.
+
+#include "../GameObjects/GameConstants.h"
+#include "SimMath.h"
+#include "CounterRandom.h"
+#include "EntityStore.h"
+#include "SmartPlanner.h"
+#include "ContactEvents.h"
+
+namespace Simulation
+{
+	struct AIState
+	{
+		GameConstants::Behavior      behavior;
+		GameConstants::ManeuverState choice;
+		float                        delay;     // Seconds until the next maneuver choice.
+	};
+
+	// How long an AI sticks with a maneuver.  The first choice is made after
+	// initialDelay; each choice then lasts minimumDelay + n * delayStep seconds
+	// for a random n in [0, delayChoices).
+	struct AITimings
+	{
+		float initialDelay;
+		float minimumDelay;
+		float delayStep;
+		int   delayChoices;
+	};
+
+	inline AITimings DefaultAITimings()
+	{
+		AITimings timings = {
+			GameConstants::Arena::InitialAIDelay,
+			GameConstants::Arena::MinimumAIDelay,
+			GameConstants::Arena::AIDelayStep,
+			GameConstants::Arena::AIDelayChoices,
+		};
+		return timings;
+	}
+
+	// The input consumed by one fixed simulation tick.
+	struct TickInput
+	{
+		Float3 playerVelocity;
+	};
+
+	// Everything the next tick of a SumoSimulation depends on, as plain data with no
+	// padding, so a whole world is saved or restored with one memcpy and two states
+	// can be compared and delta compressed word by word.  The tick count doubles as
+	// the match clock.  Settings that don't change during a match (the AI timings
+	// and planner settings) aren't included.
+	struct WorldState
+	{
+		uint64_t seed;
+		uint32_t tickCount;
+		float    playerExitTime;
+		float    enemyExitTime;
+		Float3   playerPosition;
+		Float3   playerVelocity;
+		Float3   enemyPosition;
+		Float3   enemyVelocity;
+		Float3   previousPlayerPosition;
+		Float3   previousEnemyPosition;
+		AIState  enemyAI;
+	};
+
+	enum class RoundResult
+	{
+		InProgress,
+		PlayerRingOut,
+		EnemyRingOut,
+	};
+
+	class SumoSimulation
+	{
+	public:
+		SumoSimulation();
+
+		void Reset(GameConstants::Behavior enemyBehavior, uint64_t seed);
+
+		// Apply the input and advance exactly one GameConstants::Physics::FrameLength step.
+		// Use a FixedStepper to decide how many ticks to run for a rendered frame.
+		void Tick(const TickInput& input);
+
+		// Apply the input and advance one step of 'deltaTime' seconds, with contacts and
+		// ring outs found by time of impact.  Meant for one step per rendered frame;
+		// the result depends on the frame times, so it is not used for replays.
+		void SweptTick(const TickInput& input, float deltaTime);
+
+		// A tick of a two player match: the enemy moves with the second player's input
+		// instead of its AI.
+		void VersusTick(const TickInput& playerInput, const TickInput& enemyInput);
+
+		// When both sumos are out, the one that left the ring first during the last
+		// step loses.
+		RoundResult CheckRingOut() const;
+
+		// A hash of the exact bits of the game play state, for comparing runs.
+		uint64_t Checksum() const;
+
+		// Copy the world out, or put a saved world back, for rollback and rollouts.
+		void Save(WorldState& state) const;
+		void Restore(const WorldState& state);
+
+		EntityStore& Entities()                     { return m_entities; }
+		const EntityStore& Entities() const         { return m_entities; }
+		EntityHandle PlayerEntity() const           { return m_player; }
+		EntityHandle EnemyEntity() const            { return m_enemy; }
+
+		Float3 PlayerPosition() const               { return m_entities.Position(m_entities.Index(m_player)); }
+		Float3 EnemyPosition() const                { return m_entities.Position(m_entities.Index(m_enemy)); }
+		void PlayerPosition(Float3 position);
+		void EnemyPosition(Float3 position);
+		void EnemyBehavior(GameConstants::Behavior behavior) { m_enemyAI.behavior = behavior; }
+		// Takes effect from the next Reset().
+		void EnemyTimings(const AITimings& timings) { m_enemyTimings = timings; }
+		const AITimings& EnemyTimings() const       { return m_enemyTimings; }
+		const AIState& EnemyAI() const              { return m_enemyAI; }
+
+		// Let a Smart enemy plan its maneuvers with a SmartPlanner instead of choosing
+		// them at random.  Runs that have to be reproduced, such as replays, must plan
+		// with an iteration limit and no time budget.
+		void SmartPlanning(bool enabled, const PlannerSettings& settings = DefaultPlannerSettings());
+		bool SmartPlanning() const                  { return m_planning; }
+		const PlannerSettings& SmartPlanningSettings() const { return m_plannerSettings; }
+		const PlannerDecision& LastPlan() const     { return m_lastPlan; }
+		uint32_t TickCount() const                  { return m_tickCount; }
+		// The contacts of the last tick.
+		const ContactEventBuffer& ContactEvents() const { return m_contactEvents; }
+		uint64_t Seed() const                       { return m_random.Seed(); }
+
+		// Positions blended between the state before and after the last tick, where
+		// alpha is FixedStepper::Alpha() for the frame being rendered, or 1 after a
+		// SweptTick().
+		Float3 PlayerRenderPosition(float alpha) const;
+		Float3 EnemyRenderPosition(float alpha) const;
+
+	private:
+		void Step(float deltaTime, bool swept, bool versus);
+		void PlanEnemyAction(Float3& enemyPosition, Float3 playerPosition, float playerSpeed, float deltaTime);
+
+		EntityStore   m_entities;
+		EntityHandle  m_player;
+		EntityHandle  m_enemy;
+		AIState       m_enemyAI;
+		AITimings     m_enemyTimings;
+		CounterRandom m_random;
+		uint32_t      m_tickCount;
+
+		bool            m_planning;
+		PlannerSettings m_plannerSettings;
+		PlannerDecision m_lastPlan;
+		SmartPlanner    m_planner;
+
+		Float3        m_previousPlayerPosition;
+		Float3        m_previousEnemyPosition;
+		float         m_playerExitTime;     // Fractions of the last step at which the sumos left the ring.
+		float         m_enemyExitTime;
+
+		ContactEventBuffer m_contactEvents;
+	};
+
+	// Game play rules shared by every sumo simulation.
+	void DetermineAIAction(Float3& position, Float3 targetPosition, AIState& ai, RandomStream& random, float deltaTime,
+		const AITimings& timings = DefaultAITimings());
+	// Pick the next maneuver at random, and how long to keep it up.
+	void ChooseManeuver(AIState& ai, RandomStream& random, const AITimings& timings = DefaultAITimings());
+	// Move 'position' one step of the given maneuver against 'targetPosition'.
+	void ApplyManeuver(Float3& position, Float3 targetPosition, GameConstants::Behavior behavior,
+		GameConstants::ManeuverState choice, float deltaTime);
+	void ResolveContact(Float3& positionA, Float3& positionB);
+	bool IsRingOut(Float3 position, float ringRadius = GameConstants::Arena::RingRadius);
+}
@@ -0,0 +1,96 @@
+#include "SweptCollision.h"
+#include "SumoSimulation.h"
+
+#include <cmath>
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+// The first root in [0, 1] of a t^2 + b t + c = 0 for a point that starts outside
+// (c > 0), or NoImpact.
+static float FirstRoot(float a, float b, float c)
+{
+	if (a <= 0.0f)
+	{
+		return NoImpact;
+	}
+	float discriminant = b * b - 4.0f * a * c;
+	if (discriminant < 0.0f)
+	{
+		return NoImpact;
+	}
+	float time = (-b - std::sqrt(discriminant)) / (2.0f * a);
+	return (time >= 0.0f && time <= 1.0f) ? time : NoImpact;
+}
+
+//----------------------------------------------------------------------
+
+float Simulation::CircleImpactTime(Float3 startA, Float3 moveA, Float3 startB, Float3 moveB, float distance)
+{
+	// Solve |separation + t * closing| = distance for the earliest t.
+	Float3 separation = startB - startA;
+	Float3 closing = moveB - moveA;
+	float c = Dot(separation, separation) - distance * distance;
+	if (c <= 0.0f)
+	{
+		return 0.0f;
+	}
+	return FirstRoot(Dot(closing, closing), 2.0f * Dot(separation, closing), c);
+}
+
+//----------------------------------------------------------------------
+
+float Simulation::RingExitTime(Float3 start, Float3 move, float ringRadius)
+{
+	// Solve |start + t * move| = ringRadius.  From inside the ring the crossing is
+	// the larger root, where the path leaves the circle.
+	float c = Dot(start, start) - ringRadius * ringRadius;
+	if (c > 0.0f)
+	{
+		return 0.0f;
+	}
+	float a = Dot(move, move);
+	if (a <= 0.0f)
+	{
+		return NoImpact;
+	}
+	float b = 2.0f * Dot(start, move);
+	float time = (-b + std::sqrt(b * b - 4.0f * a * c)) / (2.0f * a);
+	return (time <= 1.0f) ? time : NoImpact;
+}
+
+//----------------------------------------------------------------------
+
+void Simulation::ResolveSweptContact(Float3 startA, Float3& positionA, Float3 startB, Float3& positionB)
+{
+	Float3 moveA = positionA - startA;
+	Float3 moveB = positionB - startB;
+	float impact = CircleImpactTime(startA, moveA, startB, moveB, GameConstants::Arena::SumoSize);
+	if (impact > 1.0f)
+	{
+		return;
+	}
+
+	// The contact normal where they first touched.
+	Float3 normal = (startB + moveB * impact) - (startA + moveA * impact);
+	normal.y = 0.0f;
+	normal = Normalize(normal);
+	if (Dot(normal, normal) == 0.0f)
+	{
+		// Centers on top of each other: there is no direction to push along.
+		ResolveContact(positionA, positionB);
+		return;
+	}
+
+	// Take out whatever of the step would leave them closer than touching along it.
+	float gap = Dot(positionB - positionA, normal);
+	if (gap < GameConstants::Arena::SumoSize)
+	{
+		float push = (GameConstants::Arena::SumoSize - gap) * 0.5f;
+		positionA = positionA - normal * push;
+		positionB = positionB + normal * push;
+	}
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,32 @@
+#pragma once
+
+// Swept collision:
+// Time of impact tests for sumos moving in straight lines over one step, so a
+// step can be as long as a rendered frame without fast sumos passing through
+// each other.  Times are fractions of the step: 0 is its start and 1 its end.
+// A sumo is a circle on the mat; heights are carried along but sumos never
+// move vertically.
+
+#include "SimMath.h"
+
+namespace Simulation
+{
+	// Returned by the tests when nothing happens during the step.
+	const float NoImpact = 2.0f;
+
+	// When two centers moving from startA by moveA and from startB by moveB first
+	// come within 'distance' of each other.  Centers already that close at the start
+	// meet at 0.
+	float CircleImpactTime(Float3 startA, Float3 moveA, Float3 startB, Float3 moveB, float distance);
+
+	// When a center moving from 'start' by 'move' first leaves a ring of radius
+	// 'ringRadius', measured the same way as IsRingOut.  A center already outside
+	// leaves at 0.
+	float RingExitTime(Float3 start, Float3 move, float ringRadius);
+
+	// The swept form of ResolveContact: two sumos have moved from startA and startB
+	// to positionA and positionB.  If they touched on the way, they are pushed apart
+	// along the line between their centers at the moment they touched, so a sumo
+	// that would have passed through the other ends up against it instead.
+	void ResolveSweptContact(Float3 startA, Float3& positionA, Float3 startB, Float3& positionB);
+}
@@ -0,0 +1,100 @@
+#include "TransformSystem.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMO_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+// Write the rotation part of 'transform': the basis rows times the rotation about
+// y whose rows are (cosine, 0, sine), (0, 1, 0) and (-sine, 0, cosine).  This is
+// XMMatrixRotationY of the angle whose cosine is 'cosine' and sine is '-sine'.
+static inline void ComposeRotation(const Float4x4& basis, float cosine, float sine, Float4x4& transform)
+{
+#if defined(SUMO_TRANSFORM_SSE2)
+	const __m128 facingX = _mm_setr_ps(cosine, 0.0f, sine, 0.0f);
+	const __m128 facingY = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+	const __m128 facingZ = _mm_setr_ps(-sine, 0.0f, cosine, 0.0f);
+
+	for (int row = 0; row < 3; row++)
+	{
+		__m128 result = _mm_add_ps(
+			_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(basis.m[row][0]), facingX),
+				_mm_mul_ps(_mm_set1_ps(basis.m[row][1]), facingY)),
+			_mm_mul_ps(_mm_set1_ps(basis.m[row][2]), facingZ));
+		_mm_storeu_ps(transform.m[row], result);
+	}
+#else
+	for (int row = 0; row < 3; row++)
+	{
+		float x = basis.m[row][0];
+		float y = basis.m[row][1];
+		float z = basis.m[row][2];
+		transform.m[row][0] = x * cosine - z * sine;
+		transform.m[row][1] = y;
+		transform.m[row][2] = x * sine + z * cosine;
+		transform.m[row][3] = 0.0f;
+	}
+#endif
+}
+
+//----------------------------------------------------------------------
+
+uint32_t Simulation::UpdateTransforms(EntityStore& entities)
+{
+	uint32_t count = entities.Count();
+	Float4x4* transforms = entities.Transforms();
+	const Float4x4* bases = entities.Bases();
+	const EntityHandle* targets = entities.FacingTargets();
+	uint8_t* dirty = entities.TransformDirty();
+
+	// An entity facing a target that moved has to turn, even if it didn't move itself.
+	// Facing depends only on the target's position, so one level is enough.
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (entities.Valid(targets[i]))
+		{
+			dirty[i] |= dirty[entities.Index(targets[i])];
+		}
+	}
+
+	uint32_t rebuilt = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (dirty[i] == 0)
+		{
+			continue;
+		}
+
+		float cosine = 1.0f;
+		float sine = 0.0f;
+		if (entities.Valid(targets[i]))
+		{
+			const Float4x4& target = transforms[entities.Index(targets[i])];
+			float xDirection = target.m[3][0] - transforms[i].m[3][0];
+			float zDirection = target.m[3][2] - transforms[i].m[3][2];
+			float lengthSquared = xDirection * xDirection + zDirection * zDirection;
+
+			// Keep facing along x when standing on top of the target.
+			if (lengthSquared > 0.0f)
+			{
+				float inverseLength = 1.0f / std::sqrt(lengthSquared);
+				cosine = xDirection * inverseLength;
+				sine = zDirection * inverseLength;
+			}
+		}
+
+		ComposeRotation(bases[i], cosine, sine, transforms[i]);
+		dirty[i] = 0;
+		rebuilt++;
+	}
+	return rebuilt;
+}
+
+//----------------------------------------------------------------------
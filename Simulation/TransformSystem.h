@@ -0,0 +1,23 @@
+#pragma once
+
+// Transform system:
+// Rebuilds the model matrices of an EntityStore once per rendered frame instead
+// of every time an entity moves.  Each entity's matrix is its basis (scale and
+// rotation), turned about y to face its facing target if it has one, then
+// translated to its render position.  Only entities marked dirty, or facing an
+// entity that is, are rebuilt.
+//
+// Facing is worked out from the direction to the target directly: the cosine
+// and sine of the turn are the normalized x and z of that direction, so no
+// angle is ever computed.
+
+#include "EntityStore.h"
+
+#include <cstdint>
+
+namespace Simulation
+{
+	// Rebuild every dirty model matrix and clear the dirty flags.  Returns the
+	// number of matrices rebuilt.
+	uint32_t UpdateTransforms(EntityStore& entities);
+}
@@ -0,0 +1,128 @@
+#include "Transport.h"
+
+using namespace Simulation;
+
+//----------------------------------------------------------------------
+
+LoopbackLink::LoopbackLink()
+{
+	m_ends[0].Connect(&m_ends[1]);
+	m_ends[1].Connect(&m_ends[0]);
+}
+
+//----------------------------------------------------------------------
+
+void LoopbackLink::Endpoint::Send(const uint8_t* data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_peer->m_mutex);
+	m_peer->m_inbox.push_back(std::vector<uint8_t>(data, data + size));
+}
+
+//----------------------------------------------------------------------
+
+bool LoopbackLink::Endpoint::Receive(std::vector<uint8_t>& packet)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_inbox.empty())
+	{
+		return false;
+	}
+	packet.swap(m_inbox.front());
+	m_inbox.pop_front();
+	return true;
+}
+
+//----------------------------------------------------------------------
+
+SimulatedLink::SimulatedLink(const LinkConditions& conditions, uint64_t seed) :
+	m_conditions(conditions),
+	m_random(seed),
+	m_now(0),
+	m_sequence(0)
+{
+	m_stats.sent = 0;
+	m_stats.dropped = 0;
+	m_ends[0].Connect(this, 0);
+	m_ends[1].Connect(this, 1);
+}
+
+//----------------------------------------------------------------------
+
+void SimulatedLink::Advance(uint32_t microseconds)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_now += microseconds;
+}
+
+//----------------------------------------------------------------------
+
+void SimulatedLink::Post(uint32_t toSide, const uint8_t* data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// One stream per packet, so each packet's fate depends only on its sequence number.
+	RandomStream random(m_random, m_sequence, 0);
+	uint32_t sequence = m_sequence++;
+	m_stats.sent++;
+	if (random.NextFloat() < m_conditions.loss)
+	{
+		m_stats.dropped++;
+		return;
+	}
+
+	Packet packet;
+	packet.deliverAt = m_now + m_conditions.latencyMicroseconds;
+	if (m_conditions.jitterMicroseconds > 0)
+	{
+		packet.deliverAt += random.NextInt(m_conditions.jitterMicroseconds + 1);
+	}
+	packet.sequence = sequence;
+	packet.data.assign(data, data + size);
+	m_inFlight[toSide].push_back(packet);
+}
+
+//----------------------------------------------------------------------
+
+bool SimulatedLink::Take(uint32_t side, std::vector<uint8_t>& packet)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// The earliest packet that is due; with jitter that may not be the first sent.
+	std::vector<Packet>& inFlight = m_inFlight[side];
+	size_t earliest = inFlight.size();
+	for (size_t i = 0; i < inFlight.size(); i++)
+	{
+		const Packet& candidate = inFlight[i];
+		if (candidate.deliverAt <= m_now && (earliest == inFlight.size() ||
+			candidate.deliverAt < inFlight[earliest].deliverAt ||
+			(candidate.deliverAt == inFlight[earliest].deliverAt && candidate.sequence < inFlight[earliest].sequence)))
+		{
+			earliest = i;
+		}
+	}
+	if (earliest == inFlight.size())
+	{
+		return false;
+	}
+
+	packet.swap(inFlight[earliest].data);
+	inFlight[earliest] = inFlight.back();
+	inFlight.pop_back();
+	return true;
+}
+
+//----------------------------------------------------------------------
+
+void SimulatedLink::Endpoint::Send(const uint8_t* data, size_t size)
+{
+	m_link->Post(1 - m_side, data, size);
+}
+
+//----------------------------------------------------------------------
+
+bool SimulatedLink::Endpoint::Receive(std::vector<uint8_t>& packet)
+{
+	return m_link->Take(m_side, packet);
+}
+
+//----------------------------------------------------------------------
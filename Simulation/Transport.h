@@ -0,0 +1,128 @@
+#pragma once
+
+// Transport:
+// Moves netplay packets between the two peers of a RollbackSession.  Packets
+// are unreliable datagrams: a transport may drop, delay or reorder them, and the
+// session is written to cope.
+//
+// Two in-process links are provided for running and measuring netplay offline:
+//  - LoopbackLink delivers every packet at once, in order;
+//  - SimulatedLink delays each packet by a latency plus a random jitter and
+//    drops a share of them.  The drops and delays come from a CounterRandom and
+//    time only moves when the caller advances it, so a run over a simulated
+//    link repeats exactly.
+// A transport over real sockets implements the same interface.
+
+#include "CounterRandom.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Simulation
+{
+	class Transport
+	{
+	public:
+		virtual ~Transport() {}
+
+		virtual void Send(const uint8_t* data, size_t size) = 0;
+
+		// Take the next packet that has arrived; false when none has.
+		virtual bool Receive(std::vector<uint8_t>& packet) = 0;
+	};
+
+	class LoopbackLink
+	{
+	public:
+		LoopbackLink();
+
+		// The two ends of the link, 0 and 1.  What one sends the other receives.
+		Transport& End(uint32_t side)               { return m_ends[side]; }
+
+	private:
+		LoopbackLink(const LoopbackLink&);
+		LoopbackLink& operator=(const LoopbackLink&);
+
+		class Endpoint : public Transport
+		{
+		public:
+			Endpoint() : m_peer(nullptr) {}
+
+			void Connect(Endpoint* peer)            { m_peer = peer; }
+			virtual void Send(const uint8_t* data, size_t size) override;
+			virtual bool Receive(std::vector<uint8_t>& packet) override;
+
+		private:
+			Endpoint*                         m_peer;
+			std::mutex                        m_mutex;
+			std::deque<std::vector<uint8_t> > m_inbox;
+		};
+
+		Endpoint m_ends[2];
+	};
+
+	struct LinkConditions
+	{
+		uint32_t latencyMicroseconds;   // One way.
+		uint32_t jitterMicroseconds;    // Added to the latency, uniformly from 0 up to this.
+		float    loss;                  // Share of the packets dropped.
+	};
+
+	struct LinkStats
+	{
+		uint32_t sent;
+		uint32_t dropped;
+	};
+
+	class SimulatedLink
+	{
+	public:
+		SimulatedLink(const LinkConditions& conditions, uint64_t seed);
+
+		Transport& End(uint32_t side)               { return m_ends[side]; }
+
+		// Move the link's clock on; packets due by then can be received.
+		void Advance(uint32_t microseconds);
+		uint64_t Now() const                        { return m_now; }
+		const LinkStats& Stats() const              { return m_stats; }
+
+	private:
+		SimulatedLink(const SimulatedLink&);
+		SimulatedLink& operator=(const SimulatedLink&);
+
+		struct Packet
+		{
+			uint64_t             deliverAt;
+			uint32_t             sequence;  // Orders packets due at the same time.
+			std::vector<uint8_t> data;
+		};
+
+		class Endpoint : public Transport
+		{
+		public:
+			Endpoint() : m_link(nullptr), m_side(0) {}
+
+			void Connect(SimulatedLink* link, uint32_t side) { m_link = link; m_side = side; }
+			virtual void Send(const uint8_t* data, size_t size) override;
+			virtual bool Receive(std::vector<uint8_t>& packet) override;
+
+		private:
+			SimulatedLink* m_link;
+			uint32_t       m_side;
+		};
+
+		void Post(uint32_t toSide, const uint8_t* data, size_t size);
+		bool Take(uint32_t side, std::vector<uint8_t>& packet);
+
+		LinkConditions      m_conditions;
+		CounterRandom       m_random;
+		uint64_t            m_now;
+		uint32_t            m_sequence;
+		LinkStats           m_stats;
+		std::mutex          m_mutex;
+		std::vector<Packet> m_inFlight[2];  // Packets on their way to each side.
+		Endpoint            m_ends[2];
+	};
+}
@@ -0,0 +1,128 @@
+#include "WorldSnapshot.h"
+
+#include <cstring>
+
+using namespace Simulation;
+
+namespace
+{
+	const uint32_t StateWords = sizeof(WorldState) / sizeof(uint32_t);
+
+	void AppendWord(std::vector<uint8_t>& bytes, uint32_t word)
+	{
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			bytes.push_back(static_cast<uint8_t>(word >> shift));
+		}
+	}
+
+	uint32_t ReadWord(const uint8_t* bytes)
+	{
+		return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+			(static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+	}
+}
+
+//----------------------------------------------------------------------
+
+void Simulation::EncodeDelta(const WorldState& base, const WorldState& state, std::vector<uint8_t>& delta)
+{
+	uint32_t baseWords[StateWords];
+	uint32_t stateWords[StateWords];
+	memcpy(baseWords, &base, sizeof(baseWords));
+	memcpy(stateWords, &state, sizeof(stateWords));
+
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < StateWords; i++)
+	{
+		mask |= (baseWords[i] != stateWords[i]) ? (1u << i) : 0u;
+	}
+
+	delta.clear();
+	AppendWord(delta, mask);
+	for (uint32_t i = 0; i < StateWords; i++)
+	{
+		if (mask & (1u << i))
+		{
+			AppendWord(delta, baseWords[i] ^ stateWords[i]);
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+
+bool Simulation::DecodeDelta(const WorldState& base, const uint8_t* delta, size_t size, WorldState& state)
+{
+	if (size < sizeof(uint32_t))
+	{
+		return false;
+	}
+	uint32_t mask = ReadWord(delta);
+	size_t offset = sizeof(uint32_t);
+
+	uint32_t words[StateWords];
+	memcpy(words, &base, sizeof(words));
+	for (uint32_t i = 0; i < StateWords; i++)
+	{
+		if (mask & (1u << i))
+		{
+			if (offset + sizeof(uint32_t) > size)
+			{
+				return false;
+			}
+			words[i] ^= ReadWord(delta + offset);
+			offset += sizeof(uint32_t);
+		}
+	}
+	if (offset != size)
+	{
+		return false;
+	}
+
+	memcpy(&state, words, sizeof(state));
+	return true;
+}
+
+//----------------------------------------------------------------------
+
+SnapshotRing::SnapshotRing(uint32_t capacity) :
+	m_states(capacity),
+	m_saved(capacity, 0)
+{
+}
+
+//----------------------------------------------------------------------
+
+void SnapshotRing::Save(const SumoSimulation& simulation)
+{
+	uint32_t slot = simulation.TickCount() % Capacity();
+	simulation.Save(m_states[slot]);
+	m_saved[slot] = 1;
+}
+
+//----------------------------------------------------------------------
+
+const WorldState* SnapshotRing::Find(uint32_t tick) const
+{
+	uint32_t slot = tick % Capacity();
+	if (m_saved[slot] == 0 || m_states[slot].tickCount != tick)
+	{
+		return nullptr;
+	}
+	return &m_states[slot];
+}
+
+//----------------------------------------------------------------------
+
+bool SnapshotRing::Restore(SumoSimulation& simulation, uint32_t tick) const
+{
+	const WorldState* state = Find(tick);
+	if (state == nullptr)
+	{
+		return false;
+	}
+	simulation.Restore(*state);
+	return true;
+}
+
+//----------------------------------------------------------------------
@@ -0,0 +1,58 @@
+#pragma once
+
+// World snapshots:
+// Support for saving and restoring a SumoSimulation many times a frame, for
+// rollback netplay and for AI rollouts.
+//
+// SnapshotRing keeps the WorldState of the last few ticks, indexed by tick, so
+// the simulation can be put back to any of them and run forward again.
+//
+// EncodeDelta/DecodeDelta compress a state against an earlier one for sending or
+// storing many of them.  The two states are compared as 32-bit words; the delta
+// is a mask of the words that changed followed by each changed word XORed with
+// its old value:
+//     uint32   changed word mask, bit n for word n
+//     uint32   (old ^ new) for each changed word, in order
+// Between neighboring ticks only the positions, the clock and the AI's delay
+// usually change, so a delta is well under half the size of a state.
+
+#include "SumoSimulation.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Simulation
+{
+	static_assert(sizeof(WorldState) == sizeof(uint64_t) + 3 * sizeof(uint32_t) + 6 * sizeof(Float3) + sizeof(AIState),
+		"world states have no padding, so equal states have equal bytes");
+	static_assert(sizeof(WorldState) % sizeof(uint32_t) == 0, "world states are compared as 32-bit words");
+	static_assert(sizeof(WorldState) / sizeof(uint32_t) <= 32, "the changed word mask has one bit per word");
+
+	// Replace 'delta' with the delta from 'base' to 'state'.
+	void EncodeDelta(const WorldState& base, const WorldState& state, std::vector<uint8_t>& delta);
+
+	// Rebuild a state from 'base' and a delta made against it.  False if the delta is
+	// truncated or has bytes left over.
+	bool DecodeDelta(const WorldState& base, const uint8_t* delta, size_t size, WorldState& state);
+
+	class SnapshotRing
+	{
+	public:
+		// Keep the states of the last 'capacity' ticks.
+		explicit SnapshotRing(uint32_t capacity);
+
+		// Save the simulation's state for its current tick.
+		void Save(const SumoSimulation& simulation);
+
+		// Put the simulation back to the state saved for 'tick'.  False if that tick
+		// was never saved or has since been overwritten.
+		bool Restore(SumoSimulation& simulation, uint32_t tick) const;
+
+		const WorldState* Find(uint32_t tick) const;
+		uint32_t Capacity() const                   { return static_cast<uint32_t>(m_states.size()); }
+
+	private:
+		std::vector<WorldState> m_states;
+		std::vector<uint8_t>    m_saved;
+	};
+}
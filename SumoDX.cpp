@@ -10,6 +10,7 @@
 #include <time.h>
 #include "../Utilities/DirectXSample.h"
 #include "../GameObjects/Cylinder.h"
+#include "../Simulation/TransformSystem.h"
 
 using namespace concurrency;
 using namespace DirectX;
@@ -19,9 +20,22 @@ using namespace Windows::UI::Core;
 
 //----------------------------------------------------------------------
 
+static XMFLOAT3 ToXMFLOAT3(Simulation::Float3 value)
+{
+    return XMFLOAT3(value.x, value.y, value.z);
+}
+
+static Simulation::Float3 ToFloat3(XMFLOAT3 value)
+{
+    return Simulation::MakeFloat3(value.x, value.y, value.z);
+}
+
+//----------------------------------------------------------------------
+
 SumoDX::SumoDX():
     
-    m_gameActive(false)
+    m_gameActive(false),
+    m_stepper(GameConstants::Physics::FrameLength, GameConstants::Physics::MaxStepsPerFrame)
 {
     m_topScore.bestRoundTime = 0;
 }
@@ -48,18 +62,25 @@ void SumoDX::Initialize(
     m_savedState->Initialize(ApplicationData::Current->LocalSettings->Values, "SumoGame");
 
     m_timer = ref new GameTimer();
-	srand(time(NULL));
+	m_matchRandom.Seed(static_cast<uint64_t>(time(NULL)));
+	m_matchCount = 0;
+
+	// The simulation owns the game play state of both sumos, including the enemy's behavior.
+	m_simulation.reset(new Simulation::SumoSimulation());
+	m_simulation->SmartPlanning(true);
+	StartMatch();
+
+	// Every object in the scene is an entity in the simulation's store; the game
+	// objects created below are views onto those entities.
+	Simulation::EntityStore* entities = &m_simulation->Entities();
 
     // Create a box primitive to represent the player.
-    // The box will be used to handle collisions and constrain the player in the world.
-	m_player = ref new SumoBlock();
-	m_player->Position(XMFLOAT3(-3.0f, 0.5f, 0.0f));
+	m_player = ref new SumoBlock(entities, m_simulation->PlayerEntity());
 	// It is added to the list of render objects so that it appears on screen.
 	m_renderObjects.push_back(m_player);
 
 	//Create the enemy
-	// The box will be used to handle collisions and constrain the player in the world.
-	m_enemy = ref new AISumoBlock(XMFLOAT3(3.0f, 0.5f, 0.0f), m_player, static_cast<GameConstants::Behavior>(rand() % 3));
+	m_enemy = ref new AISumoBlock(entities, m_simulation->EnemyEntity(), m_player);
 	// It is added to the list of render objects so that it appears on screen.
 	m_renderObjects.push_back(m_enemy);
 
@@ -68,9 +89,13 @@ void SumoDX::Initialize(
 
 	//floor model
 	Cylinder^ cylinder;
-	cylinder = ref new Cylinder(XMFLOAT3(0.0f, -1.0f, 0.0f), 10.0f, XMFLOAT3(0.0f, 1.0f, 0.0f));
+	Simulation::EntityHandle floor = entities->Create(Simulation::MakeFloat3(0.0f, -1.0f, 0.0f));
+	cylinder = ref new Cylinder(entities, floor, GameConstants::Arena::RingRadius, XMFLOAT3(0.0f, 1.0f, 0.0f));
 	m_renderObjects.push_back(cylinder);
 
+	Simulation::UpdateTransforms(*entities);
+	PublishScene();
+
     m_camera = ref new Camera;
     m_camera->SetProjParams(XM_PI / 2, 1.0f, 0.01f, 100.0f);
     m_camera->SetViewParams(
@@ -96,9 +121,9 @@ void SumoDX::Initialize(
 void SumoDX::LoadGame()
 {
 	//reset player and enemy
-	m_player->Position(XMFLOAT3(-3.0f, 0.5f, 0.0f));
-	m_enemy->Position(XMFLOAT3(3.0f, 0.5f, 0.0f));
-	m_enemy->Behavior(static_cast<GameConstants::Behavior>(rand() % 3));
+	StartMatch();
+	m_stepper.Reset();
+	UpdateRenderObjects();
 
 	//reset camera
 	m_camera->SetViewParams(
@@ -125,6 +150,7 @@ void SumoDX::StartLevel()
 {
     m_timer->Reset();
     m_timer->Start();
+    m_stepper.Reset();
 	m_gameActive = true;
     m_controller->Active(true);
 }
@@ -159,18 +185,20 @@ GameState SumoDX::RunGame()
 	m_controller->Yaw(m_camera->Yaw());
 
 	// run one frame of game play.
-	m_player->Velocity(m_controller->Velocity());
+	Simulation::TickInput input;
+	input.playerVelocity = ToFloat3(m_controller->Velocity());
 
-	UpdateDynamics();
+	UpdateDynamics(input);
 
 	//did either leave the mat?
-	if (abs(XMVectorGetY(XMVector3Length(m_player->VectorPosition()))) > 10.0f)
+	Simulation::RoundResult result = m_simulation->CheckRingOut();
+	if (result == Simulation::RoundResult::PlayerRingOut)
 	{
 		//player lost, place the ringout time into the score variable but don't save.
 		m_topScore.bestRoundTime = m_timer->PlayingTime();
 		return GameState::PlayerLost;
 	}
-	if (abs(XMVectorGetY(XMVector3Length(m_enemy->VectorPosition()))) > 10.0f)
+	if (result == Simulation::RoundResult::EnemyRingOut)
 	{
 		//player won, save his time if it is a new high score.
 		m_topScore.bestRoundTime = m_timer->PlayingTime();
@@ -197,42 +225,66 @@ void SumoDX::OnResuming()
 
 //----------------------------------------------------------------------
 
-void SumoDX::UpdateDynamics()
+void SumoDX::UpdateDynamics(const Simulation::TickInput& input)
 {
-    float timeTotal = m_timer->PlayingTime();
-    float timeFrame = m_timer->DeltaTime();
-    
-	// If the elapsed time is too long, we slice up the time and handle physics over several
-	// smaller time steps to avoid missing collisions.
-	float timeLeft = timeFrame;
-	float deltaTime;
-	while (timeLeft > 0.0f)
-	{
-		deltaTime = min(timeLeft, GameConstants::Physics::FrameLength);
-		timeLeft -= deltaTime;
-
-		// Update the player position.
-		m_player->Position(m_player->VectorPosition() + m_player->VectorVelocity() * deltaTime);
-
-		//AI Update
-		m_enemy->DetermineAIAction(deltaTime);
-
-		//Check for player/enemy colision
-		float xDelta = m_enemy->Position().x - m_player->Position().x;
-		float zDelta = m_enemy->Position().z - m_player->Position().z;
-
-		//since each of our sumo's is 1 unit wide if we subtract one from their position deltas
-		float overlap = sqrt(xDelta * xDelta + zDelta * zDelta) - 1;
-		XMVECTOR playerToEnemy = m_enemy->VectorPosition() - m_player->VectorPosition();
-
-		
-		// then if we get their overlap value as a negative number a contact has occured.
-		if (overlap < 0)
-		{
-			m_player->Position(m_player->VectorPosition() + playerToEnemy * overlap * 0.5f);
-			m_enemy->Position(m_enemy->VectorPosition() - playerToEnemy * overlap * 0.5f);
-		}
-	}
+    if (GameConstants::Physics::SweptSteps)
+    {
+        // Advance the whole frame in one step; the swept contact tests keep the sumos
+        // from passing through each other however long it is.  A long stall is
+        // capped the same way as the fixed ticks.
+        float frameTime = m_timer->DeltaTime();
+        float longestFrame = GameConstants::Physics::FrameLength * GameConstants::Physics::MaxStepsPerFrame;
+        m_simulation->SweptTick(input, (frameTime < longestFrame) ? frameTime : longestFrame);
+        UpdateRenderObjects();
+        return;
+    }
+
+    // Run the fixed length simulation ticks owed for this frame.  The stepper caps
+    // the number of ticks so a long stall doesn't turn into hundreds of ticks.
+    int steps = m_stepper.Accumulate(m_timer->DeltaTime());
+    for (int step = 0; step < steps; step++)
+    {
+        m_simulation->Tick(input);
+    }
+
+    UpdateRenderObjects();
+}
+
+//----------------------------------------------------------------------
+
+void SumoDX::UpdateRenderObjects()
+{
+    // Draw the sumos at their simulated positions, interpolated between the last
+    // two ticks by the part of a tick the stepper is still holding.  A swept step
+    // ends exactly at the frame time.
+    float alpha = GameConstants::Physics::SweptSteps ? 1.0f : m_stepper.Alpha();
+    m_player->RenderPosition(ToXMFLOAT3(m_simulation->PlayerRenderPosition(alpha)));
+    m_enemy->RenderPosition(ToXMFLOAT3(m_simulation->EnemyRenderPosition(alpha)));
+
+    // Rebuild the model matrices of everything that moved, once for the frame, so
+    // the sumos face each other.
+    Simulation::UpdateTransforms(m_simulation->Entities());
+    PublishScene();
+}
+
+//----------------------------------------------------------------------
+
+void SumoDX::StartMatch()
+{
+    // Each match draws its enemy behavior and simulation seed from its own counter,
+    // so no global generator state is shared with anything else in the process.
+    Simulation::RandomStream random(m_matchRandom, 0, m_matchCount++);
+    GameConstants::Behavior behavior = static_cast<GameConstants::Behavior>(random.NextInt(3));
+    uint64_t seed = (static_cast<uint64_t>(random.Next()) << 32) | random.Next();
+    m_simulation->Reset(behavior, seed);
+}
+
+//----------------------------------------------------------------------
+
+void SumoDX::PublishScene()
+{
+    // Hand the renderer an immutable copy of this frame's model matrices and render handles.
+    m_scene.Publish(m_simulation->Entities());
 }
 
 //----------------------------------------------------------------------
@@ -242,8 +294,8 @@ void SumoDX::SaveState()
     // Save basic state of the game.
     m_savedState->SaveBool(":GameActive", m_gameActive);
 	m_savedState->SaveSingle(":LevelPlayingTime", m_timer->PlayingTime());
-    m_savedState->SaveXMFLOAT3(":PlayerPosition", m_player->Position());
-    m_savedState->SaveXMFLOAT3(":EnemyPosition", m_enemy->Position());
+    m_savedState->SaveXMFLOAT3(":PlayerPosition", ToXMFLOAT3(m_simulation->PlayerPosition()));
+    m_savedState->SaveXMFLOAT3(":EnemyPosition", ToXMFLOAT3(m_simulation->EnemyPosition()));
 
  }
 
@@ -257,8 +309,9 @@ void SumoDX::LoadState()
     {
         // Loading from the last known state means the game wasn't finished when it was last played,
         // Reload the current player and enemy position.
-		m_player->Position(m_savedState->LoadXMFLOAT3(":PlayerPosition", XMFLOAT3(0.0f, 0.0f, 0.0f)));
-	    m_enemy->Position(m_savedState->LoadXMFLOAT3(":EnemyPosition", XMFLOAT3(0.0f, 0.0f, 0.0f)));
+		m_simulation->PlayerPosition(ToFloat3(m_savedState->LoadXMFLOAT3(":PlayerPosition", XMFLOAT3(0.0f, 0.0f, 0.0f))));
+	    m_simulation->EnemyPosition(ToFloat3(m_savedState->LoadXMFLOAT3(":EnemyPosition", XMFLOAT3(0.0f, 0.0f, 0.0f))));
+		UpdateRenderObjects();
 		m_timer->PlayingTime(m_savedState->LoadSingle(":LevelPlayingTime", 0.0f));
     }
 }
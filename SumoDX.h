@@ -13,7 +13,9 @@
 //     MoveLookController - for handling all input to control player/camera/cursor movement.
 //     GameRenderer - for handling all graphics presentation.
 //     Camera - for handling view projections.
+//     SumoSimulation - for advancing the portable game play rules (movement, AI, collisions, ring outs).
 //     m_renderObjects <GameObject> - is the list of all objects in the scene that may be rendered.
+//     m_scene - the snapshot of model matrices and render handles the renderer draws each frame.
 
 #include "../GameObjects/GameConstants.h"
 #include "../GameObjects/Camera.h"
@@ -24,6 +26,11 @@
 #include "../Rendering/GameRenderer.h"
 #include "../GameObjects/AISumoBlock.h"
 #include "../GameObjects/SumoBlock.h"
+#include "../Simulation/SumoSimulation.h"
+#include "../Simulation/CounterRandom.h"
+#include "../Simulation/FixedStepper.h"
+#include "../Simulation/SceneSnapshot.h"
+#include "../Simulation/Span.h"
 
 //--------------------------------------------------------------------------------------
 
@@ -77,7 +84,15 @@ internal:
     HighScoreEntry HighScore()                  { return m_topScore; }
   
     Camera^ GameCamera()                        { return m_camera; }
-	std::vector<GameObject^> RenderObjects()    { return m_renderObjects; }
+    Simulation::Span<GameObject^ const> RenderObjects()
+    {
+        return Simulation::Span<GameObject^ const>(m_renderObjects.data(), m_renderObjects.size());
+    }
+
+    // The most recently published frame of the scene.  It is read in place and stays
+    // unchanged until the frame after next is published.
+    const Simulation::SceneSnapshot& Scene()    { return m_scene.Latest(); }
+    void PublishScene();
 
 
 private:
@@ -86,7 +101,9 @@ private:
     void SaveHighScore();
     void LoadHighScore();
  
-    void UpdateDynamics();
+    void UpdateDynamics(const Simulation::TickInput& input);
+    void UpdateRenderObjects();
+    void StartMatch();
 
     MoveLookController^                         m_controller;
     GameRenderer^                               m_renderer;
@@ -98,8 +115,14 @@ private:
     GameTimer^                                  m_timer;
     bool                                        m_gameActive;
 
+    std::unique_ptr<Simulation::SumoSimulation> m_simulation;           // Game play state; the objects below only present it.
+    Simulation::CounterRandom                   m_matchRandom;          // Picks each match's enemy behavior and seed.
+    uint32_t                                    m_matchCount;           // Matches started since the game was launched.
+    Simulation::FixedStepper                    m_stepper;              // Number of simulation ticks to run for each rendered frame.
+
     SumoBlock^                                  m_player;
 	AISumoBlock^								m_enemy;
     std::vector<GameObject^>                    m_renderObjects;     // List of all objects to be rendered.
+    Simulation::SceneSnapshotBuffer             m_scene;
 };
 
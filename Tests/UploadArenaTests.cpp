@@ -0,0 +1,199 @@
+// UploadArenaTests:
+// Checks the UploadArena's bookkeeping without a GPU: allocation alignment,
+// retiring frames as their fences complete, the framesInFlight cap, wrapping
+// around the end of the ring, frames that allocate nothing and the NoSpace
+// result the D3D11Backend falls back to UpdateSubresource on.  Run by ctest; exits with 1 if any check fails.
+//
+// Usage:
+//     UploadArenaTests
+
+#include "Rendering/UploadArena.h"
+
+#include <cstdio>
+
+using namespace Rendering;
+
+namespace
+{
+	int s_failures = 0;
+
+	void Check(bool passed, const char* test, const char* what)
+	{
+		if (!passed)
+		{
+			printf("FAILED %s: %s\n", test, what);
+			s_failures++;
+		}
+	}
+
+	UploadArena MakeArena(uint32_t capacity, uint32_t framesInFlight)
+	{
+		UploadArenaSettings settings = DefaultUploadArenaSettings();
+		settings.capacity = capacity;
+		settings.framesInFlight = framesInFlight;
+		return UploadArena(settings);
+	}
+
+	void Alignment()
+	{
+		const char* test = "Alignment";
+		UploadArena arena = MakeArena(4096, 3);
+		arena.BeginFrame(1);
+		Check(arena.Allocate(1) == 0, test, "the first allocation starts the ring");
+		Check(arena.Allocate(100) == 256, test, "a small allocation is rounded up to 256 bytes");
+		Check(arena.Allocate(257) == 512, test, "allocations follow each other");
+		Check(arena.Allocate(256) == 1024, test, "257 bytes take two 256 byte blocks");
+		Check(arena.Used() == 1280, test, "the rounded sizes are held");
+		arena.EndFrame();
+		Check(arena.FramesInFlight() == 1, test, "the ended frame is in flight");
+	}
+
+	void FramesInFlightCap()
+	{
+		const char* test = "FramesInFlightCap";
+		UploadArena arena = MakeArena(4096, 3);
+		for (uint64_t frame = 1; frame <= 3; frame++)
+		{
+			Check(!arena.MustWait(), test, "a frame may begin while under the cap");
+			arena.BeginFrame(frame);
+			arena.Allocate(256);
+			arena.EndFrame();
+		}
+		Check(arena.FramesInFlight() == 3, test, "every ended frame is in flight");
+		Check(arena.MustWait(), test, "the caller must wait at the cap");
+		Check(arena.OldestFrame() == 1, test, "the first frame is the oldest");
+
+		arena.Retire(arena.OldestFrame());
+		Check(!arena.MustWait(), test, "retiring the oldest frame frees a slot");
+		Check(arena.OldestFrame() == 2, test, "the next frame becomes the oldest");
+
+		// Keep going long enough for the marks to wrap around their ring several times.
+		for (uint64_t frame = 4; frame <= 20; frame++)
+		{
+			while (arena.MustWait())
+			{
+				arena.Retire(arena.OldestFrame());
+			}
+			arena.BeginFrame(frame);
+			arena.Allocate(256);
+			arena.EndFrame();
+		}
+		Check(arena.FramesInFlight() == 3, test, "the cap holds across many frames");
+		Check(arena.OldestFrame() == 18, test, "frames are retired oldest first");
+		Check(arena.Used() == 3 * 256, test, "only the frames in flight hold memory");
+	}
+
+	void RetireOnFence()
+	{
+		const char* test = "RetireOnFence";
+		UploadArena arena = MakeArena(1024, 3);
+		for (uint64_t frame = 1; frame <= 3; frame++)
+		{
+			arena.BeginFrame(frame);
+			arena.Allocate(256);
+			arena.EndFrame();
+		}
+
+		arena.Retire(0);
+		Check(arena.FramesInFlight() == 3, test, "an earlier fence retires nothing");
+		arena.Retire(2);
+		Check(arena.FramesInFlight() == 1, test, "a fence retires every frame up to it");
+		Check(arena.OldestFrame() == 3, test, "the later frame stays in flight");
+		Check(arena.Used() == 256, test, "the retired frames' memory is freed");
+		arena.Retire(3);
+		Check(arena.FramesInFlight() == 0 && arena.Used() == 0, test, "retiring the last frame frees everything");
+	}
+
+	void WrapAround()
+	{
+		const char* test = "WrapAround";
+		UploadArena arena = MakeArena(1024, 3);
+		arena.BeginFrame(1);
+		Check(arena.Allocate(512) == 0, test, "the first frame starts the ring");
+		arena.EndFrame();
+		arena.BeginFrame(2);
+		Check(arena.Allocate(256) == 512, test, "the second frame follows the first");
+		arena.EndFrame();
+		arena.Retire(1);
+
+		// 512 bytes don't fit in the 256 left before the end, so the frame pads out the
+		// end of the ring and starts again at the beginning, where frame 1 was.
+		arena.BeginFrame(3);
+		Check(arena.Allocate(512) == 0, test, "an allocation past the end wraps to the beginning");
+		Check(arena.Used() == 1024, test, "the end of the ring is held as padding");
+		Check(arena.Allocate(256) == UploadArena::NoSpace, test, "a wrapped allocation can't run into frame 2");
+		arena.EndFrame();
+
+		arena.Retire(2);
+		arena.BeginFrame(4);
+		Check(arena.Allocate(256) == 512, test, "retiring frame 2 frees the space after the wrapped frame");
+		arena.EndFrame();
+		arena.Retire(3);
+		Check(arena.Used() == 256, test, "retiring the wrapped frame frees its padding");
+	}
+
+	void EmptyFrame()
+	{
+		const char* test = "EmptyFrame";
+		UploadArena arena = MakeArena(4096, 3);
+		arena.BeginFrame(0);
+		arena.Allocate(256);
+		arena.EndFrame();
+		arena.Retire(0);
+
+		// Frame 1 allocates nothing, so its mark ends where frame 0 did, and frame 2
+		// then finds the ring empty and starts again at the beginning.
+		arena.BeginFrame(1);
+		arena.EndFrame();
+		arena.BeginFrame(2);
+		Check(arena.Allocate(3072) == 0, test, "an empty ring starts again at the beginning");
+		arena.EndFrame();
+
+		arena.Retire(1);
+		Check(arena.Used() == 3072, test, "retiring an empty frame frees nothing");
+		arena.BeginFrame(3);
+		Check(arena.Allocate(3072) == UploadArena::NoSpace, test, "retiring an empty frame doesn't free frame 2's memory");
+		Check(arena.Allocate(1024) == 3072, test, "the space after frame 2 is still free");
+		Check(arena.Allocate(256) == UploadArena::NoSpace, test, "an allocation can't wrap into frame 2");
+		Check(arena.Used() == 4096, test, "no more than the ring is held");
+		arena.EndFrame();
+	}
+
+	void OutOfSpace()
+	{
+		const char* test = "OutOfSpace";
+		UploadArena arena = MakeArena(1024, 3);
+		arena.BeginFrame(1);
+		Check(arena.Allocate(2048) == UploadArena::NoSpace, test, "an allocation larger than the ring never fits");
+		Check(arena.Used() == 0, test, "a failed allocation holds nothing");
+		Check(arena.Allocate(1024) == 0, test, "the whole ring can be given to one allocation");
+		Check(arena.Allocate(1) == UploadArena::NoSpace, test, "a full ring has no space");
+		arena.EndFrame();
+
+		// The backend waits for the oldest frame and retries; when nothing is left in
+		// flight it writes the constants with UpdateSubresource instead.
+		arena.BeginFrame(2);
+		Check(arena.Allocate(256) == UploadArena::NoSpace, test, "the frame in flight still holds the ring");
+		arena.Retire(arena.OldestFrame());
+		Check(arena.Allocate(256) == 0, test, "retiring the oldest frame makes room");
+		arena.EndFrame();
+	}
+}
+
+int main()
+{
+	Alignment();
+	FramesInFlightCap();
+	RetireOnFence();
+	WrapAround();
+	EmptyFrame();
+	OutOfSpace();
+
+	if (s_failures > 0)
+	{
+		printf("%d checks failed\n", s_failures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}
@@ -0,0 +1,2176 @@
+// SumoBench:
+// Microbenchmarks for the simulation systems that have to scale past the two
+// sumos of a normal match.
+//
+// Usage:
+//     SumoBench broadphase [ticks]    Time the broadphase, narrowphase and full arena
+//                                     tick from 2 to 100,000 sumos, and compare the
+//                                     grid against a brute force pair search.
+//     SumoBench narrowphase [repeat]  Time resolving the contacts of a 100,000 sumo
+//                                     arena one pair at a time, with the scalar
+//                                     contact kernel and with the SIMD kernel.
+//     SumoBench transforms [frames]   Time rebuilding the model matrices of a 100,000 sumo
+//                                     arena eagerly, with trig, on every position change
+//                                     against once per frame in the batched transform pass.
+//     SumoBench solver [repeat [threads]]
+//                                     Time coloring and resolving the contacts of a
+//                                     50,000 sumo arena on 1 thread up to one per core
+//                                     (or 'threads'), and check every thread count gives
+//                                     the same result.
+//     SumoBench random [repeat]       Check the counter-based generator against the
+//                                     Philox4x32-10 known answers, and time drawing
+//                                     one value at a time against the bulk draws.
+//     SumoBench planner [decisions]   Time the Smart AI's planner: rollouts per second,
+//                                     and the rollouts and time taken per decision at
+//                                     several time budgets.
+//     SumoBench ai [ticks]            Time the AI of a 20,000 sumo arena per tick, checking
+//                                     every sumo every tick against the AIScheduler with
+//                                     and without a decision budget.
+//     SumoBench audio [seconds [output.wav]]
+//                                     Load the game's sounds into the Mixer, time mixing
+//                                     1 to 512 voices, then play the contacts of a 2,000
+//                                     sumo battle for 'seconds' and optionally write the
+//                                     mix to a WAVE file.
+//     SumoBench commands [frames]     Record arenas of 2 to 100,000 sumos in two teams into a
+//                                     render CommandList in entity order, skipping redundant
+//                                     state, sorted, and instanced as GameRenderer does, and
+//                                     time submitting each to the null and recording backends,
+//                                     with the draws, state changes and constant uploads.
+//     SumoBench instances [frames]    Time building the instance stream of arenas of 1,000 to
+//                                     1,000,000 sumos from their transforms, checking every
+//                                     sumo lands in its batch with its transform and tint.
+//     SumoBench upload [frames]       Allocate every object's constants of frames of 100 to
+//                                     100,000 objects from an UploadArena, with room for
+//                                     every frame in flight and with too little, checking no
+//                                     allocation overlaps memory a frame in flight still holds,
+//                                     and time allocating alone and writing the constants.
+//     SumoBench cull [repeat [threads]]
+//                                     Frustum cull the bounding spheres of 1,000,000 sumos
+//                                     spread over a field around the game's camera with the
+//                                     scalar test and the SIMD kernel on 1 thread up to one
+//                                     per core (or 'threads'), checking each gives the same
+//                                     visible list.
+//     SumoBench contacts [ticks]      Time a 50,000 sumo battle with and without contact
+//                                     events, checking reporting doesn't change it, and
+//                                     time a consumer thread draining the events through
+//                                     the lock-free ContactEventQueue.
+//     SumoBench dynamics [ticks]      Time a 50,000 sumo battle with positional contacts
+//                                     and with the RigidBodies impulse solver on 1 thread
+//                                     and on every core, then shove a 100,000 sumo crowd
+//                                     and time its ticks as it comes to rest and sleeps,
+//                                     and drive 1,000 sumos into a pile to count the
+//                                     jammed ones that sleep.
+//     SumoBench netplay [frames]      Play a two player rollback match between two sessions
+//                                     over a loopback link and simulated links with latency,
+//                                     jitter and loss, and check both peers end up with the
+//                                     same state as the match played locally.
+//     SumoBench raster [frames [output.tga]]
+//                                     Render the game's match and a 2,000 sumo crowd with
+//                                     the software rasterizer at several resolutions on 1
+//                                     thread and on every core, checking each gives the same
+//                                     image, and optionally write a frame to a TGA file.
+//     SumoBench snapshot [rollbacks]  Time saving, restoring and delta compressing a match's
+//                                     world state, and rolling back 8 frames and playing
+//                                     them again, checking the replayed state matches.
+//     SumoBench swept [pairs]         Fire pairs of fast sumos at each other and count the
+//                                     ones that pass through each other in one long step,
+//                                     in fixed ticks and in one swept step, then time a
+//                                     match frame run as fixed ticks and as a swept step.
+
+#include "Simulation/SumoArena.h"
+#include "Simulation/ContactKernel.h"
+#include "Simulation/TransformSystem.h"
+#include "Simulation/CounterRandom.h"
+#include "Simulation/SmartPlanner.h"
+#include "Simulation/SweptCollision.h"
+#include "Simulation/RigidBodies.h"
+#include "Simulation/WorldSnapshot.h"
+#include "Simulation/RollbackSession.h"
+#include "Simulation/ContactEvents.h"
+#include "Audio/Mixer.h"
+#include "Rendering/SoftwareRasterizer.h"
+#include "Rendering/FrustumCulling.h"
+#include "Rendering/InstanceBuilder.h"
+#include "Rendering/RenderBackend.h"
+#include "Rendering/SceneCommands.h"
+#include "Rendering/UploadArena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace Simulation;
+using namespace Audio;
+
+namespace
+{
+	double SecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	bool Overlapping(const EntityStore& entities, uint32_t a, uint32_t b)
+	{
+		float xDelta = entities.PositionX()[b] - entities.PositionX()[a];
+		float zDelta = entities.PositionZ()[b] - entities.PositionZ()[a];
+		return std::sqrt(xDelta * xDelta + zDelta * zDelta) < GameConstants::Arena::SumoSize;
+	}
+
+	// Every pair tested against every other, as the two-sumo game does.
+	uint32_t BruteForceContacts(const EntityStore& entities)
+	{
+		uint32_t contacts = 0;
+		uint32_t count = entities.Count();
+		for (uint32_t a = 0; a < count; a++)
+		{
+			for (uint32_t b = a + 1; b < count; b++)
+			{
+				contacts += Overlapping(entities, a, b) ? 1 : 0;
+			}
+		}
+		return contacts;
+	}
+
+	uint32_t GridContacts(const SumoArena& arena)
+	{
+		uint32_t contacts = 0;
+		for (const ContactPair& pair : arena.CandidatePairs())
+		{
+			contacts += Overlapping(arena.Entities(), pair.a, pair.b) ? 1 : 0;
+		}
+		return contacts;
+	}
+
+	int Broadphase(int ticks)
+	{
+		const uint32_t Counts[] = { 2, 10, 100, 1000, 10000, 100000 };
+		const uint32_t BruteForceLimit = 10000;
+
+		printf("%8s %8s %10s %12s %12s %12s %12s %8s\n",
+			"sumos", "radius", "pairs/tick", "grid us", "resolve us", "tick us", "brute us", "check");
+
+		bool allMatched = true;
+		for (uint32_t count : Counts)
+		{
+			SumoArena arena;
+			arena.Reset(count, GameConstants::Angry, count);
+
+			// Let the crowd settle so the contacts are typical of a battle in progress.
+			for (int tick = 0; tick < 10; tick++)
+			{
+				arena.Tick();
+			}
+
+			double gridSeconds = 0.0;
+			double resolveSeconds = 0.0;
+			double tickSeconds = 0.0;
+			uint64_t pairs = 0;
+			for (int tick = 0; tick < ticks; tick++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				arena.UpdateAI(GameConstants::Physics::FrameLength);
+				auto broadphaseStart = std::chrono::steady_clock::now();
+				arena.FindContacts();
+				auto resolveStart = std::chrono::steady_clock::now();
+				arena.ColorContacts();
+				arena.ResolveContacts();
+				auto resolveEnd = std::chrono::steady_clock::now();
+				arena.RemoveRingOuts();
+				tickSeconds += SecondsSince(start);
+
+				gridSeconds += std::chrono::duration<double>(resolveStart - broadphaseStart).count();
+				resolveSeconds += std::chrono::duration<double>(resolveEnd - resolveStart).count();
+				pairs += arena.CandidatePairs().size();
+			}
+
+			// The grid must find every overlapping pair the brute force search finds.
+			const char* check = "-";
+			double bruteSeconds = 0.0;
+			if (arena.Remaining() <= BruteForceLimit)
+			{
+				arena.FindContacts();
+				auto start = std::chrono::steady_clock::now();
+				uint32_t expected = BruteForceContacts(arena.Entities());
+				bruteSeconds = SecondsSince(start);
+				bool matched = (GridContacts(arena) == expected);
+				allMatched = allMatched && matched;
+				check = matched ? "match" : "MISMATCH";
+			}
+
+			const double Micro = 1e6 / ticks;
+			printf("%8u %8.1f %10llu %12.1f %12.1f %12.1f ",
+				count, arena.RingRadius(), static_cast<unsigned long long>(pairs / ticks),
+				gridSeconds * Micro, resolveSeconds * Micro, tickSeconds * Micro);
+			if (bruteSeconds > 0.0)
+			{
+				printf("%12.1f %8s\n", bruteSeconds * 1e6, check);
+			}
+			else
+			{
+				printf("%12s %8s\n", "-", check);
+			}
+		}
+		return allMatched ? 0 : 2;
+	}
+
+	int Narrowphase(int repeat)
+	{
+		const uint32_t Count = 100000;
+
+		SumoArena arena;
+		arena.Reset(Count, GameConstants::Angry, 1);
+		for (int tick = 0; tick < 10; tick++)
+		{
+			arena.Tick();
+		}
+		arena.UpdateAI(GameConstants::Physics::FrameLength);
+		arena.FindContacts();
+
+		const EntityStore& start = arena.Entities();
+		const std::vector<ContactPair>& pairs = arena.CandidatePairs();
+		uint32_t count = start.Count();
+		uint32_t pairCount = static_cast<uint32_t>(pairs.size());
+
+		// The scalar path the two-sumo game uses: one pair at a time through Float3s.
+		std::vector<float> sequentialX, sequentialY, sequentialZ;
+		double sequentialSeconds = 0.0;
+		for (int i = 0; i < repeat; i++)
+		{
+			sequentialX.assign(start.PositionX(), start.PositionX() + count);
+			sequentialY.assign(start.PositionY(), start.PositionY() + count);
+			sequentialZ.assign(start.PositionZ(), start.PositionZ() + count);
+
+			auto sequentialStart = std::chrono::steady_clock::now();
+			for (const ContactPair& pair : pairs)
+			{
+				Float3 positionA = MakeFloat3(sequentialX[pair.a], sequentialY[pair.a], sequentialZ[pair.a]);
+				Float3 positionB = MakeFloat3(sequentialX[pair.b], sequentialY[pair.b], sequentialZ[pair.b]);
+				ResolveContact(positionA, positionB);
+				sequentialX[pair.a] = positionA.x;
+				sequentialY[pair.a] = positionA.y;
+				sequentialZ[pair.a] = positionA.z;
+				sequentialX[pair.b] = positionB.x;
+				sequentialY[pair.b] = positionB.y;
+				sequentialZ[pair.b] = positionB.z;
+			}
+			sequentialSeconds += SecondsSince(sequentialStart);
+		}
+
+		typedef void (*Kernel)(const ContactPair*, uint32_t, const float*, const float*, float*, float*);
+		auto runKernel = [&](Kernel kernel, std::vector<float>& x, std::vector<float>& z)
+		{
+			std::vector<float> correctionX(count);
+			std::vector<float> correctionZ(count);
+			double seconds = 0.0;
+			for (int i = 0; i < repeat; i++)
+			{
+				x.assign(start.PositionX(), start.PositionX() + count);
+				z.assign(start.PositionZ(), start.PositionZ() + count);
+				std::fill(correctionX.begin(), correctionX.end(), 0.0f);
+				std::fill(correctionZ.begin(), correctionZ.end(), 0.0f);
+
+				auto kernelStart = std::chrono::steady_clock::now();
+				kernel(pairs.data(), pairCount, x.data(), z.data(), correctionX.data(), correctionZ.data());
+				ApplyContactCorrections(count, x.data(), z.data(), correctionX.data(), correctionZ.data());
+				seconds += SecondsSince(kernelStart);
+			}
+			return seconds;
+		};
+
+		std::vector<float> scalarX, scalarZ, simdX, simdZ;
+		double scalarSeconds = runKernel(AccumulateContactCorrectionsScalar, scalarX, scalarZ);
+		double simdSeconds = runKernel(AccumulateContactCorrections, simdX, simdZ);
+		bool matched = (scalarX == simdX) && (scalarZ == simdZ);
+
+		const double NanoPerPair = 1e9 / (static_cast<double>(pairCount) * repeat);
+		printf("sumos:            %u\n", count);
+		printf("candidate pairs:  %u\n", pairCount);
+		printf("sequential:       %.2f ns/pair\n", sequentialSeconds * NanoPerPair);
+		printf("scalar kernel:    %.2f ns/pair\n", scalarSeconds * NanoPerPair);
+		printf("%-6s kernel:    %.2f ns/pair (%.2fx sequential)\n",
+			ContactKernelInstructionSet(), simdSeconds * NanoPerPair, sequentialSeconds / simdSeconds);
+		printf("kernels agree:    %s\n", matched ? "yes" : "NO");
+		return matched ? 0 : 2;
+	}
+
+	Float4x4 Multiply(const Float4x4& a, const Float4x4& b)
+	{
+		Float4x4 result;
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				result.m[row][column] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column] +
+					a.m[row][2] * b.m[2][column] + a.m[row][3] * b.m[3][column];
+			}
+		}
+		return result;
+	}
+
+	// The matrix SumoBlock used to build whenever its position was set: the angle to
+	// the target from acos, then scale * rotation * translation.
+	Float4x4 EagerSumoTransform(Float3 position, Float3 target)
+	{
+		Float3 direction = Normalize(target - position);
+		float angle = std::acos(std::max(-1.0f, std::min(1.0f, direction.x)));
+		if (direction.z > 0)
+		{
+			angle = -angle;
+		}
+
+		Float4x4 rotation = Float4x4Identity();
+		rotation.m[0][0] = std::cos(angle);
+		rotation.m[0][2] = -std::sin(angle);
+		rotation.m[2][0] = std::sin(angle);
+		rotation.m[2][2] = std::cos(angle);
+
+		Float4x4 translation = Float4x4Identity();
+		translation.m[3][0] = position.x;
+		translation.m[3][1] = position.y;
+		translation.m[3][2] = position.z;
+
+		return Multiply(Multiply(Float4x4Identity(), rotation), translation);
+	}
+
+	int Transforms(int frames)
+	{
+		const uint32_t Count = 100000;
+
+		// At the 3 ms tick, a 60 Hz frame runs five or six ticks, and each tick set a
+		// sumo's position at least twice (its move, then the contact correction).
+		const int SetsPerFrame = 10;
+
+		SumoArena arena;
+		arena.Reset(Count, GameConstants::Angry, 1);
+		arena.Tick();
+
+		EntityStore& entities = arena.Entities();
+		uint32_t count = entities.Count();
+
+		std::vector<Float4x4> eager(count);
+		auto eagerStart = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			for (int set = 0; set < SetsPerFrame; set++)
+			{
+				for (uint32_t i = 0; i < count; i++)
+				{
+					Float3 target = entities.Position(entities.Index(entities.FacingTargets()[i]));
+					eager[i] = EagerSumoTransform(entities.Position(i), target);
+				}
+			}
+		}
+		double eagerSeconds = SecondsSince(eagerStart);
+
+		auto lazyStart = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			arena.UpdateTransforms();
+		}
+		double lazySeconds = SecondsSince(lazyStart);
+
+		// Nothing has moved since the last pass, so there is nothing to rebuild.
+		uint32_t idleRebuilds = UpdateTransforms(entities);
+
+		// The batched pass has to build the same matrices without the trig.
+		float largestError = 0.0f;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				for (int column = 0; column < 4; column++)
+				{
+					largestError = std::max(largestError, std::fabs(entities.Transforms()[i].m[row][column] - eager[i].m[row][column]));
+				}
+			}
+		}
+		bool matched = largestError < 1e-3f && idleRebuilds == 0;
+
+		printf("sumos:            %u\n", count);
+		printf("eager:            %.2f ms/frame (%d rebuilds per sumo)\n", eagerSeconds * 1e3 / frames, SetsPerFrame);
+		printf("batched:          %.2f ms/frame (%.1fx)\n", lazySeconds * 1e3 / frames, eagerSeconds / lazySeconds);
+		printf("idle rebuilds:    %u\n", idleRebuilds);
+		printf("largest error:    %g (%s)\n", largestError, matched ? "match" : "MISMATCH");
+		return matched ? 0 : 2;
+	}
+
+	int Solver(int repeat, uint32_t maxThreads)
+	{
+		const uint32_t Count = 50000;
+
+		SumoArena arena;
+		arena.Reset(Count, GameConstants::Angry, 1);
+		for (int tick = 0; tick < 10; tick++)
+		{
+			arena.Tick();
+		}
+		arena.UpdateAI(GameConstants::Physics::FrameLength);
+		arena.FindContacts();
+
+		EntityStore& entities = arena.Entities();
+		uint32_t count = entities.Count();
+		std::vector<float> startX(entities.PositionX(), entities.PositionX() + count);
+		std::vector<float> startZ(entities.PositionZ(), entities.PositionZ() + count);
+
+		std::vector<uint32_t> threadCounts;
+		for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+		{
+			threadCounts.push_back(threads);
+		}
+		threadCounts.push_back(maxThreads);
+
+		printf("sumos:            %u\n", count);
+		printf("contacts:         %zu\n", arena.CandidatePairs().size());
+		printf("%8s %12s %12s %10s %8s\n", "threads", "color us", "solve us", "speedup", "check");
+
+		double baseSeconds = 0.0;
+		std::vector<float> baseX, baseZ;
+		bool allMatched = true;
+		for (uint32_t threads : threadCounts)
+		{
+			JobSystem jobs(threads);
+			arena.Jobs(&jobs);
+
+			double colorSeconds = 0.0;
+			double solveSeconds = 0.0;
+			for (int i = 0; i < repeat; i++)
+			{
+				std::copy(startX.begin(), startX.end(), entities.PositionX());
+				std::copy(startZ.begin(), startZ.end(), entities.PositionZ());
+
+				auto colorStart = std::chrono::steady_clock::now();
+				arena.ColorContacts();
+				auto solveStart = std::chrono::steady_clock::now();
+				arena.ResolveContacts();
+				colorSeconds += std::chrono::duration<double>(solveStart - colorStart).count();
+				solveSeconds += SecondsSince(solveStart);
+			}
+			arena.Jobs(nullptr);
+
+			std::vector<float> x(entities.PositionX(), entities.PositionX() + count);
+			std::vector<float> z(entities.PositionZ(), entities.PositionZ() + count);
+			if (threads == 1)
+			{
+				baseSeconds = solveSeconds;
+				baseX = x;
+				baseZ = z;
+			}
+			bool matched = (memcmp(x.data(), baseX.data(), count * sizeof(float)) == 0) &&
+				(memcmp(z.data(), baseZ.data(), count * sizeof(float)) == 0);
+			allMatched = allMatched && matched;
+
+			printf("%8u %12.1f %12.1f %9.2fx %8s\n", threads,
+				colorSeconds * 1e6 / repeat, solveSeconds * 1e6 / repeat, baseSeconds / solveSeconds,
+				matched ? "match" : "MISMATCH");
+		}
+		printf("batches:          %u\n", arena.ContactBatches().BatchCount());
+		return allMatched ? 0 : 2;
+	}
+
+	int RandomDraws(int repeat)
+	{
+		// Known answers from the Philox4x32-10 reference implementation, for an
+		// all-zero and an all-ones counter and key.
+		RandomBlock zero = CounterRandom(0).Block(0, 0, 0);
+		RandomBlock ones = CounterRandom(~0ULL).Block(0xFFFFFFFF, ~0ULL, 0xFFFFFFFF);
+		const uint32_t zeroAnswer[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+		const uint32_t onesAnswer[4] = { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+		bool known = memcmp(zero.value, zeroAnswer, sizeof(zeroAnswer)) == 0 &&
+			memcmp(ones.value, onesAnswer, sizeof(onesAnswer)) == 0;
+
+		// A long run from one stream, as a big battle's spawn positions are drawn.
+		const uint32_t Values = 1 << 20;
+		CounterRandom generator(12345);
+		std::vector<uint32_t> single(Values), bulk(Values);
+
+		auto singleStart = std::chrono::steady_clock::now();
+		for (int i = 0; i < repeat; i++)
+		{
+			RandomStream stream(generator, 7, i);
+			for (uint32_t value = 0; value < Values; value++)
+			{
+				single[value] = stream.Next();
+			}
+		}
+		double singleSeconds = SecondsSince(singleStart);
+
+		auto bulkStart = std::chrono::steady_clock::now();
+		for (int i = 0; i < repeat; i++)
+		{
+			generator.Fill(7, i, bulk.data(), Values);
+		}
+		double bulkSeconds = SecondsSince(bulkStart);
+		bool streamMatched = single == bulk;
+
+		// One block per entity for a tick, as every sumo in a battle draws its choices.
+		const uint32_t Entities = 100000;
+		std::vector<RandomBlock> perEntity(Entities), allEntities(Entities);
+
+		auto entityStart = std::chrono::steady_clock::now();
+		for (int i = 0; i < repeat; i++)
+		{
+			for (uint32_t entity = 0; entity < Entities; entity++)
+			{
+				perEntity[entity] = generator.Block(entity, i, 0);
+			}
+		}
+		double entitySeconds = SecondsSince(entityStart);
+
+		auto streamsStart = std::chrono::steady_clock::now();
+		for (int i = 0; i < repeat; i++)
+		{
+			generator.FillStreams(0, Entities, i, allEntities.data());
+		}
+		double streamsSeconds = SecondsSince(streamsStart);
+		bool entitiesMatched = memcmp(perEntity.data(), allEntities.data(), Entities * sizeof(RandomBlock)) == 0;
+
+		double draws = static_cast<double>(Values) * repeat;
+		double blocks = static_cast<double>(Entities) * repeat;
+		printf("known answers:    %s\n", known ? "match" : "MISMATCH");
+		printf("one at a time:    %.0f M values/s\n", draws / singleSeconds * 1e-6);
+		printf("bulk:             %.0f M values/s (%.1fx, %s)\n", draws / bulkSeconds * 1e-6, singleSeconds / bulkSeconds,
+			streamMatched ? "match" : "MISMATCH");
+		printf("per entity:       %.0f M blocks/s\n", blocks / entitySeconds * 1e-6);
+		printf("bulk entities:    %.0f M blocks/s (%.1fx, %s)\n", blocks / streamsSeconds * 1e-6, entitySeconds / streamsSeconds,
+			entitiesMatched ? "match" : "MISMATCH");
+		return (known && streamMatched && entitiesMatched) ? 0 : 2;
+	}
+
+	int Planner(int decisions)
+	{
+		// Decisions from the positions of real matches: play Smart enemies against a
+		// player walking at them, and plan from wherever they are every half second.
+		std::vector<DuelState> states;
+		SumoSimulation simulation;
+		for (uint64_t seed = 1; states.size() < static_cast<size_t>(decisions); seed++)
+		{
+			simulation.Reset(GameConstants::Smart, seed);
+			while (simulation.CheckRingOut() == RoundResult::InProgress && states.size() < static_cast<size_t>(decisions))
+			{
+				Float3 toEnemy = simulation.EnemyPosition() - simulation.PlayerPosition();
+				toEnemy.y = 0.0f;
+				TickInput input;
+				input.playerVelocity = Normalize(toEnemy) * 2.0f;
+				simulation.Tick(input);
+				if (simulation.TickCount() % 167 == 0)
+				{
+					DuelState state = { simulation.EnemyPosition(), simulation.PlayerPosition(), 2.0f, GameConstants::Smart,
+						GameConstants::Arena::RingRadius };
+					states.push_back(state);
+				}
+			}
+		}
+
+		SmartPlanner planner;
+		AITimings timings = DefaultAITimings();
+		PlannerSettings settings = DefaultPlannerSettings();
+
+		// Rollout speed, with a fixed number of iterations per decision.
+		settings.budgetMicroseconds = 0;
+		settings.iterationLimit = 2000;
+		auto start = std::chrono::steady_clock::now();
+		uint64_t rollouts = 0;
+		for (size_t i = 0; i < states.size(); i++)
+		{
+			rollouts += planner.Plan(states[i], timings, 1, i, settings).iterations;
+		}
+		double seconds = SecondsSince(start);
+
+		// A search stopped by the iteration limit alone must be repeatable.
+		bool repeatable = true;
+		for (size_t i = 0; i < states.size(); i++)
+		{
+			PlannerDecision first = planner.Plan(states[i], timings, 1, i, settings);
+			PlannerDecision second = planner.Plan(states[i], timings, 1, i, settings);
+			repeatable = repeatable && first.choice == second.choice && first.delay == second.delay && first.value == second.value;
+		}
+
+		printf("decisions:        %zu\n", states.size());
+		printf("rollouts/second:  %.0f (%.2f us each)\n", rollouts / seconds, seconds * 1e6 / rollouts);
+		printf("repeatable:       %s\n", repeatable ? "match" : "MISMATCH");
+		printf("%10s %12s %12s %12s\n", "budget us", "rollouts", "mean us", "max us");
+
+		const uint32_t budgets[] = { 100, 500, 1000, 4000 };
+		for (uint32_t budget : budgets)
+		{
+			settings.budgetMicroseconds = budget;
+			settings.iterationLimit = 0;
+			uint64_t iterations = 0;
+			uint64_t totalMicroseconds = 0;
+			uint32_t longest = 0;
+			for (size_t i = 0; i < states.size(); i++)
+			{
+				PlannerDecision decision = planner.Plan(states[i], timings, 1, i, settings);
+				iterations += decision.iterations;
+				totalMicroseconds += decision.microseconds;
+				longest = std::max(longest, decision.microseconds);
+			}
+			printf("%10u %12.0f %12.1f %12u\n", budget, static_cast<double>(iterations) / states.size(),
+				static_cast<double>(totalMicroseconds) / states.size(), longest);
+		}
+		return repeatable ? 0 : 2;
+	}
+
+	int AICost(int ticks)
+	{
+		const uint32_t Count = 20000;
+
+		struct Run
+		{
+			const char* name;
+			bool        scheduled;
+			uint32_t    budget;
+		};
+		const Run runs[] = {
+			{ "every tick", false, 0 },
+			{ "scheduled", true, 0 },
+			{ "budgeted", true, GameConstants::Arena::AIDecisionBudget },
+		};
+
+		printf("sumos:            %u\n", Count);
+		printf("ticks:            %d\n", ticks);
+		printf("%-12s %10s %10s %10s %10s %10s %10s %10s\n", "", "mean us", "max us", "checks", "decided", "max dec", "max wait", "left");
+		for (const Run& run : runs)
+		{
+			AIScheduleSettings settings = DefaultAIScheduleSettings();
+			settings.decisionBudget = run.budget;
+
+			SumoArena arena;
+			arena.Reset(Count, GameConstants::Angry, 1);
+			arena.AIScheduling(run.scheduled, settings);
+
+			uint64_t nanoseconds = 0;
+			uint32_t longest = 0;
+			uint64_t checks = 0;
+			uint64_t decisions = 0;
+			uint32_t mostDecisions = 0;
+			uint32_t mostWaiting = 0;
+			for (int tick = 0; tick < ticks; tick++)
+			{
+				arena.Tick();
+				const AITickStats& cost = arena.AICost();
+				nanoseconds += cost.nanoseconds;
+				longest = std::max(longest, cost.nanoseconds);
+				checks += cost.checked;
+				decisions += cost.decided;
+				mostDecisions = std::max(mostDecisions, cost.decided);
+				mostWaiting = std::max(mostWaiting, cost.waiting);
+			}
+
+			printf("%-12s %10.1f %10.1f %10.0f %10.1f %10u %10u %10u\n", run.name,
+				nanoseconds * 1e-3 / ticks, longest * 1e-3, static_cast<double>(checks) / ticks,
+				static_cast<double>(decisions) / ticks, mostDecisions, mostWaiting, arena.Remaining());
+		}
+		return 0;
+	}
+
+	int AudioMix(int seconds, const char* outputPath)
+	{
+		const uint32_t BlockFrames = 256;
+		const uint32_t ArenaCount = 2000;
+		Mixer mixer;
+		uint32_t sampleRate = mixer.Settings().sampleRate;
+
+		auto loadStart = std::chrono::steady_clock::now();
+		uint32_t hit = mixer.Load(SUMO_RESOURCE_DIR "/hit.wav");
+		uint32_t bounce = mixer.Load(SUMO_RESOURCE_DIR "/bounce.wav");
+		double loadSeconds = SecondsSince(loadStart);
+		if (hit == Mixer::InvalidSound || bounce == Mixer::InvalidSound)
+		{
+			fprintf(stderr, "Couldn't load the sounds from %s\n", SUMO_RESOURCE_DIR);
+			return 1;
+		}
+		const uint32_t sounds[] = { hit, bounce };
+		for (uint32_t sound : sounds)
+		{
+			const SoundBuffer& buffer = mixer.Sound(sound);
+			printf("%-17s %u Hz %u channel -> %u Hz stereo, %u frames\n", sound == hit ? "hit.wav:" : "bounce.wav:",
+				buffer.SourceRate(), buffer.SourceChannels(), buffer.SampleRate(), buffer.FrameCount());
+		}
+		printf("load:             %.2f ms for both\n", loadSeconds * 1e3);
+
+		// The SIMD and scalar kernels on the same voice.
+		{
+			const SoundBuffer& buffer = mixer.Sound(hit);
+			std::vector<float> vectorMix(buffer.FrameCount() * 2, 0.25f);
+			std::vector<float> scalarMix = vectorMix;
+			MixStereo(buffer.Samples(), vectorMix.data(), buffer.FrameCount() - 1, 0.7f, 0.3f);
+			MixStereoScalar(buffer.Samples(), scalarMix.data(), buffer.FrameCount() - 1, 0.7f, 0.3f);
+			bool same = vectorMix == scalarMix;
+			printf("SIMD vs scalar:   %s\n", same ? "match" : "MISMATCH");
+			if (!same)
+			{
+				return 2;
+			}
+		}
+
+		// Keep a number of voices playing and time mixing blocks of them.  Voices that
+		// finish are started again, so every block mixes all of them.
+		printf("block:            %u frames (%.2f ms)\n", BlockFrames, BlockFrames * 1e3 / sampleRate);
+		printf("%8s %10s %12s %14s\n", "voices", "us/block", "x realtime", "voices/core");
+		std::vector<float> block(BlockFrames * 2);
+		const uint32_t voiceCounts[] = { 1, 8, 32, 128, 512 };
+		for (uint32_t voices : voiceCounts)
+		{
+			MixerSettings settings = DefaultMixerSettings();
+			settings.maxVoices = voices;
+			Mixer busy(settings);
+			busy.Load(SUMO_RESOURCE_DIR "/hit.wav");
+			busy.Load(SUMO_RESOURCE_DIR "/bounce.wav");
+			CounterRandom random(voices);
+			RandomStream stream(random, 0, 0);
+
+			uint32_t blocks = std::max(200u, 200000u / voices);
+			double mixSeconds = 0.0;
+			for (uint32_t b = 0; b < blocks; b++)
+			{
+				while (busy.ActiveVoices() < voices)
+				{
+					busy.Play(stream.NextInt(2), 0.1f + 0.9f * stream.NextFloat(), stream.NextFloat() * 2.0f - 1.0f);
+				}
+				auto start = std::chrono::steady_clock::now();
+				busy.Render(block.data(), BlockFrames);
+				mixSeconds += SecondsSince(start);
+			}
+			double blockSeconds = mixSeconds / blocks;
+			double realtime = BlockFrames / static_cast<double>(sampleRate) / blockSeconds;
+			printf("%8u %10.2f %12.0f %14.0f\n", voices, blockSeconds * 1e6, realtime, realtime * voices);
+		}
+
+		// The sounds of a crowded arena: every tick's contacts start sounds, panned by
+		// where on the mat they happened, and a tick's worth of audio is mixed after it.
+		SumoArena arena;
+		arena.Dynamics(true);
+		arena.ReportContacts(true);
+		arena.Reset(ArenaCount, GameConstants::Angry, 3);
+		mixer.StopAll();
+
+		float tickLength = GameConstants::Physics::FrameLength;
+		uint32_t ticks = static_cast<uint32_t>(seconds / tickLength);
+		std::vector<float> recording;
+		double mixSeconds = 0.0;
+		double longestMix = 0.0;
+		uint64_t contacts = 0;
+		uint64_t played = 0;
+		uint32_t mostVoices = 0;
+		double owed = 0.0;
+		for (uint32_t tick = 0; tick < ticks; tick++)
+		{
+			arena.Tick();
+			Span<const ContactEvent> events = arena.ContactEvents().Events();
+			for (const ContactEvent& event : events)
+			{
+				// The impulse of two sumos closing at v is v times half a sumo's mass.
+				float velocity = event.impulse / (GameConstants::Arena::SumoMass * 0.5f);
+				played += mixer.PlayContact(velocity > 2.0f ? hit : bounce, velocity, event.x / arena.RingRadius()) ? 1 : 0;
+			}
+			contacts += events.size();
+			mostVoices = std::max(mostVoices, mixer.ActiveVoices());
+
+			owed += tickLength * sampleRate;
+			uint32_t frames = static_cast<uint32_t>(owed);
+			owed -= frames;
+			size_t start = recording.size();
+			recording.resize(start + frames * 2);
+			auto mixStart = std::chrono::steady_clock::now();
+			mixer.Render(recording.data() + start, frames);
+			double elapsed = SecondsSince(mixStart);
+			mixSeconds += elapsed;
+			longestMix = std::max(longestMix, elapsed);
+		}
+
+		uint32_t recorded = static_cast<uint32_t>(recording.size() / 2);
+		printf("arena:            %u sumos, %u ticks, %.1f s of audio\n", ArenaCount, ticks, recorded / static_cast<double>(sampleRate));
+		printf("contacts:         %llu, %llu played, up to %u voices at once\n", static_cast<unsigned long long>(contacts),
+			static_cast<unsigned long long>(played), mostVoices);
+		printf("mix:              %.2f us per tick of %.1f ms, longest %.2f us\n", mixSeconds * 1e6 / std::max(1u, ticks),
+			tickLength * 1e3, longestMix * 1e6);
+		if (outputPath != nullptr)
+		{
+			if (!SaveWave(outputPath, recording.data(), recorded, sampleRate))
+			{
+				fprintf(stderr, "Couldn't write %s\n", outputPath);
+				return 1;
+			}
+			printf("written:          %s\n", outputPath);
+		}
+		return 0;
+	}
+
+	int Contacts(int ticks)
+	{
+		const uint32_t BattleCount = 50000;
+		const uint32_t QueueRounds = 2000;
+
+		// A battle with and without contact reporting.  Reporting must not change it.
+		struct Run
+		{
+			const char* name;
+			bool        dynamics;
+		};
+		const Run runs[] = {
+			{ "positional", false },
+			{ "impulses", true },
+		};
+
+		printf("sumos:            %u\n", BattleCount);
+		printf("ticks:            %d\n", ticks);
+		printf("%-12s %10s %10s %12s %8s\n", "", "quiet us", "report us", "events/tick", "check");
+		bool matched = true;
+		std::vector<ContactEvent> tickEvents;
+		for (const Run& run : runs)
+		{
+			double seconds[2] = { 0.0, 0.0 };
+			uint64_t checksums[2] = { 0, 0 };
+			uint64_t events = 0;
+			for (int reporting = 0; reporting < 2; reporting++)
+			{
+				SumoArena arena;
+				arena.Dynamics(run.dynamics);
+				arena.ReportContacts(reporting != 0);
+				arena.Reset(BattleCount, GameConstants::Angry, 1);
+
+				auto start = std::chrono::steady_clock::now();
+				for (int tick = 0; tick < ticks; tick++)
+				{
+					arena.Tick();
+					events += arena.ContactEvents().Count();
+				}
+				seconds[reporting] = SecondsSince(start);
+				checksums[reporting] = arena.Checksum();
+
+				if (reporting != 0 && run.dynamics)
+				{
+					Span<const ContactEvent> last = arena.ContactEvents().Events();
+					tickEvents.assign(last.begin(), last.end());
+				}
+			}
+
+			bool same = checksums[0] == checksums[1];
+			matched = matched && same;
+			printf("%-12s %10.1f %10.1f %12.0f %8s\n", run.name, seconds[0] * 1e6 / ticks, seconds[1] * 1e6 / ticks,
+				static_cast<double>(events) / ticks, same ? "match" : "MISMATCH");
+		}
+
+		// Hand the last tick's events to a consumer thread over and over through the
+		// game's queue.  The producer doesn't drop any here: it hands over what didn't
+		// fit on its next try, so every event can be checked at the other end.
+		if (tickEvents.empty())
+		{
+			printf("no contacts to queue\n");
+			return 2;
+		}
+		uint32_t perRound = static_cast<uint32_t>(tickEvents.size());
+		uint64_t total = static_cast<uint64_t>(perRound) * QueueRounds;
+		ContactEventQueue queue;
+		bool inOrder = true;
+
+		auto start = std::chrono::steady_clock::now();
+		std::thread consumer([&]()
+		{
+			ContactEvent batch[256];
+			uint64_t received = 0;
+			while (received < total)
+			{
+				uint32_t count = queue.Pop(batch, 256);
+				for (uint32_t i = 0; i < count; i++, received++)
+				{
+					// Each round carries the same events, with the round as the tick.
+					const ContactEvent& expected = tickEvents[received % perRound];
+					inOrder = inOrder && batch[i].tick == received / perRound && batch[i].a == expected.a &&
+						batch[i].b == expected.b && batch[i].impulse == expected.impulse;
+				}
+				if (count == 0)
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+		std::vector<ContactEvent> round = tickEvents;
+		for (uint32_t r = 0; r < QueueRounds; r++)
+		{
+			for (ContactEvent& event : round)
+			{
+				event.tick = r;
+			}
+			uint32_t pushed = 0;
+			while (pushed < perRound)
+			{
+				uint32_t count = queue.Push(round.data() + pushed, perRound - pushed);
+				pushed += count;
+				if (count == 0)
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+		consumer.join();
+		double seconds = SecondsSince(start);
+		matched = matched && inOrder;
+
+		printf("queue capacity:   %u events of %u bytes\n", queue.Capacity(), static_cast<uint32_t>(sizeof(ContactEvent)));
+		printf("queued:           %llu events in rounds of %u\n", static_cast<unsigned long long>(total), perRound);
+		printf("throughput:       %.1f M events/s (%.1f ns per event), %s\n", total / seconds * 1e-6, seconds * 1e9 / total,
+			inOrder ? "in order" : "OUT OF ORDER");
+		return matched ? 0 : 2;
+	}
+
+	int Dynamics(int ticks)
+	{
+		const uint32_t BattleCount = 50000;
+		const uint32_t CrowdCount = 100000;
+		const uint32_t PileCount = 1000;
+		uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+		// A battle, with the push-apart contacts and with impulses, on one thread and on
+		// every core.  The threaded run has to match.
+		struct Run
+		{
+			const char* name;
+			bool        dynamics;
+			uint32_t    threads;
+		};
+		const Run runs[] = {
+			{ "positional", false, 1 },
+			{ "impulses", true, 1 },
+			{ "impulses MT", true, cores },
+		};
+
+		printf("sumos:            %u\n", BattleCount);
+		printf("ticks:            %d\n", ticks);
+		printf("%-12s %8s %10s %10s %10s %8s\n", "", "threads", "mean us", "awake", "left", "check");
+		uint64_t dynamicsChecksum = 0;
+		bool matched = true;
+		for (const Run& run : runs)
+		{
+			JobSystem jobs(run.threads);
+			SumoArena arena;
+			arena.Jobs(&jobs);
+			arena.Dynamics(run.dynamics);
+			arena.Reset(BattleCount, GameConstants::Angry, 1);
+
+			auto start = std::chrono::steady_clock::now();
+			for (int tick = 0; tick < ticks; tick++)
+			{
+				arena.Tick();
+			}
+			double seconds = SecondsSince(start);
+
+			const char* check = "";
+			if (run.dynamics && dynamicsChecksum == 0)
+			{
+				dynamicsChecksum = arena.Checksum();
+			}
+			else if (run.dynamics)
+			{
+				bool same = arena.Checksum() == dynamicsChecksum;
+				matched = matched && same;
+				check = same ? "match" : "MISMATCH";
+			}
+			printf("%-12s %8u %10.1f %10u %10u %8s\n", run.name, run.threads, seconds * 1e6 / ticks,
+				run.dynamics ? arena.Bodies().AwakeCount() : arena.Remaining(), arena.Remaining(), check);
+		}
+
+		// The SIMD and scalar impulse kernels on the same contacts.
+		{
+			SumoArena arena;
+			arena.Dynamics(true);
+			arena.Reset(BattleCount, GameConstants::Angry, 1);
+			for (int tick = 0; tick < 10; tick++)
+			{
+				arena.Tick();
+			}
+			arena.FindContacts();
+			arena.ColorContacts();
+			RigidBodies& bodies = arena.Bodies();
+			uint32_t count = bodies.Count();
+			std::vector<float> startX(bodies.VelocityX(), bodies.VelocityX() + count);
+			std::vector<float> startZ(bodies.VelocityZ(), bodies.VelocityZ() + count);
+			std::vector<uint8_t> awake(bodies.Awake(), bodies.Awake() + count);
+			std::vector<float> vectorX = startX, vectorZ = startZ, scalarX = startX, scalarZ = startZ;
+			std::vector<uint8_t> vectorAwake = awake, scalarAwake = awake;
+			const ContactColoring& batches = arena.ContactBatches();
+			float restitution = bodies.Settings().restitution;
+			for (uint32_t batch = 0; batch < batches.BatchCount(); batch++)
+			{
+				Span<const ContactPair> pairs = batches.Batch(batch);
+				uint32_t pairCount = static_cast<uint32_t>(pairs.size());
+				ApplyContactImpulses(pairs.begin(), pairCount, arena.Entities().PositionX(), arena.Entities().PositionZ(),
+					bodies.InverseMass(), restitution, vectorX.data(), vectorZ.data(), vectorAwake.data());
+				ApplyContactImpulsesScalar(pairs.begin(), pairCount, arena.Entities().PositionX(), arena.Entities().PositionZ(),
+					bodies.InverseMass(), restitution, scalarX.data(), scalarZ.data(), scalarAwake.data());
+			}
+			bool kernelsMatched = vectorX == scalarX && vectorZ == scalarZ && vectorAwake == scalarAwake;
+			matched = matched && kernelsMatched;
+			printf("SIMD vs scalar:   %s\n", kernelsMatched ? "match" : "MISMATCH");
+		}
+
+		// A packed crowd with no AI, shoved in random directions, bouncing off each
+		// other until friction brings it to rest.
+		SumoArena crowd;
+		crowd.Dynamics(true);
+		crowd.Reset(CrowdCount, GameConstants::Easy, 2);
+		RigidBodies& bodies = crowd.Bodies();
+		CounterRandom generator(3);
+		for (uint32_t i = 0; i < CrowdCount; i++)
+		{
+			RandomStream random(generator, i, 0);
+			float angle = random.NextFloat() * 6.2831853f;
+			float speed = random.NextFloat() * 3.0f;
+			bodies.VelocityX()[i] = std::cos(angle) * speed;
+			bodies.VelocityZ()[i] = std::sin(angle) * speed;
+		}
+
+		printf("crowd:            %u\n", CrowdCount);
+		printf("%8s %10s %10s %10s\n", "tick", "tick us", "awake", "contacts");
+		const int Report[] = { 1, 10, 20, 30, 40, 60, 100 };
+		int next = 0;
+		for (int tick = 1; tick <= 100; tick++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			crowd.StepBodies(GameConstants::Physics::FrameLength);
+			double seconds = SecondsSince(start);
+			if (tick == Report[next])
+			{
+				printf("%8d %10.1f %10u %10zu\n", tick, seconds * 1e6, bodies.AwakeCount(), crowd.CandidatePairs().size());
+				next++;
+			}
+		}
+
+		// A crowd all walking at the middle of the mat, where it piles up.  The sumos
+		// stuck in the pile can sleep though they are still driven.
+		SumoArena pile;
+		pile.Dynamics(true);
+		pile.Reset(PileCount, GameConstants::Easy, 4);
+		RigidBodies& pileBodies = pile.Bodies();
+		printf("driven pile:      %u\n", PileCount);
+		printf("%8s %10s %10s %10s\n", "tick", "tick us", "awake", "contacts");
+		for (int tick = 1; tick <= 9000; tick++)
+		{
+			const float* x = pile.Entities().PositionX();
+			const float* z = pile.Entities().PositionZ();
+			for (uint32_t i = 0; i < pileBodies.Count(); i++)
+			{
+				Float3 drive = Normalize(MakeFloat3(-x[i], 0.0f, -z[i])) * 2.0f;
+				pileBodies.DriveX()[i] = drive.x;
+				pileBodies.DriveZ()[i] = drive.z;
+			}
+			auto start = std::chrono::steady_clock::now();
+			pile.StepBodies(GameConstants::Physics::FrameLength);
+			double seconds = SecondsSince(start);
+			if (tick % 1500 == 0)
+			{
+				printf("%8d %10.1f %10u %10zu\n", tick, seconds * 1e6, pileBodies.AwakeCount(), pile.CandidatePairs().size());
+			}
+		}
+		return matched ? 0 : 2;
+	}
+
+	// A netplay player's input for a frame: walking in a direction that changes every
+	// 20 frames, so most frames are predicted right.
+	TickInput ScriptedNetInput(const CounterRandom& generator, uint32_t player, uint32_t frame)
+	{
+		RandomStream random(generator, player, frame / 20);
+		float angle = random.NextFloat() * 6.2831853f;
+		TickInput input;
+		input.playerVelocity = MakeFloat3(std::cos(angle) * 2.0f, 0.0f, std::sin(angle) * 2.0f);
+		return input;
+	}
+
+	int Netplay(uint32_t frames)
+	{
+		const uint64_t Seed = 21;
+		const uint32_t FrameMicroseconds = static_cast<uint32_t>(
+			GameConstants::Network::TicksPerFrame * GameConstants::Physics::FrameLength * 1e6f + 0.5f);
+		// The second peer joins a few frames late.
+		const uint32_t LateStart = 3;
+		CounterRandom inputs(99);
+
+		// The match played on one machine, for both peers to match.
+		SumoSimulation reference;
+		reference.Reset(GameConstants::Easy, Seed);
+		for (uint32_t frame = 0; frame < frames; frame++)
+		{
+			TickInput player = ScriptedNetInput(inputs, 0, frame);
+			TickInput enemy = ScriptedNetInput(inputs, 1, frame);
+			for (int tick = 0; tick < GameConstants::Network::TicksPerFrame; tick++)
+			{
+				reference.VersusTick(player, enemy);
+			}
+		}
+		WorldState expected;
+		reference.Save(expected);
+
+		struct Condition
+		{
+			const char*    name;
+			bool           loopback;
+			LinkConditions link;
+		};
+		const Condition conditions[] = {
+			{ "loopback", true, { 0, 0, 0.0f } },
+			{ "20+5ms", false, { 20000, 5000, 0.0f } },
+			{ "60+20ms 2%", false, { 60000, 20000, 0.02f } },
+			{ "120+40ms 5%", false, { 120000, 40000, 0.05f } },
+		};
+
+		printf("frames:           %u (%u ticks each)\n", frames, GameConstants::Network::TicksPerFrame);
+		printf("%-12s %9s %9s %9s %7s %7s %7s %9s %9s %8s\n", "link", "rollbacks", "resim/fr", "longest", "stalls", "waits",
+			"lost", "mean us", "max us", "check");
+		bool allMatched = true;
+		for (const Condition& condition : conditions)
+		{
+			LoopbackLink loopback;
+			SimulatedLink simulated(condition.link, 5);
+			RollbackSession peers[2] = {
+				RollbackSession(0, condition.loopback ? loopback.End(0) : simulated.End(0)),
+				RollbackSession(1, condition.loopback ? loopback.End(1) : simulated.End(1)),
+			};
+			peers[0].Start(Seed);
+			peers[1].Start(Seed);
+
+			double seconds = 0.0;
+			double longest = 0.0;
+			uint32_t calls = 0;
+			for (uint32_t step = 0; step < frames * 4; step++)
+			{
+				bool done = true;
+				for (uint32_t side = 0; side < 2; side++)
+				{
+					RollbackSession& peer = peers[side];
+					if (side == 1 && step < LateStart)
+					{
+						continue;
+					}
+					if (peer.Frame() < frames)
+					{
+						auto start = std::chrono::steady_clock::now();
+						peer.AdvanceFrame(ScriptedNetInput(inputs, side, peer.Frame()));
+						double elapsed = SecondsSince(start);
+						seconds += elapsed;
+						longest = std::max(longest, elapsed);
+						calls++;
+					}
+					else
+					{
+						// Done; keep answering until the other peer's inputs are all in.
+						peer.Poll();
+					}
+					done = done && peer.ConfirmedFrame() >= frames;
+				}
+				if (done)
+				{
+					break;
+				}
+				simulated.Advance(FrameMicroseconds);
+			}
+
+			bool matched = true;
+			for (uint32_t side = 0; side < 2; side++)
+			{
+				WorldState state;
+				matched = matched && peers[side].ConfirmedFrame() >= frames && peers[side].StateAt(frames, state) &&
+					memcmp(&state, &expected, sizeof(state)) == 0;
+			}
+			allMatched = allMatched && matched;
+
+			RollbackStats stats[2] = { peers[0].Stats(), peers[1].Stats() };
+			printf("%-12s %9u %9.2f %9u %7u %7u %7u %9.2f %9.1f %8s\n", condition.name,
+				stats[0].rollbacks + stats[1].rollbacks,
+				static_cast<double>(stats[0].resimulatedFrames + stats[1].resimulatedFrames) / (stats[0].frames + stats[1].frames),
+				std::max(stats[0].longestRollback, stats[1].longestRollback),
+				stats[0].stalls + stats[1].stalls, stats[0].waits + stats[1].waits,
+				condition.loopback ? 0u : simulated.Stats().dropped,
+				seconds * 1e6 / calls, longest * 1e6, matched ? "match" : "MISMATCH");
+		}
+		return allMatched ? 0 : 2;
+	}
+
+	// The game's meshes and textures, for the software rasterizer.
+	struct RasterAssets
+	{
+		Rendering::MeshData sumo;
+		Rendering::MeshData cylinder;
+		Rendering::Texture  player;
+		Rendering::Texture  enemy;
+		Rendering::Texture  metal;
+	};
+
+	// Add the ring's floor to an arena's entities, with the basis the game's Cylinder
+	// gives it, and build the model matrices.  Returns the floor's index.
+	uint32_t AddFloor(EntityStore& entities)
+	{
+		const float HalfPi = 1.570796327f;
+		EntityHandle floor = entities.Create(MakeFloat3(0.0f, -1.0f, 0.0f));
+		uint32_t index = entities.Index(floor);
+		entities.Basis(index, Rendering::MatrixMultiply(
+			Rendering::MatrixScaling(GameConstants::Arena::RingRadius, GameConstants::Arena::RingRadius, 1.0f),
+			Rendering::MatrixRotationX(-HalfPi)));
+		UpdateTransforms(entities);
+		return index;
+	}
+
+	// The view GameRenderer uploads for the game's camera.
+	Rendering::ConstantBufferChangesEveryFrame GameView()
+	{
+		Rendering::ConstantBufferChangesEveryFrame view;
+		view.view = Rendering::MatrixTranspose(Rendering::MatrixLookAtLH(
+			MakeFloat3(0.0f, 7.0f, 10.0f), MakeFloat3(0.0f, -5.0f, 0.0f), MakeFloat3(0.0f, 1.0f, 0.0f)));
+		return view;
+	}
+
+	// Draw a frame as GameRenderer::Render() does, from the game's camera: the floor with
+	// the cylinder mesh and every other entity as a sumo, 'player' as the player.
+	void DrawArena(Rendering::SoftwareRasterizer& rasterizer, Rendering::FrameBuffer& target, const RasterAssets& assets,
+		const EntityStore& entities, uint32_t floor, uint32_t player)
+	{
+		const float HalfPi = 1.570796327f;
+		float aspectRatio = static_cast<float>(target.Width()) / static_cast<float>(target.Height());
+		Rendering::ConstantBufferChangeOnResize changeOnResize;
+		changeOnResize.projection = Rendering::MatrixTranspose(Rendering::MatrixPerspectiveFovLH(HalfPi, aspectRatio, 0.01f, 100.0f));
+		rasterizer.SetConstants(Rendering::GameLights());
+		rasterizer.SetProjection(changeOnResize);
+		rasterizer.SetView(GameView());
+
+		const Rendering::MaterialParameters playerMaterial = Rendering::PlayerMaterial();
+		const Rendering::MaterialParameters enemyMaterial = Rendering::EnemyMaterial();
+		const Rendering::MaterialParameters cylinderMaterial = Rendering::CylinderMaterial();
+		rasterizer.Begin(&target, Rendering::MakeFloat4(0.1f, 0.1f, 0.1f, 1.0f));
+		for (uint32_t i = 0; i < entities.Count(); i++)
+		{
+			Rendering::ConstantBufferChangesEveryPrim constants;
+			constants.worldMatrix = Rendering::MatrixTranspose(entities.Transforms()[i]);
+			if (i == floor)
+			{
+				Rendering::RenderSetup(cylinderMaterial, &constants);
+				rasterizer.Draw(assets.cylinder, assets.metal, constants);
+			}
+			else
+			{
+				Rendering::RenderSetup(i == player ? playerMaterial : enemyMaterial, &constants);
+				rasterizer.Draw(assets.sumo, i == player ? assets.player : assets.enemy, constants);
+			}
+		}
+		rasterizer.End();
+	}
+
+	int Raster(int frames, const char* outputPath)
+	{
+		const uint32_t CrowdCount = 2000;
+		uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+		RasterAssets assets;
+		assets.sumo = Rendering::SumoMeshData();
+		assets.cylinder = Rendering::CylinderMeshData(26);
+		if (!assets.player.Load(SUMO_RESOURCE_DIR "/SumoBlue.dds") ||
+			!assets.enemy.Load(SUMO_RESOURCE_DIR "/SumoRed.dds") ||
+			!assets.metal.Load(SUMO_RESOURCE_DIR "/metal_texture.dds"))
+		{
+			fprintf(stderr, "Couldn't load the textures from %s\n", SUMO_RESOURCE_DIR);
+			return 1;
+		}
+		printf("textures:         SumoBlue %ux%u, SumoRed %ux%u, metal_texture %ux%u\n",
+			assets.player.Width(), assets.player.Height(), assets.enemy.Width(), assets.enemy.Height(),
+			assets.metal.Width(), assets.metal.Height());
+		printf("meshes:           sumo %u triangles, cylinder %u triangles\n", assets.sumo.TriangleCount(), assets.cylinder.TriangleCount());
+
+		// A match a few seconds in, and a crowd battling in the ring.
+		SumoSimulation match;
+		match.Reset(GameConstants::Angry, 1);
+		for (int tick = 0; tick < 1000; tick++)
+		{
+			Float3 toEnemy = match.EnemyPosition() - match.PlayerPosition();
+			toEnemy.y = 0.0f;
+			TickInput input;
+			input.playerVelocity = Normalize(toEnemy) * 2.0f;
+			match.Tick(input);
+		}
+		uint32_t matchFloor = AddFloor(match.Entities());
+		uint32_t matchPlayer = match.Entities().Index(match.PlayerEntity());
+
+		SumoArena crowd;
+		crowd.Reset(CrowdCount, GameConstants::Angry, 1, GameConstants::Arena::RingRadius);
+		for (int tick = 0; tick < 200; tick++)
+		{
+			crowd.Tick();
+		}
+		uint32_t crowdFloor = AddFloor(crowd.Entities());
+
+		struct Scene
+		{
+			const char*        name;
+			const EntityStore* entities;
+			uint32_t           floor;
+			uint32_t           player;
+		};
+		const Scene scenes[] = {
+			{ "match", &match.Entities(), matchFloor, matchPlayer },
+			{ "crowd", &crowd.Entities(), crowdFloor, 0 },
+		};
+		struct Resolution
+		{
+			uint32_t width;
+			uint32_t height;
+		};
+		const Resolution resolutions[] = { { 320, 240 }, { 1280, 720 }, { 1920, 1080 } };
+
+		// The SSE2 and scalar edge functions have to draw the same pixels.
+		{
+			Rendering::RasterizerSettings scalarSettings = Rendering::DefaultRasterizerSettings();
+			scalarSettings.simd = false;
+			Rendering::SoftwareRasterizer vector;
+			Rendering::SoftwareRasterizer scalar(scalarSettings);
+			Rendering::FrameBuffer vectorTarget(638, 359);
+			Rendering::FrameBuffer scalarTarget(638, 359);
+			DrawArena(vector, vectorTarget, assets, crowd.Entities(), crowdFloor, 0);
+			DrawArena(scalar, scalarTarget, assets, crowd.Entities(), crowdFloor, 0);
+			bool same = vectorTarget.Checksum() == scalarTarget.Checksum();
+			printf("SIMD vs scalar:   %s\n", same ? "match" : "MISMATCH");
+			if (!same)
+			{
+				return 2;
+			}
+		}
+
+		printf("frames:           %d\n", frames);
+		printf("%-6s %10s %8s %10s %8s %10s %10s %18s %8s\n",
+			"scene", "resolution", "threads", "ms/frame", "fps", "triangles", "binned", "checksum", "check");
+		bool matched = true;
+		for (const Scene& scene : scenes)
+		{
+			for (const Resolution& resolution : resolutions)
+			{
+				uint64_t checksum = 0;
+				std::vector<uint32_t> threadCounts(1, 1);
+				if (cores > 1)
+				{
+					threadCounts.push_back(cores);
+				}
+				for (uint32_t threads : threadCounts)
+				{
+					JobSystem jobs(threads);
+					Rendering::SoftwareRasterizer rasterizer;
+					rasterizer.Jobs(&jobs);
+					Rendering::FrameBuffer target(resolution.width, resolution.height);
+
+					// One frame to warm up, then time the rest.
+					DrawArena(rasterizer, target, assets, *scene.entities, scene.floor, scene.player);
+					auto start = std::chrono::steady_clock::now();
+					for (int frame = 0; frame < frames; frame++)
+					{
+						DrawArena(rasterizer, target, assets, *scene.entities, scene.floor, scene.player);
+					}
+					double seconds = SecondsSince(start) / frames;
+
+					const char* check = "";
+					if (threads == 1)
+					{
+						checksum = target.Checksum();
+					}
+					else
+					{
+						bool same = target.Checksum() == checksum;
+						matched = matched && same;
+						check = same ? "match" : "MISMATCH";
+					}
+					const Rendering::RasterizerStats& stats = rasterizer.Stats();
+					printf("%-6s %4ux%-5u %8u %10.2f %8.1f %10u %10u   %016llx %8s\n",
+						scene.name, resolution.width, resolution.height, threads, seconds * 1e3, 1.0 / seconds,
+						stats.triangles - stats.culled, stats.binned, static_cast<unsigned long long>(target.Checksum()), check);
+
+					if (outputPath != nullptr && threads == threadCounts.back() && &scene == &scenes[0] && resolution.width == 1280)
+					{
+						if (!target.SaveTarga(outputPath))
+						{
+							fprintf(stderr, "Couldn't write %s\n", outputPath);
+							return 1;
+						}
+						printf("wrote:            %s\n", outputPath);
+					}
+				}
+			}
+		}
+		return matched ? 0 : 2;
+	}
+
+	// The meshes and materials a recorded frame draws with, as GameRenderer registers
+	// them, and the ids of each in the tables.
+	struct SceneTables
+	{
+		Rendering::RenderMaterial materials[3];
+		Rendering::RenderMesh     meshes[2];
+
+		static const uint16_t PlayerMaterial = 0;
+		static const uint16_t EnemyMaterial = 1;
+		static const uint16_t CylinderMaterial = 2;
+		static const uint16_t SumoMesh = 0;
+		static const uint16_t CylinderMesh = 1;
+
+		SceneTables()
+		{
+			Rendering::RenderMaterial player = { Rendering::PlayerMaterial(), 0, 0, 0, 1, 1 };
+			Rendering::RenderMaterial enemy = { Rendering::EnemyMaterial(), 0, 0, 1, 1, 1 };
+			Rendering::RenderMaterial cylinder = { Rendering::CylinderMaterial(), 0, 0, 2, 1, 1 };
+			materials[PlayerMaterial] = player;
+			materials[EnemyMaterial] = enemy;
+			materials[CylinderMaterial] = cylinder;
+			Rendering::MeshData sumoData = Rendering::SumoMeshData();
+			Rendering::MeshData floorData = Rendering::CylinderMeshData(26);
+			Rendering::RenderMesh sumo = { 0, static_cast<uint32_t>(sumoData.indices.size()), sumoData.BoundingRadius() };
+			Rendering::RenderMesh floor = { 1, static_cast<uint32_t>(floorData.indices.size()), floorData.BoundingRadius() };
+			meshes[SumoMesh] = sumo;
+			meshes[CylinderMesh] = floor;
+		}
+
+		Rendering::SceneResources Resources() const
+		{
+			Rendering::SceneResources resources = { materials, meshes, 3, 2 };
+			return resources;
+		}
+	};
+
+	// Give every entity the render handle GameRenderer would, with the sumos in two
+	// teams: even entities in the player's colors and odd ones in the enemy's, as a
+	// match's two sumos are.  The floor gets the cylinder.
+	void AssignRenderHandles(EntityStore& entities, uint32_t floor)
+	{
+		for (uint32_t i = 0; i < entities.Count(); i++)
+		{
+			RenderHandle handle = { SceneTables::SumoMesh, (i % 2 == 0) ? SceneTables::PlayerMaterial : SceneTables::EnemyMaterial };
+			if (i == floor)
+			{
+				handle.mesh = SceneTables::CylinderMesh;
+				handle.material = SceneTables::CylinderMaterial;
+			}
+			entities.RenderHandles()[i] = handle;
+		}
+	}
+
+	int Commands(int frames)
+	{
+		const uint32_t counts[] = { 2, 1000, 10000, 100000 };
+		const SceneTables tables;
+		struct Order
+		{
+			const char*                      name;
+			Rendering::SceneRecorderSettings settings;
+		};
+		const Order orders[] = {
+			{ "entity", { false, false, false } },
+			{ "filtered", { false, true, false } },
+			{ "sorted", { true, true, false } },
+			{ "instanced", { true, true, true } },
+		};
+
+		printf("frames:           %d\n", frames);
+		printf("%8s %-9s %9s %9s %9s %9s %9s %9s %10s %9s %9s %10s %8s\n",
+			"sumos", "order", "commands", "draws", "triangles", "states", "redundant", "uploadKB",
+			"record us", "null us", "stats us", "ns/draw", "draws");
+		bool matched = true;
+		for (uint32_t count : counts)
+		{
+			SumoArena arena;
+			arena.Reset(count, GameConstants::Angry, 1, GameConstants::Arena::RingRadius);
+			EntityStore& entities = arena.Entities();
+			uint32_t floor = AddFloor(entities);
+			AssignRenderHandles(entities, floor);
+			Rendering::ConstantBufferChangesEveryFrame view = GameView();
+
+			// Every order has to make the same draws, with the same state, as entity order.
+			// Instanced draws use other shaders, so those only have to draw every sumo.
+			uint64_t drawHash = 0;
+			uint32_t draws = 0;
+			uint32_t triangles = 0;
+			for (const Order& order : orders)
+			{
+				Rendering::SceneRecorder recorder(order.settings);
+				Rendering::CommandList commands;
+				Rendering::NullBackend nullBackend;
+				Rendering::RecordingBackend recordingBackend;
+				double recordSeconds = 0.0;
+				double nullSeconds = 0.0;
+				double statsSeconds = 0.0;
+				for (int frame = 0; frame < frames; frame++)
+				{
+					auto start = std::chrono::steady_clock::now();
+					commands.Clear();
+					recorder.Record(entities.Transforms(), entities.RenderHandles(), entities.Count(), view, tables.Resources(), &commands);
+					recordSeconds += SecondsSince(start);
+
+					start = std::chrono::steady_clock::now();
+					nullBackend.Execute(commands);
+					nullSeconds += SecondsSince(start);
+
+					start = std::chrono::steady_clock::now();
+					recordingBackend.Execute(commands);
+					statsSeconds += SecondsSince(start);
+				}
+
+				const Rendering::RenderStats& stats = recordingBackend.Stats();
+				const char* check = "";
+				if (&order == &orders[0])
+				{
+					drawHash = stats.drawHash;
+					draws = stats.draws;
+					triangles = stats.triangles;
+				}
+				else
+				{
+					bool same = order.settings.instanceDraws ?
+						(stats.instances == draws && stats.triangles == triangles) :
+						(stats.drawHash == drawHash);
+					matched = matched && same;
+					check = same ? "match" : "MISMATCH";
+				}
+				printf("%8u %-9s %9u %9u %9u %9u %9u %9.1f %10.1f %9.1f %9.1f %10.1f %8s\n",
+					count, order.name, stats.commands, stats.draws, stats.triangles, stats.StateChanges(), stats.redundantChanges,
+					(stats.constantBytes + stats.instanceBytes) / 1024.0, recordSeconds * 1e6 / frames, nullSeconds * 1e6 / frames,
+					statsSeconds * 1e6 / frames, (recordSeconds + nullSeconds) * 1e9 / frames / stats.draws, check);
+			}
+		}
+		return matched ? 0 : 2;
+	}
+
+	int Instances(int frames)
+	{
+		const uint32_t counts[] = { 1000, 10000, 100000, 1000000 };
+		const SceneTables tables;
+		Rendering::Float4 tints[3];
+		for (int material = 0; material < 3; material++)
+		{
+			tints[material] = tables.materials[material].parameters.diffuseColor;
+		}
+
+		printf("frames:           %d\n", frames);
+		printf("%8s %8s %10s %9s %10s %10s %12s %9s %8s\n",
+			"sumos", "batches", "instances", "MB", "count us", "build us", "ns/instance", "GB/s", "stream");
+		bool matched = true;
+		for (uint32_t count : counts)
+		{
+			SumoArena arena;
+			arena.Reset(count, GameConstants::Angry, 1, GameConstants::Arena::RingRadius);
+			EntityStore& entities = arena.Entities();
+			uint32_t floor = AddFloor(entities);
+			AssignRenderHandles(entities, floor);
+
+			Rendering::InstanceBuilder builder;
+			std::vector<Rendering::InstanceData> instances;
+			double countSeconds = 0.0;
+			double buildSeconds = 0.0;
+			for (int frame = 0; frame < frames; frame++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				builder.Count(entities.RenderHandles(), entities.Count(), 3, 2);
+				countSeconds += SecondsSince(start);
+
+				instances.resize(builder.InstanceCount());
+				start = std::chrono::steady_clock::now();
+				builder.Build(entities.Transforms(), entities.RenderHandles(), entities.Count(), tints, instances.data());
+				buildSeconds += SecondsSince(start);
+			}
+
+			// Each batch has to hold exactly the entities with its handle, in entity order.
+			bool same = builder.InstanceCount() == entities.Count();
+			for (const Rendering::InstanceBatch& batch : builder.Batches())
+			{
+				uint32_t instance = batch.firstInstance;
+				for (uint32_t i = 0; i < entities.Count() && same; i++)
+				{
+					RenderHandle handle = entities.RenderHandles()[i];
+					if (handle.material != batch.material || handle.mesh != batch.mesh)
+					{
+						continue;
+					}
+					same =
+						instance < batch.firstInstance + batch.instanceCount &&
+						memcmp(&instances[instance].world, &entities.Transforms()[i], sizeof(Float4x4)) == 0 &&
+						memcmp(&instances[instance].tint, &tints[batch.material], sizeof(Rendering::Float4)) == 0;
+					instance++;
+				}
+				same = same && instance == batch.firstInstance + batch.instanceCount;
+			}
+			matched = matched && same;
+
+			double bytes = static_cast<double>(builder.InstanceCount()) * sizeof(Rendering::InstanceData);
+			printf("%8u %8u %10u %9.1f %10.1f %10.1f %12.2f %9.2f %8s\n",
+				count, static_cast<uint32_t>(builder.Batches().size()), builder.InstanceCount(), bytes / (1024.0 * 1024.0),
+				countSeconds * 1e6 / frames, buildSeconds * 1e6 / frames,
+				(countSeconds + buildSeconds) * 1e9 / frames / builder.InstanceCount(),
+				bytes * frames / buildSeconds / 1e9, same ? "match" : "MISMATCH");
+		}
+		return matched ? 0 : 2;
+	}
+
+	// Plays frames of 'objects' constant uploads through an arena, with the GPU
+	// finishing each frame 'framesInFlight' - 1 frames after it was submitted, and
+	// waiting for it early when the arena runs out of room.
+	struct UploadRun
+	{
+		double   allocateSeconds;
+		double   writeSeconds;
+		uint32_t waits;
+		uint32_t overlaps;      // Allocations over memory a frame in flight still held.
+		uint32_t failures;      // Allocations that didn't fit even with no other frame in flight.
+	};
+
+	UploadRun RunUploads(const Rendering::UploadArenaSettings& settings, uint32_t objects, int frames, bool write, bool check)
+	{
+		UploadRun run = { 0.0, 0.0, 0, 0, 0 };
+		Rendering::UploadArena arena(settings);
+		std::vector<uint8_t> ring(settings.capacity);
+		std::vector<uint64_t> owners(check ? settings.capacity / settings.alignment : 0, 0);
+		uint64_t retired = 0;
+
+		Rendering::ConstantBufferChangesEveryPrim constants;
+		constants.worldMatrix = Float4x4Identity();
+		Rendering::RenderSetup(Rendering::PlayerMaterial(), &constants);
+		const uint32_t size = static_cast<uint32_t>(sizeof(constants));
+
+		for (uint64_t frame = 1; frame <= static_cast<uint64_t>(frames); frame++)
+		{
+			if (frame > settings.framesInFlight)
+			{
+				retired = std::max(retired, frame - settings.framesInFlight);
+				arena.Retire(retired);
+			}
+			while (arena.MustWait())
+			{
+				retired = arena.OldestFrame();
+				arena.Retire(retired);
+				run.waits++;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			arena.BeginFrame(frame);
+			for (uint32_t i = 0; i < objects; i++)
+			{
+				uint32_t offset = arena.Allocate(size);
+				while (offset == Rendering::UploadArena::NoSpace && arena.FramesInFlight() > 0)
+				{
+					retired = arena.OldestFrame();
+					arena.Retire(retired);
+					run.waits++;
+					offset = arena.Allocate(size);
+				}
+				if (offset == Rendering::UploadArena::NoSpace)
+				{
+					run.failures++;
+					continue;
+				}
+				if (write)
+				{
+					constants.worldMatrix.m[3][0] = static_cast<float>(i);
+					memcpy(&ring[offset], &constants, size);
+				}
+				if (check)
+				{
+					uint32_t first = offset / settings.alignment;
+					uint32_t last = (offset + size - 1) / settings.alignment;
+					for (uint32_t block = first; block <= last; block++)
+					{
+						if ((offset % settings.alignment) != 0 || (owners[block] != 0 && owners[block] > retired))
+						{
+							run.overlaps++;
+						}
+						owners[block] = frame;
+					}
+				}
+			}
+			arena.EndFrame();
+			(write ? run.writeSeconds : run.allocateSeconds) += SecondsSince(start);
+		}
+		return run;
+	}
+
+	int Uploads(int frames)
+	{
+		const uint32_t counts[] = { 100, 1000, 10000, 100000 };
+		const uint32_t Alignment = 256;
+		const uint32_t FramesInFlight = 3;
+
+		printf("frames:           %d\n", frames);
+		printf("frames in flight: %u\n", FramesInFlight);
+		printf("%8s %-7s %11s %11s %10s %10s %9s %8s\n",
+			"objects", "ring", "capacityKB", "waits/frame", "alloc ns", "write ns", "GB/s", "ranges");
+		bool matched = true;
+		for (uint32_t count : counts)
+		{
+			// Room for every frame in flight, with an odd block over so the frames
+			// wrap at a different place each time round; and room for one frame fewer.
+			struct Ring
+			{
+				const char* name;
+				uint32_t    capacity;
+			};
+			const Ring rings[] = {
+				{ "roomy", (FramesInFlight * count + 3) * Alignment },
+				{ "tight", ((FramesInFlight - 1) * count + 3) * Alignment },
+			};
+			for (const Ring& ring : rings)
+			{
+				Rendering::UploadArenaSettings settings = { ring.capacity, Alignment, FramesInFlight };
+				UploadRun checked = RunUploads(settings, count, std::min(frames, 50), true, true);
+				UploadRun allocate = RunUploads(settings, count, frames, false, false);
+				UploadRun write = RunUploads(settings, count, frames, true, false);
+
+				bool same = checked.overlaps == 0 && checked.failures == 0 && write.failures == 0;
+				matched = matched && same;
+				double allocations = static_cast<double>(count) * frames;
+				printf("%8u %-7s %11.1f %11.2f %10.2f %10.2f %9.2f %8s\n",
+					count, ring.name, ring.capacity / 1024.0, static_cast<double>(write.waits) / frames,
+					allocate.allocateSeconds * 1e9 / allocations, write.writeSeconds * 1e9 / allocations,
+					allocations * sizeof(Rendering::ConstantBufferChangesEveryPrim) / write.writeSeconds / 1e9,
+					same ? "ok" : "OVERLAP");
+			}
+		}
+		return matched ? 0 : 2;
+	}
+
+	int Cull(int repeat, uint32_t maxThreads)
+	{
+		const uint32_t Count = 1000000;
+		const float FieldSize = 120.0f;
+		const float HalfPi = 1.570796327f;
+
+		// Sumos scattered over a field centered under the game's camera, each bounded
+		// by the sphere around its block.  The culler reads the EntityStore's position
+		// arrays in place, with the one radius every sumo shares.
+		EntityStore entities;
+		entities.Reserve(Count);
+		CounterRandom generator(7);
+		for (uint32_t i = 0; i < Count; i++)
+		{
+			RandomStream random(generator, i, 0);
+			float x = (random.NextFloat() - 0.5f) * FieldSize;
+			float z = (random.NextFloat() - 0.5f) * FieldSize;
+			entities.Create(MakeFloat3(x, GameConstants::Arena::SumoSize * 0.5f, z));
+		}
+		const float Radius = GameConstants::Arena::SumoSize * 0.8660254f;
+		Rendering::BoundingSpheres spheres = { entities.PositionX(), entities.PositionY(), entities.PositionZ(), nullptr, Radius };
+
+		Rendering::Frustum frustum = Rendering::ExtractFrustum(
+			Rendering::MatrixLookAtLH(MakeFloat3(0.0f, 7.0f, 10.0f), MakeFloat3(0.0f, -5.0f, 0.0f), MakeFloat3(0.0f, 1.0f, 0.0f)),
+			Rendering::MatrixPerspectiveFovLH(HalfPi, 16.0f / 9.0f, 0.01f, 100.0f));
+
+		std::vector<uint32_t> reference(Count);
+		double scalarSeconds = 0.0;
+		uint32_t visibleCount = 0;
+		for (int i = 0; i < repeat; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			visibleCount = Rendering::CullSpheresScalar(frustum, spheres, 0, Count, reference.data());
+			scalarSeconds += SecondsSince(start);
+		}
+
+		std::vector<uint32_t> threadCounts;
+		for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+		{
+			threadCounts.push_back(threads);
+		}
+		threadCounts.push_back(maxThreads);
+
+		printf("spheres:          %u\n", Count);
+		printf("visible:          %u (%.1f%%)\n", visibleCount, 100.0 * visibleCount / Count);
+		printf("kernel:           %s\n", Rendering::CullingInstructionSet());
+		printf("%8s %8s %10s %10s %10s %8s\n", "kernel", "threads", "cull us", "ns/sphere", "speedup", "check");
+		printf("%8s %8u %10.1f %10.3f %9.2fx %8s\n", "scalar", 1u,
+			scalarSeconds * 1e6 / repeat, scalarSeconds * 1e9 / repeat / Count, 1.0, "");
+
+		// Every thread count with the shared radius, then one thread reading a radius
+		// per sphere, which streams a third more memory.
+		std::vector<float> radius(Count, Radius);
+		Rendering::BoundingSpheres radii = { entities.PositionX(), entities.PositionY(), entities.PositionZ(), radius.data(), 0.0f };
+		struct Run
+		{
+			const char*                       name;
+			uint32_t                          threads;
+			const Rendering::BoundingSpheres* spheres;
+		};
+		std::vector<Run> runs;
+		for (uint32_t threads : threadCounts)
+		{
+			Run run = { "simd", threads, &spheres };
+			runs.push_back(run);
+		}
+		Run radiiRun = { "radii", 1, &radii };
+		runs.push_back(radiiRun);
+
+		bool allMatched = true;
+		std::vector<uint32_t> visible(Count);
+		for (const Run& run : runs)
+		{
+			JobSystem jobs(run.threads);
+			Rendering::FrustumCuller culler;
+			culler.Jobs(&jobs);
+
+			double seconds = 0.0;
+			uint32_t written = 0;
+			for (int i = 0; i < repeat; i++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				written = culler.Cull(frustum, *run.spheres, Count, visible.data());
+				seconds += SecondsSince(start);
+			}
+
+			bool matched = written == visibleCount && memcmp(visible.data(), reference.data(), written * sizeof(uint32_t)) == 0;
+			allMatched = allMatched && matched;
+			printf("%8s %8u %10.1f %10.3f %9.2fx %8s\n", run.name, run.threads,
+				seconds * 1e6 / repeat, seconds * 1e9 / repeat / Count, scalarSeconds / seconds,
+				matched ? "match" : "MISMATCH");
+		}
+		return allMatched ? 0 : 2;
+	}
+
+	int Snapshots(int rollbacks)
+	{
+		// A rendered frame at 60 Hz is six ticks, and a rollback replays the last 8.
+		const int TicksPerFrame = 6;
+		const int RollbackFrames = 8;
+		const int RollbackTicks = TicksPerFrame * RollbackFrames;
+
+		// Play a scripted match for the inputs and states to work from.
+		SumoSimulation simulation;
+		simulation.Reset(GameConstants::Angry, 11);
+		std::vector<TickInput> inputs;
+		std::vector<WorldState> states;
+		while (simulation.CheckRingOut() == RoundResult::InProgress && inputs.size() < 20000)
+		{
+			WorldState state;
+			simulation.Save(state);
+			states.push_back(state);
+
+			Float3 toEnemy = simulation.EnemyPosition() - simulation.PlayerPosition();
+			toEnemy.y = 0.0f;
+			TickInput input;
+			input.playerVelocity = Normalize(toEnemy) * 2.0f;
+			inputs.push_back(input);
+			simulation.Tick(input);
+		}
+		uint32_t ticks = static_cast<uint32_t>(inputs.size());
+		if (ticks <= static_cast<uint32_t>(RollbackTicks))
+		{
+			fprintf(stderr, "match too short\n");
+			return 1;
+		}
+
+		// Save and restore on their own.
+		const int Copies = 1000000;
+		WorldState scratch;
+		auto saveStart = std::chrono::steady_clock::now();
+		for (int i = 0; i < Copies; i++)
+		{
+			simulation.Save(scratch);
+		}
+		double saveSeconds = SecondsSince(saveStart);
+		auto restoreStart = std::chrono::steady_clock::now();
+		for (int i = 0; i < Copies; i++)
+		{
+			simulation.Restore(states[i % ticks]);
+		}
+		double restoreSeconds = SecondsSince(restoreStart);
+
+		// Deltas between neighboring ticks and between the frames a rollback spans.
+		std::vector<uint8_t> delta;
+		size_t tickBytes = 0, frameBytes = 0;
+		bool decoded = true;
+		auto deltaStart = std::chrono::steady_clock::now();
+		for (uint32_t tick = 1; tick < ticks; tick++)
+		{
+			EncodeDelta(states[tick - 1], states[tick], delta);
+			tickBytes += delta.size();
+			WorldState rebuilt;
+			decoded = decoded && DecodeDelta(states[tick - 1], delta.data(), delta.size(), rebuilt) &&
+				memcmp(&rebuilt, &states[tick], sizeof(rebuilt)) == 0;
+		}
+		double deltaSeconds = SecondsSince(deltaStart);
+		uint32_t frames = 0;
+		for (uint32_t tick = RollbackTicks; tick < ticks; tick += TicksPerFrame)
+		{
+			EncodeDelta(states[tick - RollbackTicks], states[tick], delta);
+			frameBytes += delta.size();
+			frames++;
+		}
+
+		// Roll back 8 frames from points through the match and play them again.  The
+		// replayed state has to match the original run.
+		SnapshotRing ring(RollbackTicks + 1);
+		bool replayed = true;
+		auto rollbackStart = std::chrono::steady_clock::now();
+		for (int i = 0; i < rollbacks; i++)
+		{
+			uint32_t from = 1 + static_cast<uint32_t>(i) % (ticks - RollbackTicks);
+			simulation.Restore(states[from - 1]);
+			ring.Save(simulation);
+			if (!ring.Restore(simulation, from - 1))
+			{
+				replayed = false;
+			}
+			for (uint32_t tick = from - 1; tick < from - 1 + RollbackTicks; tick++)
+			{
+				simulation.Tick(inputs[tick]);
+			}
+			WorldState end;
+			simulation.Save(end);
+			replayed = replayed && memcmp(&end, &states[from - 1 + RollbackTicks], sizeof(end)) == 0;
+		}
+		double rollbackSeconds = SecondsSince(rollbackStart);
+
+		printf("state:            %zu bytes\n", sizeof(WorldState));
+		printf("save:             %.1f ns\n", saveSeconds * 1e9 / Copies);
+		printf("restore:          %.1f ns\n", restoreSeconds * 1e9 / Copies);
+		printf("tick delta:       %.1f bytes, %.1f ns to encode and decode (%s)\n",
+			static_cast<double>(tickBytes) / (ticks - 1), deltaSeconds * 1e9 / (ticks - 1), decoded ? "match" : "MISMATCH");
+		printf("8 frame delta:    %.1f bytes\n", static_cast<double>(frameBytes) / frames);
+		printf("rollback:         %.2f us to restore and replay %d frames (%d ticks) (%s)\n",
+			rollbackSeconds * 1e6 / rollbacks, RollbackFrames, RollbackTicks, replayed ? "match" : "MISMATCH");
+		return (decoded && replayed) ? 0 : 2;
+	}
+
+	int Swept(int pairs)
+	{
+		// A slow rendered frame, and the fixed ticks it takes.
+		const float Frame = 1.0f / 30.0f;
+		const int Ticks = static_cast<int>(Frame / GameConstants::Physics::FrameLength + 0.5f);
+
+		// Pairs of sumos a few units apart, heading for each other too fast for a tick's
+		// contact test to catch: each frame closes 1.5 to 4 times the gap.  They are off
+		// center by less than a sumo, so they must meet.
+		struct Pair
+		{
+			Float3 a, moveA, b, moveB;
+		};
+		std::vector<Pair> shots(pairs);
+		CounterRandom generator(5);
+		for (int i = 0; i < pairs; i++)
+		{
+			RandomStream random(generator, i, 0);
+			float angle = random.NextFloat() * 6.2831853f;
+			Float3 along = MakeFloat3(std::cos(angle), 0.0f, std::sin(angle));
+			Float3 across = MakeFloat3(-along.z, 0.0f, along.x);
+			float gap = 2.0f + random.NextFloat() * 4.0f;
+			float offset = (random.NextFloat() - 0.5f) * GameConstants::Arena::SumoSize;
+			float speed = gap / Frame * (1.5f + random.NextFloat() * 2.5f);
+			Pair& shot = shots[i];
+			shot.a = MakeFloat3(0.0f, GameConstants::Arena::StartHeight, 0.0f);
+			shot.b = shot.a + along * gap + across * offset;
+			shot.moveA = along * (speed * Frame * 0.5f);
+			shot.moveB = along * (-speed * Frame * 0.5f);
+		}
+
+		// Passed through: the pair ends the frame the other way round along the line
+		// between their centers when they first touched.  Sliding off each other
+		// sideways is fine.
+		int oneStep = 0, fixedTicks = 0, swept = 0;
+		for (const Pair& shot : shots)
+		{
+			float impact = CircleImpactTime(shot.a, shot.moveA, shot.b, shot.moveB, GameConstants::Arena::SumoSize);
+			Float3 before = (shot.b + shot.moveB * impact) - (shot.a + shot.moveA * impact);
+
+			Float3 a = shot.a + shot.moveA;
+			Float3 b = shot.b + shot.moveB;
+			ResolveContact(a, b);
+			oneStep += Dot(b - a, before) < 0.0f;
+
+			a = shot.a;
+			b = shot.b;
+			for (int tick = 0; tick < Ticks; tick++)
+			{
+				a = a + shot.moveA * (1.0f / Ticks);
+				b = b + shot.moveB * (1.0f / Ticks);
+				ResolveContact(a, b);
+			}
+			fixedTicks += Dot(b - a, before) < 0.0f;
+
+			a = shot.a + shot.moveA;
+			b = shot.b + shot.moveB;
+			ResolveSweptContact(shot.a, a, shot.b, b);
+			swept += Dot(b - a, before) < 0.0f;
+		}
+
+		// A player charging the enemy in a match, one frame at a time.
+		int chargesThroughTicks = 0, chargesThroughSwept = 0;
+		const int Charges = 100;
+		for (int charge = 0; charge < Charges; charge++)
+		{
+			TickInput input;
+			input.playerVelocity = MakeFloat3(100.0f + charge * 4.0f, 0.0f, 0.0f);
+			for (int mode = 0; mode < 2; mode++)
+			{
+				SumoSimulation simulation;
+				simulation.Reset(GameConstants::Easy, charge);
+				bool through = false;
+				for (int frame = 0; frame < 30 && simulation.CheckRingOut() == RoundResult::InProgress; frame++)
+				{
+					if (mode == 0)
+					{
+						for (int tick = 0; tick < Ticks; tick++)
+						{
+							simulation.Tick(input);
+						}
+					}
+					else
+					{
+						simulation.SweptTick(input, Frame);
+					}
+					through = through || simulation.PlayerPosition().x > simulation.EnemyPosition().x;
+				}
+				(mode == 0 ? chargesThroughTicks : chargesThroughSwept) += through;
+			}
+		}
+
+		// The cost of a frame of an ordinary match.
+		const int Frames = 20000;
+		double frameMicroseconds[2];
+		for (int mode = 0; mode < 2; mode++)
+		{
+			SumoSimulation simulation;
+			simulation.Reset(GameConstants::Angry, 1);
+			auto start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < Frames; frame++)
+			{
+				if (simulation.CheckRingOut() != RoundResult::InProgress)
+				{
+					simulation.Reset(GameConstants::Angry, frame);
+				}
+				Float3 toEnemy = simulation.EnemyPosition() - simulation.PlayerPosition();
+				toEnemy.y = 0.0f;
+				TickInput input;
+				input.playerVelocity = Normalize(toEnemy) * 2.0f;
+				if (mode == 0)
+				{
+					for (int tick = 0; tick < Ticks; tick++)
+					{
+						simulation.Tick(input);
+					}
+				}
+				else
+				{
+					simulation.SweptTick(input, Frame);
+				}
+			}
+			frameMicroseconds[mode] = SecondsSince(start) * 1e6 / Frames;
+		}
+
+		printf("frame:            %.1f ms (%d fixed ticks)\n", Frame * 1e3f, Ticks);
+		printf("pairs:            %d\n", pairs);
+		printf("through, 1 step:  %d\n", oneStep);
+		printf("through, ticks:   %d\n", fixedTicks);
+		printf("through, swept:   %d\n", swept);
+		printf("charges through:  %d of %d in ticks, %d of %d swept\n", chargesThroughTicks, Charges, chargesThroughSwept, Charges);
+		printf("frame, ticks:     %.2f us\n", frameMicroseconds[0]);
+		printf("frame, swept:     %.2f us (%.1fx)\n", frameMicroseconds[1], frameMicroseconds[0] / frameMicroseconds[1]);
+		return (swept == 0 && chargesThroughSwept == 0) ? 0 : 2;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && strcmp(argv[1], "broadphase") == 0)
+	{
+		int ticks = (argc > 2) ? atoi(argv[2]) : 20;
+		return Broadphase(ticks > 0 ? ticks : 20);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "narrowphase") == 0)
+	{
+		int repeat = (argc > 2) ? atoi(argv[2]) : 20;
+		return Narrowphase(repeat > 0 ? repeat : 20);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "transforms") == 0)
+	{
+		int frames = (argc > 2) ? atoi(argv[2]) : 10;
+		return Transforms(frames > 0 ? frames : 10);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "solver") == 0)
+	{
+		int repeat = (argc > 2) ? atoi(argv[2]) : 20;
+		int threads = (argc > 3) ? atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+		return Solver(repeat > 0 ? repeat : 20, threads > 0 ? threads : 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "random") == 0)
+	{
+		int repeat = (argc > 2) ? atoi(argv[2]) : 10;
+		return RandomDraws(repeat > 0 ? repeat : 10);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "planner") == 0)
+	{
+		int decisions = (argc > 2) ? atoi(argv[2]) : 200;
+		return Planner(decisions > 0 ? decisions : 200);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "ai") == 0)
+	{
+		int ticks = (argc > 2) ? atoi(argv[2]) : 1000;
+		return AICost(ticks > 0 ? ticks : 1000);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "audio") == 0)
+	{
+		int seconds = (argc > 2) ? atoi(argv[2]) : 10;
+		return AudioMix(seconds > 0 ? seconds : 10, (argc > 3) ? argv[3] : nullptr);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "commands") == 0)
+	{
+		int frames = (argc > 2) ? atoi(argv[2]) : 100;
+		return Commands(frames > 0 ? frames : 100);
+	}
+	if (argc > 1 && strcmp(argv[1], "instances") == 0)
+	{
+		int frames = (argc > 2) ? atoi(argv[2]) : 20;
+		return Instances(frames > 0 ? frames : 20);
+	}
+	if (argc > 1 && strcmp(argv[1], "upload") == 0)
+	{
+		int frames = (argc > 2) ? atoi(argv[2]) : 200;
+		return Uploads(frames > 0 ? frames : 200);
+	}
+	if (argc > 1 && strcmp(argv[1], "cull") == 0)
+	{
+		int repeat = (argc > 2) ? atoi(argv[2]) : 50;
+		int threads = (argc > 3) ? atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+		return Cull(repeat > 0 ? repeat : 50, threads > 0 ? threads : 1);
+	}
+	if (argc > 1 && strcmp(argv[1], "contacts") == 0)
+	{
+		int ticks = (argc > 2) ? atoi(argv[2]) : 100;
+		return Contacts(ticks > 0 ? ticks : 100);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "dynamics") == 0)
+	{
+		int ticks = (argc > 2) ? atoi(argv[2]) : 100;
+		return Dynamics(ticks > 0 ? ticks : 100);
+	}
+	if (argc > 1 && strcmp(argv[1], "netplay") == 0)
+	{
+		int frames = (argc > 2) ? atoi(argv[2]) : 4000;
+		return Netplay(frames > 0 ? frames : 4000);
+	}
+	if (argc > 1 && strcmp(argv[1], "raster") == 0)
+	{
+		int frames = (argc > 2) ? atoi(argv[2]) : 20;
+		return Raster(frames > 0 ? frames : 20, (argc > 3) ? argv[3] : nullptr);
+	}
+	if (argc > 1 && strcmp(argv[1], "snapshot") == 0)
+	{
+		int rollbacks = (argc > 2) ? atoi(argv[2]) : 100000;
+		return Snapshots(rollbacks > 0 ? rollbacks : 100000);
+	}
+	if (argc > 1 && strcmp(argv[1], "swept") == 0)
+	{
+		int pairs = (argc > 2) ? atoi(argv[2]) : 10000;
+		return Swept(pairs > 0 ? pairs : 10000);
+	}
+	fprintf(stderr, "Usage: SumoBench broadphase [ticks] | narrowphase [repeat] | transforms [frames] | solver [repeat [threads]] | random [repeat] | planner [decisions] | ai [ticks] | audio [seconds [output.wav]] | commands [frames] | instances [frames] | upload [frames] | cull [repeat [threads]] | contacts [ticks] | dynamics [ticks] | netplay [frames] | raster [frames [output.tga]] | snapshot [rollbacks] | swept [pairs]\n");
+	return 1;
+}
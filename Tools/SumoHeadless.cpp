@@ -0,0 +1,257 @@
+// SumoHeadless:
+// Runs sumo rounds through the portable simulation without a window or a GPU.
+// The player is scripted to walk straight at the enemy at the controller's full
+// movement speed.  Each round runs in deterministic fixed ticks until one sumo is
+// rung out or the round time limit is reached.
+//
+// Usage:
+//     SumoHeadless [rounds [seed]]        Play scripted rounds and report the results.
+//     SumoHeadless record <file> [seed]   Play one scripted round and save it as a replay.
+//     SumoHeadless play <file> [repeat]   Play a replay back, verify it reproduces the
+//                                         recorded state bit for bit and report ticks/second.
+//     SumoHeadless frames [count]         Run rendered frames (fixed stepper, ticks, transforms
+//                                         and scene snapshot) and report heap allocations per frame,
+//                                         failing if a steady-state frame allocates.
+
+#include "Simulation/SumoSimulation.h"
+#include "Simulation/Replay.h"
+#include "Simulation/FixedStepper.h"
+#include "Simulation/SceneSnapshot.h"
+#include "Simulation/TransformSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace Simulation;
+
+// Count every heap allocation made by the process so frames can be checked for allocations.
+static std::atomic<uint64_t> s_allocationCount(0);
+
+void* operator new(size_t size)
+{
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+namespace
+{
+	const float    PlayerSpeed     = 2.0f;             // Matches MOVEMENT_GAIN in MoveLookController.
+	const float    RoundTimeLimit  = 120.0f;
+	const uint32_t RoundTickLimit  = static_cast<uint32_t>(RoundTimeLimit / GameConstants::Physics::FrameLength);
+
+	TickInput ScriptedPlayerInput(const SumoSimulation& simulation)
+	{
+		Float3 toEnemy = simulation.EnemyPosition() - simulation.PlayerPosition();
+		toEnemy.y = 0.0f;
+
+		TickInput input;
+		input.playerVelocity = Normalize(toEnemy) * PlayerSpeed;
+		return input;
+	}
+
+	RoundResult PlayRound(SumoSimulation& simulation, Replay* replay)
+	{
+		RoundResult result = RoundResult::InProgress;
+		while (result == RoundResult::InProgress && simulation.TickCount() < RoundTickLimit)
+		{
+			TickInput input = ScriptedPlayerInput(simulation);
+			if (replay != nullptr)
+			{
+				replay->Record(input);
+			}
+			simulation.Tick(input);
+			result = simulation.CheckRingOut();
+		}
+		return result;
+	}
+
+	double SecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	int RunRounds(int rounds, uint64_t seed)
+	{
+		CounterRandom matches(seed);
+
+		int playerWins = 0;
+		int enemyWins = 0;
+		int timeouts = 0;
+		double totalRoundTime = 0.0;
+
+		SumoSimulation simulation;
+		auto start = std::chrono::steady_clock::now();
+
+		for (int round = 0; round < rounds; round++)
+		{
+			RandomStream random(matches, 0, round);
+			simulation.Reset(static_cast<GameConstants::Behavior>(random.NextInt(3)), random.Next());
+
+			switch (PlayRound(simulation, nullptr))
+			{
+			case RoundResult::EnemyRingOut:  playerWins++; break;
+			case RoundResult::PlayerRingOut: enemyWins++;  break;
+			default:                         timeouts++;   break;
+			}
+			totalRoundTime += simulation.TickCount() * GameConstants::Physics::FrameLength;
+		}
+
+		double seconds = SecondsSince(start);
+
+		printf("rounds:           %d\n", rounds);
+		printf("player wins:      %d\n", playerWins);
+		printf("enemy wins:       %d\n", enemyWins);
+		printf("timeouts:         %d\n", timeouts);
+		printf("mean round time:  %.2f s\n", totalRoundTime / rounds);
+		printf("rounds/second:    %.0f\n", rounds / seconds);
+		return 0;
+	}
+
+	int Record(const char* path, uint64_t seed)
+	{
+		CounterRandom matches(seed);
+		RandomStream random(matches, 0, 0);
+		GameConstants::Behavior behavior = static_cast<GameConstants::Behavior>(random.NextInt(3));
+
+		SumoSimulation simulation;
+		Replay replay;
+		replay.Begin(simulation, behavior, seed);
+		replay.Start(simulation);
+		PlayRound(simulation, &replay);
+		replay.Finish(simulation.Checksum());
+
+		if (!replay.Save(path))
+		{
+			fprintf(stderr, "Unable to write replay '%s'\n", path);
+			return 1;
+		}
+		printf("recorded %u ticks to %s (%zu bytes), checksum %016llx\n",
+			replay.TickCount(), path, replay.Serialize().size(),
+			static_cast<unsigned long long>(replay.FinalChecksum()));
+		return 0;
+	}
+
+	int Play(const char* path, int repeat)
+	{
+		Replay replay;
+		if (!replay.Load(path))
+		{
+			fprintf(stderr, "Unable to read replay '%s'\n", path);
+			return 1;
+		}
+
+		SumoSimulation simulation;
+		bool matched = true;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < repeat; i++)
+		{
+			matched = replay.Play(simulation) && matched;
+		}
+		double seconds = SecondsSince(start);
+
+		printf("ticks:            %u\n", replay.TickCount());
+		printf("checksum:         %016llx (%s)\n",
+			static_cast<unsigned long long>(simulation.Checksum()), matched ? "match" : "MISMATCH");
+		printf("ticks/second:     %.0f\n", static_cast<double>(replay.TickCount()) * repeat / seconds);
+		return matched ? 0 : 2;
+	}
+
+	int Frames(int frames)
+	{
+		const float FrameTime = 1.0f / 60.0f;
+
+		SumoSimulation simulation;
+		simulation.Reset(GameConstants::Angry, 1);
+		EntityStore& entities = simulation.Entities();
+		RenderHandle sumo = { 0, 0 };
+		entities.RenderHandles()[entities.Index(simulation.PlayerEntity())] = sumo;
+		entities.RenderHandles()[entities.Index(simulation.EnemyEntity())] = sumo;
+		entities.FacingTarget(entities.Index(simulation.PlayerEntity()), simulation.EnemyEntity());
+		entities.FacingTarget(entities.Index(simulation.EnemyEntity()), simulation.PlayerEntity());
+
+		FixedStepper stepper(GameConstants::Physics::FrameLength, GameConstants::Physics::MaxStepsPerFrame);
+		SceneSnapshotBuffer scene;
+
+		// The first frame of each snapshot buffer may grow its arrays; everything after must not allocate.
+		scene.Publish(entities);
+		scene.Publish(entities);
+
+		uint64_t allocationsBefore = s_allocationCount.load();
+		uint32_t drawn = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			TickInput input = ScriptedPlayerInput(simulation);
+			int steps = stepper.Accumulate(FrameTime);
+			for (int step = 0; step < steps; step++)
+			{
+				simulation.Tick(input);
+			}
+			float alpha = stepper.Alpha();
+			entities.RenderPosition(entities.Index(simulation.PlayerEntity()), simulation.PlayerRenderPosition(alpha));
+			entities.RenderPosition(entities.Index(simulation.EnemyEntity()), simulation.EnemyRenderPosition(alpha));
+			UpdateTransforms(entities);
+			scene.Publish(entities);
+
+			// Stand-in for the renderer: walk the snapshot in place.
+			const SceneSnapshot& latest = scene.Latest();
+			for (auto handle = latest.RenderHandles().begin(); handle != latest.RenderHandles().end(); handle++)
+			{
+				drawn += (handle->mesh != NoRenderResource) ? 1 : 0;
+			}
+		}
+		double seconds = SecondsSince(start);
+		uint64_t allocations = s_allocationCount.load() - allocationsBefore;
+
+		printf("frames:           %d\n", frames);
+		printf("objects drawn:    %u\n", drawn);
+		printf("allocations:      %llu (%.3f per frame)\n",
+			static_cast<unsigned long long>(allocations), static_cast<double>(allocations) / frames);
+		printf("frames/second:    %.0f\n", frames / seconds);
+		return (allocations == 0) ? 0 : 3;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 2 && strcmp(argv[1], "record") == 0)
+	{
+		return Record(argv[2], (argc > 3) ? strtoull(argv[3], nullptr, 10) : 1);
+	}
+	if (argc > 2 && strcmp(argv[1], "play") == 0)
+	{
+		return Play(argv[2], (argc > 3) ? atoi(argv[3]) : 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "frames") == 0)
+	{
+		return Frames((argc > 2) ? atoi(argv[2]) : 10000);
+	}
+
+	int rounds = (argc > 1) ? atoi(argv[1]) : 1000;
+	if (rounds <= 0)
+	{
+		fprintf(stderr, "Usage: SumoHeadless [rounds [seed]] | record <file> [seed] | play <file> [repeat] | frames [count]\n");
+		return 1;
+	}
+	return RunRounds(rounds, (argc > 2) ? strtoull(argv[2], nullptr, 10) : 1);
+}
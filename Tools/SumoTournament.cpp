@@ -0,0 +1,328 @@
+// SumoTournament:
+// Plays round-robin tournaments of headless sumo matches on every core to tune
+// the AI.  Each entrant is an AI behavior with a set of maneuver timings, and
+// the scripted player from SumoHeadless (walk straight at the enemy) takes part
+// as well.  Every entrant plays every other entrant from both sides of the mat;
+// an AI on the player's side is driven through the player's input by the same
+// DetermineAIAction rule the enemy uses.  The Smart entrant marked "planned"
+// chooses its maneuvers with the SmartPlanner, stopped by an iteration limit so
+// the results stay repeatable.  A match ends on a ring-out or after the time
+// limit.
+//
+// Each match is seeded from the tournament seed and its index, so the results
+// are the same for any number of threads.
+//
+// Usage:
+//     SumoTournament [matches [threads [seed]]]
+//         matches     Matches per pairing (default 1000).
+//         threads     Worker threads (default: one per core).
+//         seed        Tournament seed (default 1).
+
+#include "Simulation/SumoSimulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Simulation;
+
+namespace
+{
+	const float    PlayerSpeed     = 2.0f;             // Matches MOVEMENT_GAIN in MoveLookController.
+	const float    MatchTimeLimit  = 120.0f;
+	const uint32_t MatchTickLimit  = static_cast<uint32_t>(MatchTimeLimit / GameConstants::Physics::FrameLength);
+	const uint32_t PlanIterations  = 256;
+
+	struct Entrant
+	{
+		std::string             name;
+		bool                    scripted;
+		bool                    planned;
+		GameConstants::Behavior behavior;
+		AITimings               timings;
+	};
+
+	struct Pairing
+	{
+		uint32_t player;
+		uint32_t enemy;
+	};
+
+	struct PairingResult
+	{
+		uint64_t playerWins;
+		uint64_t enemyWins;
+		uint64_t timeouts;
+		uint64_t ringOutTicks;   // Summed over the matches that ended in a ring-out.
+	};
+
+	std::vector<Entrant> Entrants()
+	{
+		AITimings standard = DefaultAITimings();
+
+		AITimings quick = standard;
+		quick.initialDelay = 1.0f;
+		quick.minimumDelay = 0.5f;
+		quick.delayStep = 0.5f;
+
+		AITimings patient = standard;
+		patient.initialDelay = 3.0f;
+		patient.minimumDelay = 2.0f;
+
+		const char* behaviorNames[] = { "Easy", "Angry", "Smart" };
+		const char* timingNames[] = { "", "/quick", "/patient" };
+		const AITimings timings[] = { standard, quick, patient };
+
+		std::vector<Entrant> entrants;
+		Entrant scripted = { "Scripted", true, false, GameConstants::Easy, standard };
+		entrants.push_back(scripted);
+		for (int behavior = 0; behavior < 3; behavior++)
+		{
+			for (int timing = 0; timing < 3; timing++)
+			{
+				std::string name = std::string(behaviorNames[behavior]) + timingNames[timing];
+				Entrant entrant = { name, false, false, static_cast<GameConstants::Behavior>(behavior), timings[timing] };
+				entrants.push_back(entrant);
+			}
+		}
+		Entrant planned = { "Smart/planned", false, true, GameConstants::Smart, standard };
+		entrants.push_back(planned);
+		return entrants;
+	}
+
+	uint64_t MatchSeed(uint64_t seed, uint64_t match)
+	{
+		// SplitMix64, so neighboring matches get unrelated seeds.
+		uint64_t z = seed + (match + 1) * 0x9E3779B97F4A7C15ULL;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	PlannerSettings PlanSettings()
+	{
+		PlannerSettings settings = DefaultPlannerSettings();
+		settings.budgetMicroseconds = 0;
+		settings.iterationLimit = PlanIterations;
+		return settings;
+	}
+
+	// Drives the player's side with the AI rules by turning the AI's move for the
+	// tick into the player's velocity.
+	class AIPlayer
+	{
+	public:
+		AIPlayer(const Entrant& entrant, uint64_t seed) :
+			m_timings(entrant.timings),
+			m_planned(entrant.planned),
+			m_random(seed)
+		{
+			m_ai.behavior = entrant.behavior;
+			m_ai.choice = GameConstants::Walk;
+			m_ai.delay = m_timings.initialDelay;
+		}
+
+		TickInput Input(const SumoSimulation& simulation)
+		{
+			const float deltaTime = GameConstants::Physics::FrameLength;
+			Float3 start = simulation.PlayerPosition();
+			Float3 position = start;
+			if (m_planned)
+			{
+				Plan(simulation, position, deltaTime);
+			}
+			else
+			{
+				RandomStream random(m_random, simulation.PlayerEntity().slot, simulation.TickCount());
+				DetermineAIAction(position, simulation.EnemyPosition(), m_ai, random, deltaTime, m_timings);
+			}
+
+			TickInput input;
+			input.playerVelocity = (position - start) * (1.0f / deltaTime);
+			return input;
+		}
+
+	private:
+		// SumoSimulation::PlanEnemyAction from the player's side.  The enemy's speed is
+		// taken from how far it moved on the last tick.
+		void Plan(const SumoSimulation& simulation, Float3& position, float deltaTime)
+		{
+			m_ai.delay -= deltaTime;
+			if (m_ai.delay <= 0)
+			{
+				Float3 enemy = simulation.EnemyPosition();
+				float enemySpeed = Length(enemy - simulation.EnemyRenderPosition(0.0f)) / deltaTime;
+				DuelState duel = { position, enemy, enemySpeed, m_ai.behavior, GameConstants::Arena::RingRadius };
+				PlannerDecision decision = m_planner.Plan(duel, m_timings, m_random.Seed() + simulation.PlayerEntity().slot,
+					simulation.TickCount(), PlanSettings());
+				m_ai.choice = decision.choice;
+				m_ai.delay = decision.delay;
+			}
+			ApplyManeuver(position, simulation.EnemyPosition(), m_ai.behavior, m_ai.choice, deltaTime);
+		}
+
+		AITimings     m_timings;
+		bool          m_planned;
+		AIState       m_ai;
+		CounterRandom m_random;
+		SmartPlanner  m_planner;
+	};
+
+	TickInput ScriptedPlayerInput(const SumoSimulation& simulation)
+	{
+		Float3 toEnemy = simulation.EnemyPosition() - simulation.PlayerPosition();
+		toEnemy.y = 0.0f;
+
+		TickInput input;
+		input.playerVelocity = Normalize(toEnemy) * PlayerSpeed;
+		return input;
+	}
+
+	void PlayMatch(SumoSimulation& simulation, const Entrant& player, const Entrant& enemy, uint64_t seed, PairingResult& result)
+	{
+		simulation.EnemyTimings(enemy.timings);
+		simulation.SmartPlanning(enemy.planned, PlanSettings());
+		simulation.Reset(enemy.behavior, seed);
+		AIPlayer aiPlayer(player, seed ^ 0x5A5A5A5A5A5A5A5AULL);
+
+		RoundResult outcome = RoundResult::InProgress;
+		while (outcome == RoundResult::InProgress && simulation.TickCount() < MatchTickLimit)
+		{
+			simulation.Tick(player.scripted ? ScriptedPlayerInput(simulation) : aiPlayer.Input(simulation));
+			outcome = simulation.CheckRingOut();
+		}
+
+		switch (outcome)
+		{
+		case RoundResult::EnemyRingOut:  result.playerWins++; break;
+		case RoundResult::PlayerRingOut: result.enemyWins++;  break;
+		default:                         result.timeouts++;   break;
+		}
+		if (outcome != RoundResult::InProgress)
+		{
+			result.ringOutTicks += simulation.TickCount();
+		}
+	}
+
+	double Percent(uint64_t count, uint64_t total)
+	{
+		return (total > 0) ? 100.0 * count / total : 0.0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int matches = (argc > 1) ? atoi(argv[1]) : 1000;
+	int threadCount = (argc > 2) ? atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+	uint64_t seed = (argc > 3) ? strtoull(argv[3], nullptr, 10) : 1;
+	if (matches <= 0)
+	{
+		fprintf(stderr, "Usage: SumoTournament [matches [threads [seed]]]\n");
+		return 1;
+	}
+	threadCount = std::max(threadCount, 1);
+
+	std::vector<Entrant> entrants = Entrants();
+
+	// The scripted player can only play from the player's side.
+	std::vector<Pairing> pairings;
+	for (uint32_t player = 0; player < entrants.size(); player++)
+	{
+		for (uint32_t enemy = 0; enemy < entrants.size(); enemy++)
+		{
+			if (player != enemy && !entrants[enemy].scripted)
+			{
+				Pairing pairing = { player, enemy };
+				pairings.push_back(pairing);
+			}
+		}
+	}
+
+	uint64_t totalMatches = static_cast<uint64_t>(pairings.size()) * matches;
+	std::vector<std::vector<PairingResult>> threadResults(threadCount, std::vector<PairingResult>(pairings.size(), PairingResult()));
+	std::atomic<uint64_t> nextMatch(0);
+
+	// Threads take matches in blocks from a shared counter; each match's seed depends
+	// only on its index, so the totals don't depend on which thread played it.
+	const uint64_t Block = 64;
+	auto worker = [&](int thread)
+	{
+		SumoSimulation simulation;
+		std::vector<PairingResult>& results = threadResults[thread];
+		for (;;)
+		{
+			uint64_t first = nextMatch.fetch_add(Block);
+			if (first >= totalMatches)
+			{
+				break;
+			}
+			uint64_t last = std::min(first + Block, totalMatches);
+			for (uint64_t match = first; match < last; match++)
+			{
+				uint32_t pairing = static_cast<uint32_t>(match / matches);
+				PlayMatch(simulation, entrants[pairings[pairing].player], entrants[pairings[pairing].enemy],
+					MatchSeed(seed, match), results[pairing]);
+			}
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (int thread = 1; thread < threadCount; thread++)
+	{
+		threads.push_back(std::thread(worker, thread));
+	}
+	worker(0);
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Integer sums, so the totals are the same whatever the thread count.
+	std::vector<PairingResult> results(pairings.size(), PairingResult());
+	for (const std::vector<PairingResult>& threadResult : threadResults)
+	{
+		for (size_t pairing = 0; pairing < pairings.size(); pairing++)
+		{
+			results[pairing].playerWins += threadResult[pairing].playerWins;
+			results[pairing].enemyWins += threadResult[pairing].enemyWins;
+			results[pairing].timeouts += threadResult[pairing].timeouts;
+			results[pairing].ringOutTicks += threadResult[pairing].ringOutTicks;
+		}
+	}
+
+	printf("%-16s %-16s %8s %8s %8s %12s\n", "player", "enemy", "player%", "enemy%", "timeout%", "ring-out s");
+	std::vector<uint64_t> wins(entrants.size(), 0);
+	std::vector<uint64_t> played(entrants.size(), 0);
+	for (size_t pairing = 0; pairing < pairings.size(); pairing++)
+	{
+		const PairingResult& result = results[pairing];
+		uint64_t ringOuts = result.playerWins + result.enemyWins;
+		printf("%-16s %-16s %8.1f %8.1f %8.1f %12.2f\n",
+			entrants[pairings[pairing].player].name.c_str(), entrants[pairings[pairing].enemy].name.c_str(),
+			Percent(result.playerWins, matches), Percent(result.enemyWins, matches), Percent(result.timeouts, matches),
+			(ringOuts > 0) ? result.ringOutTicks * GameConstants::Physics::FrameLength / ringOuts : 0.0);
+
+		wins[pairings[pairing].player] += result.playerWins;
+		wins[pairings[pairing].enemy] += result.enemyWins;
+		played[pairings[pairing].player] += matches;
+		played[pairings[pairing].enemy] += matches;
+	}
+
+	printf("\n%-16s %8s\n", "entrant", "win%");
+	for (size_t entrant = 0; entrant < entrants.size(); entrant++)
+	{
+		printf("%-16s %8.1f\n", entrants[entrant].name.c_str(), Percent(wins[entrant], played[entrant]));
+	}
+
+	printf("\nmatches:          %llu\n", static_cast<unsigned long long>(totalMatches));
+	printf("threads:          %d\n", threadCount);
+	printf("matches/second:   %.0f\n", totalMatches / seconds);
+	return 0;
+}